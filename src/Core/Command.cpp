@@ -2,6 +2,11 @@
 
 #include "GeometryKernel/GeometryKernel.h"
 
+#include <QByteArray>
+#include <QtGlobal>
+
+#include <typeinfo>
+
 namespace Core {
 
 Command::Command(const QString& text)
@@ -16,7 +21,7 @@ void Command::setContext(const CommandContext& ctx)
 
 void Command::redo()
 {
-    if (!geometry())
+    if (!geometry() || !makeResident())
         return;
     if (!initialized) {
         beforeSelection = currentSelection();
@@ -37,6 +42,8 @@ void Command::redo()
 
 void Command::undo()
 {
+    if (!makeResident())
+        return;
     performUndo();
     applySelection(beforeSelection);
     if (context.selectionChanged)
@@ -44,10 +51,128 @@ void Command::undo()
     notifyGeometryChanged();
 }
 
+int Command::id() const
+{
+    // QUndoStack only offers a merge when ids match; mergeWith() does the
+    // real check, so every mergeable command shares one id.
+    return mergeKeyValue != 0 ? 0x4643 : -1;
+}
+
+bool Command::mergeWith(const QUndoCommand* other)
+{
+    const auto* next = dynamic_cast<const Command*>(other);
+    if (!next || next->mergeKeyValue != mergeKeyValue || typeid(*next) != typeid(*this))
+        return false;
+    if (!makeResident() || !mergeCommand(*next))
+        return false;
+    afterSelection = next->afterSelection;
+    if (next->mergedFlag)
+        *next->mergedFlag = true;
+    return true;
+}
+
 void Command::initialize()
 {
 }
 
+bool Command::mergeCommand(const Command&)
+{
+    return false;
+}
+
+bool Command::packState(std::string&)
+{
+    return false;
+}
+
+bool Command::unpackState(const std::string&)
+{
+    return false;
+}
+
+bool Command::pack()
+{
+    if (storageState != Storage::Resident)
+        return true;
+    // Nothing is captured until the first redo.
+    if (!initialized)
+        return false;
+    std::string raw;
+    if (!packState(raw))
+        return false;
+    const QByteArray deflated = qCompress(reinterpret_cast<const uchar*>(raw.data()), static_cast<qsizetype>(raw.size()));
+    packedDeflated = !deflated.isEmpty() && static_cast<std::size_t>(deflated.size()) < raw.size();
+    if (packedDeflated)
+        packedState.assign(deflated.constData(), static_cast<std::size_t>(deflated.size()));
+    else
+        packedState = std::move(raw);
+    storageState = Storage::Packed;
+    return true;
+}
+
+bool Command::spill(const std::shared_ptr<UndoSpillFile>& file)
+{
+    if (!file || storageState == Storage::Spilled)
+        return storageState == Storage::Spilled;
+    if (!pack())
+        return false;
+    UndoSpillFile::Range range;
+    if (!file->write(packedState, range))
+        return false;
+    spillFile = file;
+    spillRange = range;
+    std::string().swap(packedState);
+    storageState = Storage::Spilled;
+    return true;
+}
+
+bool Command::makeResident()
+{
+    if (storageState == Storage::Resident)
+        return true;
+    // The stored bytes are only released once the state has been rebuilt, so
+    // a failure leaves the entry packed or spilled as it was.
+    std::string stored;
+    if (storageState == Storage::Spilled) {
+        if (!spillFile || !spillFile->read(spillRange, stored))
+            return restoreFailed("Undo history could not be read back from its spill file");
+    } else {
+        stored = std::move(packedState);
+    }
+    auto keepStored = [this, &stored]() {
+        if (storageState == Storage::Packed)
+            packedState = std::move(stored);
+    };
+
+    std::string inflatedState;
+    if (packedDeflated) {
+        const QByteArray inflated = qUncompress(reinterpret_cast<const uchar*>(stored.data()),
+                                                static_cast<qsizetype>(stored.size()));
+        if (inflated.isEmpty()) {
+            keepStored();
+            return restoreFailed("Undo history entry could not be decompressed");
+        }
+        inflatedState.assign(inflated.constData(), static_cast<std::size_t>(inflated.size()));
+    }
+    if (!unpackState(packedDeflated ? inflatedState : stored)) {
+        keepStored();
+        return restoreFailed("Undo history entry could not be restored");
+    }
+
+    spillFile.reset();
+    packedDeflated = false;
+    storageState = Storage::Resident;
+    return true;
+}
+
+bool Command::restoreFailed(const char* message)
+{
+    qWarning("%s", message);
+    if (context.historyInvalidated)
+        context.historyInvalidated();
+    return false;
+}
+
 void Command::setFinalSelection(const std::vector<Scene::Document::ObjectId>& ids)
 {
     afterSelection = ids;
@@ -65,34 +190,22 @@ void Command::overrideInitialSelection(const std::vector<Scene::Document::Object
 
 std::vector<Scene::Document::ObjectId> Command::currentSelection() const
 {
-    std::vector<Scene::Document::ObjectId> result;
     if (!geometry() || !document())
-        return result;
-
-    for (const auto& object : geometry()->getObjects()) {
-        if (!object->isSelected())
-            continue;
-        Scene::Document::ObjectId id = document()->objectIdForGeometry(object.get());
-        if (id != 0)
-            result.push_back(id);
-    }
-    return result;
+        return {};
+    return document()->selection().ids();
 }
 
 void Command::applySelection(const std::vector<Scene::Document::ObjectId>& ids) const
 {
     if (!geometry() || !document())
         return;
+    document()->setSelection(ids);
+}
 
-    for (const auto& object : geometry()->getObjects()) {
-        object->setSelected(false);
-    }
-
-    for (Scene::Document::ObjectId id : ids) {
-        if (GeometryObject* object = document()->geometryForObject(id)) {
-            object->setSelected(true);
-        }
-    }
+std::size_t Command::memoryFootprint() const
+{
+    return sizeof(Command) + packedState.capacity()
+        + (beforeSelection.capacity() + afterSelection.capacity()) * sizeof(Scene::Document::ObjectId);
 }
 
 void Command::notifyGeometryChanged() const
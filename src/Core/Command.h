@@ -1,10 +1,15 @@
 #pragma once
 
 #include "../Scene/Document.h"
+#include "UndoSpillFile.h"
 
 #include <QUndoCommand>
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 
 class GeometryKernel;
@@ -16,19 +21,59 @@ struct CommandContext {
     GeometryKernel* geometry = nullptr;
     std::function<void()> geometryChanged;
     std::function<void(const std::vector<Scene::Document::ObjectId>&)> selectionChanged;
+    // Called when a command cannot restore state it packed or spilled. The
+    // undo stack has already moved past it, so the history no longer matches
+    // the document and must be discarded.
+    std::function<void()> historyInvalidated;
 };
 
 class Command : public QUndoCommand {
 public:
+    // Commands pushed straight after one another with the same non-zero merge
+    // key are coalesced into one undo entry, as long as mergeCommand() accepts
+    // the pair. Zero never merges. A key should only be shared by the steps of
+    // one continuous gesture; edits the user commits separately push with
+    // zero so that each can be undone on its own.
+    using MergeKey = std::uint64_t;
+
     explicit Command(const QString& text = QString());
 
     void setContext(const CommandContext& context);
 
     void redo() override final;
     void undo() override final;
+    int id() const override final;
+    bool mergeWith(const QUndoCommand* other) override final;
+
+    void setMergeKey(MergeKey key) { mergeKeyValue = key; }
+    MergeKey mergeKey() const { return mergeKeyValue; }
+
+    // Approximate bytes this history entry keeps alive. Geometry shared with
+    // the scene or other entries is only counted in part.
+    virtual std::size_t memoryFootprint() const;
+
+    // Where the state captured for undo currently lives. Packed state is held
+    // in memory, deflated when that makes it smaller; spilled state has been
+    // written to a spill file. Either way it is made resident again before the
+    // command next runs.
+    enum class Storage { Resident, Packed, Spilled };
+
+    Storage storage() const { return storageState; }
+    bool pack();
+    bool spill(const std::shared_ptr<UndoSpillFile>& file);
+    bool makeResident();
 
 protected:
     virtual void initialize();
+    // Serialise the bulky part of the captured state into out and release it,
+    // returning false if there is nothing worth packing. unpackState() gets the
+    // same bytes back and rebuilds it.
+    virtual bool packState(std::string& out);
+    virtual bool unpackState(const std::string& in);
+    // Folds other, a command of the same type that has already been applied,
+    // into this one so that undoing this reverts both. Returns false if the
+    // two cannot be expressed as one command.
+    virtual bool mergeCommand(const Command& other);
     virtual void performRedo() = 0;
     virtual void performUndo() = 0;
 
@@ -46,10 +91,23 @@ protected:
     void notifyGeometryChanged() const;
 
 private:
+    friend class CommandStack;
+
+    bool restoreFailed(const char* message);
+
     CommandContext context;
     std::vector<Scene::Document::ObjectId> beforeSelection;
     std::vector<Scene::Document::ObjectId> afterSelection;
     bool initialized = false;
+    MergeKey mergeKeyValue = 0;
+    Storage storageState = Storage::Resident;
+    std::string packedState;
+    bool packedDeflated = false;
+    std::shared_ptr<UndoSpillFile> spillFile;
+    UndoSpillFile::Range spillRange;
+    // Set by CommandStack::push() while the command is being pushed, so the
+    // stack can tell that it was merged into the previous entry and deleted.
+    bool* mergedFlag = nullptr;
 };
 
 } // namespace Core
@@ -1,22 +1,110 @@
 #include "CommandStack.h"
 
+#include <QPointer>
 #include <QUndoStack>
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace Core {
 
+namespace {
+
+// Transaction keys live in the top half of the key space so they never meet
+// keys chosen by callers.
+constexpr Command::MergeKey kTransactionKeyBase = Command::MergeKey(1) << 63;
+
+// QUndoStack only hands out const commands; the stack owns them but the
+// history budget needs to page their state in and out. Transactions leave a
+// macro whose children are the commands.
+void collectHistoryEntries(const QUndoCommand* entry, std::vector<Command*>& out)
+{
+    if (!entry)
+        return;
+    if (auto* command = dynamic_cast<const Command*>(entry)) {
+        out.push_back(const_cast<Command*>(command));
+        return;
+    }
+    for (int i = 0; i < entry->childCount(); ++i)
+        collectHistoryEntries(entry->child(i), out);
+}
+
+} // namespace
+
+// Shared with the callbacks handed to commands, which can outlive the stack.
+struct CommandStack::Notifications {
+    std::function<void()> geometryChanged;
+    std::function<void(const std::vector<Scene::Document::ObjectId>&)> selectionChanged;
+    std::function<void()> historyInvalidated;
+    QPointer<QUndoStack> undoStack;
+    int depth = 0;
+    bool geometryPending = false;
+    bool selectionPending = false;
+    std::vector<Scene::Document::ObjectId> selection;
+};
+
+CommandStack::CommandStack()
+    : notifications_(std::make_shared<Notifications>())
+{
+}
+
 CommandStack::CommandStack(QUndoStack* stack)
-    : undoStack_(stack)
+    : CommandStack()
 {
+    setUndoStack(stack);
+}
+
+CommandStack::~CommandStack()
+{
+    QObject::disconnect(indexConnection_);
 }
 
 void CommandStack::setUndoStack(QUndoStack* stack)
 {
+    QObject::disconnect(indexConnection_);
     undoStack_ = stack;
+    notifications_->undoStack = stack;
+    spillFile_.reset();
+    if (undoStack_)
+        indexConnection_ = QObject::connect(undoStack_, &QUndoStack::indexChanged, [this](int) {
+            enforceHistoryBudget();
+        });
 }
 
 void CommandStack::setContext(const CommandContext& context)
 {
     context_ = context;
+    notifications_->geometryChanged = context.geometryChanged;
+    notifications_->selectionChanged = context.selectionChanged;
+    notifications_->historyInvalidated = context.historyInvalidated;
+    std::shared_ptr<Notifications> notifications = notifications_;
+    // Commands report from inside QUndoStack::undo() or redo(), so the stack
+    // is cleared once that call has returned.
+    context_.historyInvalidated = [notifications]() {
+        if (QUndoStack* stack = notifications->undoStack)
+            QMetaObject::invokeMethod(stack, [stack]() { stack->clear(); }, Qt::QueuedConnection);
+        if (notifications->historyInvalidated)
+            notifications->historyInvalidated();
+    };
+    if (context.geometryChanged) {
+        context_.geometryChanged = [notifications]() {
+            if (notifications->depth > 0)
+                notifications->geometryPending = true;
+            else
+                notifications->geometryChanged();
+        };
+    }
+    if (context.selectionChanged) {
+        context_.selectionChanged = [notifications](const std::vector<Scene::Document::ObjectId>& ids) {
+            if (notifications->depth > 0) {
+                notifications->selectionPending = true;
+                notifications->selection = ids;
+            } else {
+                notifications->selectionChanged(ids);
+            }
+        };
+    }
 }
 
 Command* CommandStack::push(std::unique_ptr<Command> command)
@@ -24,10 +112,136 @@ Command* CommandStack::push(std::unique_ptr<Command> command)
     if (!undoStack_ || !command)
         return nullptr;
     command->setContext(context_);
+    if (notifications_->depth > 0) {
+        if (command->mergeKey() == 0)
+            command->setMergeKey(transactionKey_);
+        if (!transactionOpen_) {
+            // Opened on the first push so an empty transaction leaves no entry.
+            undoStack_->beginMacro(transactionText_);
+            transactionOpen_ = true;
+        }
+    }
     Command* raw = command.get();
+    bool merged = false;
+    raw->mergedFlag = &merged;
     undoStack_->push(command.release());
+    if (merged)
+        return nullptr;
+    raw->mergedFlag = nullptr;
     return raw;
 }
 
-} // namespace Core
+Command* CommandStack::push(std::unique_ptr<Command> command, Command::MergeKey mergeKey)
+{
+    if (command)
+        command->setMergeKey(mergeKey);
+    return push(std::move(command));
+}
 
+void CommandStack::beginTransaction(const QString& text)
+{
+    if (notifications_->depth++ > 0)
+        return;
+    transactionText_ = text;
+    transactionOpen_ = false;
+    transactionKey_ = kTransactionKeyBase | ++nextTransactionKey_;
+}
+
+void CommandStack::commitTransaction()
+{
+    Notifications& pending = *notifications_;
+    if (pending.depth == 0 || --pending.depth > 0)
+        return;
+    if (transactionOpen_ && undoStack_)
+        undoStack_->endMacro();
+    transactionOpen_ = false;
+    transactionKey_ = 0;
+
+    if (pending.selectionPending) {
+        pending.selectionPending = false;
+        if (pending.selectionChanged)
+            pending.selectionChanged(pending.selection);
+        pending.selection.clear();
+    }
+    if (pending.geometryPending) {
+        pending.geometryPending = false;
+        if (pending.geometryChanged)
+            pending.geometryChanged();
+    }
+}
+
+bool CommandStack::inTransaction() const
+{
+    return notifications_->depth > 0;
+}
+
+void CommandStack::setHistoryBudget(const HistoryBudget& budget)
+{
+    budget_ = budget;
+    enforceHistoryBudget();
+}
+
+std::size_t CommandStack::residentHistoryBytes() const
+{
+    if (!undoStack_)
+        return 0;
+    std::size_t bytes = 0;
+    std::vector<Command*> entries;
+    for (int i = 0; i < undoStack_->count(); ++i) {
+        entries.clear();
+        collectHistoryEntries(undoStack_->command(i), entries);
+        for (const Command* command : entries)
+            bytes += command->memoryFootprint();
+    }
+    return bytes;
+}
+
+void CommandStack::enforceHistoryBudget()
+{
+    if (!undoStack_ || enforcing_)
+        return;
+    enforcing_ = true;
+
+    const int count = undoStack_->count();
+    // The spill file only grows; start a new one once its history is gone.
+    if (count == 0)
+        spillFile_.reset();
+
+    // The entry undo would run next sits just below index(), redo's at it.
+    const int index = undoStack_->index();
+    auto distance = [index](int i) { return i < index ? index - 1 - i : i - index; };
+
+    std::vector<std::pair<int, Command*>> candidates;
+    std::vector<Command*> entries;
+    std::size_t residentBytes = 0;
+    for (int i = 0; i < count; ++i) {
+        entries.clear();
+        collectHistoryEntries(undoStack_->command(i), entries);
+        for (Command* command : entries) {
+            if (distance(i) >= budget_.residentSteps)
+                command->pack();
+            residentBytes += command->memoryFootprint();
+            if (command->storage() == Command::Storage::Packed)
+                candidates.emplace_back(distance(i), command);
+        }
+    }
+
+    if (residentBytes > budget_.maxResidentBytes && !candidates.empty()) {
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const auto& a, const auto& b) { return a.first > b.first; });
+        if (!spillFile_)
+            spillFile_ = std::make_shared<UndoSpillFile>();
+        for (const auto& candidate : candidates) {
+            if (residentBytes <= budget_.maxResidentBytes)
+                break;
+            const std::size_t before = candidate.second->memoryFootprint();
+            if (!candidate.second->spill(spillFile_))
+                break;
+            residentBytes -= std::min(residentBytes, before - std::min(before, candidate.second->memoryFootprint()));
+        }
+    }
+
+    enforcing_ = false;
+}
+
+} // namespace Core
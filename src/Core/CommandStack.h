@@ -1,7 +1,12 @@
 #pragma once
 
 #include "Command.h"
+#include "UndoSpillFile.h"
 
+#include <QMetaObject>
+#include <QString>
+
+#include <cstddef>
 #include <memory>
 
 class QUndoStack;
@@ -10,21 +15,69 @@ namespace Core {
 
 class CommandStack {
 public:
-    CommandStack() = default;
+    // Limits on how much of the history stays in memory. Entries more than
+    // residentSteps away from the current position are packed; once the
+    // history is still over maxResidentBytes, packed entries are written to a
+    // spill file, farthest from the current position first.
+    struct HistoryBudget {
+        int residentSteps = 16;
+        std::size_t maxResidentBytes = std::size_t(512) << 20;
+    };
+
+    CommandStack();
     explicit CommandStack(QUndoStack* stack);
+    ~CommandStack();
+
+    CommandStack(const CommandStack&) = delete;
+    CommandStack& operator=(const CommandStack&) = delete;
 
     void setUndoStack(QUndoStack* stack);
+    // The stack wraps the context's callbacks: notifications are held back
+    // during transactions, and the undo stack is cleared when a command
+    // reports CommandContext::historyInvalidated.
     void setContext(const CommandContext& context);
 
     const CommandContext& context() const { return context_; }
     QUndoStack* undoStack() const { return undoStack_; }
 
+    // Returns the pushed command, or nullptr if it was merged into the
+    // previous entry (which deletes it) or could not be pushed.
     Command* push(std::unique_ptr<Command> command);
+    // Pushes command with the given merge key; see Command::MergeKey.
+    Command* push(std::unique_ptr<Command> command, Command::MergeKey mergeKey);
+
+    // Everything pushed between beginTransaction() and commitTransaction()
+    // becomes a single undo entry named text, and consecutive commands of the
+    // same kind inside it are merged. Geometry and selection notifications
+    // are held back until the outermost commit and then sent once.
+    // Transactions nest; the inner ones only add to the outer.
+    void beginTransaction(const QString& text);
+    void commitTransaction();
+    bool inTransaction() const;
+
+    void setHistoryBudget(const HistoryBudget& budget);
+    const HistoryBudget& historyBudget() const { return budget_; }
+    // Approximate bytes the history keeps in memory, not counting spilled
+    // entries.
+    std::size_t residentHistoryBytes() const;
+    // Packs and spills entries until the history fits the budget. Runs after
+    // every push, undo and redo.
+    void enforceHistoryBudget();
 
 private:
+    struct Notifications;
+
     QUndoStack* undoStack_ = nullptr;
     CommandContext context_;
+    std::shared_ptr<Notifications> notifications_;
+    QString transactionText_;
+    bool transactionOpen_ = false;
+    Command::MergeKey transactionKey_ = 0;
+    Command::MergeKey nextTransactionKey_ = 0;
+    HistoryBudget budget_;
+    std::shared_ptr<UndoSpillFile> spillFile_;
+    QMetaObject::Connection indexConnection_;
+    bool enforcing_ = false;
 };
 
 } // namespace Core
-
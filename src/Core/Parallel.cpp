@@ -0,0 +1,105 @@
+#include "Parallel.h"
+
+#include <atomic>
+#include <memory>
+
+namespace Core {
+
+WorkerPool& WorkerPool::instance()
+{
+    static WorkerPool pool(defaultWorkerCount());
+    return pool;
+}
+
+WorkerPool::WorkerPool(unsigned threadCount)
+{
+    threads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        threads.emplace_back([this]() { run(); });
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads)
+        thread.join();
+}
+
+void WorkerPool::post(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+void WorkerPool::run()
+{
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+namespace detail {
+
+namespace {
+
+struct LoopState {
+    std::atomic<std::size_t> next{ 0 };
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::size_t done = 0;
+};
+
+} // namespace
+
+void parallelForRanges(std::size_t count, unsigned threadCount,
+                       const std::function<void(std::size_t, std::size_t)>& range)
+{
+    WorkerPool& pool = WorkerPool::instance();
+    const std::size_t workers = std::min<std::size_t>({ threadCount, count, pool.size() + 1 });
+    const std::size_t batch = std::max<std::size_t>(1, count / (workers * 8));
+
+    // Helpers may start after the loop is over, for instance when every pool
+    // thread is busy with the caller of a nested loop. They hold the state by
+    // shared pointer and only touch range while a batch is outstanding, which
+    // keeps the caller waiting.
+    auto state = std::make_shared<LoopState>();
+    auto work = [state, count, batch, &range]() {
+        for (;;) {
+            const std::size_t begin = state->next.fetch_add(batch, std::memory_order_relaxed);
+            if (begin >= count)
+                return;
+            const std::size_t end = std::min(count, begin + batch);
+            range(begin, end);
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done += end - begin;
+            if (state->done == count)
+                state->finished.notify_all();
+        }
+    };
+
+    for (std::size_t t = 1; t < workers; ++t)
+        pool.post(work);
+    work();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state, count]() { return state->done == count; });
+}
+
+} // namespace detail
+
+} // namespace Core
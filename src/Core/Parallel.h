@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Core {
+
+// Number of workers used when a caller asks for the default (0) thread count.
+inline unsigned defaultWorkerCount()
+{
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1u : hardware;
+}
+
+// Process-wide set of worker threads, started on first use and kept until
+// exit, so parallel loops do not pay for thread creation on every call.
+class WorkerPool {
+public:
+    static WorkerPool& instance();
+
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(threads.size()); }
+    // Queues task to run on one of the workers. Tasks must not throw.
+    void post(std::function<void()> task);
+
+private:
+    explicit WorkerPool(unsigned threadCount);
+    void run();
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::function<void()>> tasks;
+    std::vector<std::thread> threads;
+    bool stopping = false;
+};
+
+namespace detail {
+
+// Runs range(begin, end) over batches of [0, count) on the calling thread and
+// up to threadCount - 1 pool workers; see parallelFor().
+void parallelForRanges(std::size_t count, unsigned threadCount,
+                       const std::function<void(std::size_t, std::size_t)>& range);
+
+} // namespace detail
+
+// Runs fn(index) for every index in [0, count) across up to threadCount
+// threads (0 picks defaultWorkerCount()), using the WorkerPool. Indices are
+// handed out in small batches from a shared counter so uneven work still
+// balances. The calling thread participates and the call returns once every
+// index has run, so it is safe to call from a pool task. fn must be safe to
+// call concurrently for different indices and must not throw.
+template <typename Fn>
+void parallelFor(std::size_t count, unsigned threadCount, Fn&& fn)
+{
+    if (count == 0)
+        return;
+    if (threadCount == 0)
+        threadCount = defaultWorkerCount();
+    if (std::min<std::size_t>(threadCount, count) <= 1) {
+        for (std::size_t i = 0; i < count; ++i)
+            fn(i);
+        return;
+    }
+    detail::parallelForRanges(count, threadCount, [&fn](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+            fn(i);
+    });
+}
+
+template <typename Fn>
+void parallelFor(std::size_t count, Fn&& fn)
+{
+    parallelFor(count, 0u, std::forward<Fn>(fn));
+}
+
+} // namespace Core
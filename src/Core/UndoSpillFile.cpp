@@ -0,0 +1,38 @@
+#include "UndoSpillFile.h"
+
+#include <QTemporaryFile>
+
+namespace Core {
+
+UndoSpillFile::UndoSpillFile() = default;
+
+UndoSpillFile::~UndoSpillFile() = default;
+
+bool UndoSpillFile::write(const std::string& bytes, Range& range)
+{
+    if (!file) {
+        file = std::make_unique<QTemporaryFile>();
+        opened = file->open();
+    }
+    if (!opened || !file->seek(static_cast<qint64>(end)))
+        return false;
+    const qint64 written = file->write(bytes.data(), static_cast<qint64>(bytes.size()));
+    if (written != static_cast<qint64>(bytes.size()))
+        return false;
+    range.offset = end;
+    range.length = bytes.size();
+    end += bytes.size();
+    return true;
+}
+
+bool UndoSpillFile::read(const Range& range, std::string& bytes) const
+{
+    if (!opened || range.offset + range.length > end)
+        return false;
+    if (!file->seek(static_cast<qint64>(range.offset)))
+        return false;
+    bytes.resize(range.length);
+    return file->read(bytes.data(), static_cast<qint64>(range.length)) == static_cast<qint64>(range.length);
+}
+
+} // namespace Core
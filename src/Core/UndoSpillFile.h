@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class QTemporaryFile;
+
+namespace Core {
+
+// Temporary file that receives history state paged out of memory. Records
+// are appended and never rewritten, so the file only shrinks when the
+// history it serves is discarded and a new file is started.
+class UndoSpillFile {
+public:
+    struct Range {
+        std::uint64_t offset = 0;
+        std::uint64_t length = 0;
+    };
+
+    UndoSpillFile();
+    ~UndoSpillFile();
+
+    UndoSpillFile(const UndoSpillFile&) = delete;
+    UndoSpillFile& operator=(const UndoSpillFile&) = delete;
+
+    bool write(const std::string& bytes, Range& range);
+    bool read(const Range& range, std::string& bytes) const;
+    std::uint64_t size() const { return end; }
+
+private:
+    std::unique_ptr<QTemporaryFile> file;
+    std::uint64_t end = 0;
+    bool opened = false;
+};
+
+} // namespace Core
@@ -0,0 +1,114 @@
+#include "ExportWriter.h"
+
+#include <charconv>
+
+namespace FileIO::Exporters {
+
+void appendNumber(std::string& out, float value)
+{
+    char digits[32];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+void appendNumber(std::string& out, std::uint64_t value)
+{
+    char digits[24];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+ExportWriter::ExportWriter(std::size_t blockSize)
+    : blockSize(blockSize)
+{
+    block.reserve(blockSize);
+}
+
+ExportWriter::~ExportWriter()
+{
+    close();
+}
+
+bool ExportWriter::open(const std::string& path, bool binary)
+{
+    close();
+    block.clear();
+    flushed = 0;
+    auto mode = std::ios::out | std::ios::trunc;
+    if (binary)
+        mode |= std::ios::binary;
+    file.open(path, mode);
+    return file.is_open();
+}
+
+bool ExportWriter::close()
+{
+    if (!file.is_open())
+        return true;
+    flush();
+    file.close();
+    return !file.fail();
+}
+
+ExportWriter& ExportWriter::text(std::string_view value)
+{
+    if (value.size() >= blockSize) {
+        flush();
+        file.write(value.data(), static_cast<std::streamsize>(value.size()));
+        flushed += value.size();
+        return *this;
+    }
+    reserve(value.size());
+    block.append(value.data(), value.size());
+    return *this;
+}
+
+ExportWriter& ExportWriter::put(char value)
+{
+    reserve(1);
+    block.push_back(value);
+    return *this;
+}
+
+ExportWriter& ExportWriter::number(float value)
+{
+    reserve(32);
+    appendNumber(block, value);
+    return *this;
+}
+
+ExportWriter& ExportWriter::number(std::uint64_t value)
+{
+    reserve(24);
+    appendNumber(block, value);
+    return *this;
+}
+
+ExportWriter& ExportWriter::bytes(const void* data, std::size_t size)
+{
+    return text(std::string_view(static_cast<const char*>(data), size));
+}
+
+ExportWriter& ExportWriter::align(std::size_t alignment)
+{
+    while (offset() % alignment != 0)
+        put('\0');
+    return *this;
+}
+
+void ExportWriter::reserve(std::size_t size)
+{
+    if (block.size() + size > blockSize)
+        flush();
+}
+
+void ExportWriter::flush()
+{
+    if (block.empty())
+        return;
+    file.write(block.data(), static_cast<std::streamsize>(block.size()));
+    flushed += block.size();
+    block.clear();
+}
+
+}
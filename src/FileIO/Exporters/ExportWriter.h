@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace FileIO::Exporters {
+
+// Appends the shortest decimal text that reads back as the same float.
+void appendNumber(std::string& out, float value);
+void appendNumber(std::string& out, std::uint64_t value);
+
+// Buffered file output for the exporters. Text and binary data are collected
+// in a fixed-size block and handed to the file whenever the block fills up, so
+// memory use stays flat no matter how much is written.
+class ExportWriter {
+public:
+    explicit ExportWriter(std::size_t blockSize = 1u << 20);
+    ~ExportWriter();
+
+    ExportWriter(const ExportWriter&) = delete;
+    ExportWriter& operator=(const ExportWriter&) = delete;
+
+    bool open(const std::string& path, bool binary = false);
+    // Flushes pending data and closes the file. Returns false if any write
+    // failed since open().
+    bool close();
+    bool good() const { return file.good(); }
+
+    ExportWriter& text(std::string_view value);
+    ExportWriter& put(char value);
+    ExportWriter& number(float value);
+    ExportWriter& number(std::uint64_t value);
+    ExportWriter& bytes(const void* data, std::size_t size);
+    // Pads with zero bytes up to the next multiple of alignment.
+    ExportWriter& align(std::size_t alignment);
+
+    // Total bytes written so far, including data still in the block.
+    std::uint64_t offset() const { return flushed + block.size(); }
+
+private:
+    void reserve(std::size_t size);
+    void flush();
+
+    std::ofstream file;
+    std::string block;
+    std::size_t blockSize;
+    std::uint64_t flushed = 0;
+};
+
+}
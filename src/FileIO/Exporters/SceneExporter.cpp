@@ -2,14 +2,16 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
-#include <sstream>
+#include <memory>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 
-#include <QByteArray>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -18,34 +20,40 @@
 #include <QJsonObject>
 #include <QString>
 
+#include "Core/Parallel.h"
+#include "ExportWriter.h"
 #include "GeometryKernel/GeometryKernel.h"
+#include "GeometryKernel/MeshOptimizer.h"
+#include "GeometryKernel/Serialization.h"
+#include "GeometryKernel/TransformUtils.h"
 #include "Scene/Document.h"
 
 namespace FileIO::Exporters {
 namespace {
 
-struct SceneInstance {
+// One exportable object. Its mesh is built only while the object is being
+// written (see exportInWindows), so meshes never exist for the whole scene.
+struct SceneItem {
     std::string name;
-    GeometryKernel::MeshBuffer mesh;
+    const GeometryObject* geometry = nullptr;
     std::string material;
+    // Object-to-world; the mesh is in object space.
     std::array<float, 16> transform;
-    bool visible = true;
 };
 
-SceneInstance makeInstance(const Scene::Document::ObjectNode& node, const GeometryKernel& kernel, std::size_t indexFallback)
+SceneItem makeItem(const GeometryObject* geometry, const GeometryKernel& kernel, std::string name)
 {
-    SceneInstance instance;
-    instance.name = node.name.empty() ? (std::string("Object_") + std::to_string(indexFallback)) : node.name;
-    instance.material = kernel.getMaterial(node.geometry);
-    instance.mesh = kernel.buildMeshBuffer(*node.geometry);
-    instance.transform = GeometryKernel::identityTransform();
-    instance.visible = node.visible;
-    return instance;
+    SceneItem item;
+    item.name = std::move(name);
+    item.geometry = geometry;
+    item.material = kernel.getMaterial(geometry);
+    item.transform = geometry->placement();
+    return item;
 }
 
 void collectFromNode(const Scene::Document::ObjectNode& node,
                      const GeometryKernel& kernel,
-                     std::vector<SceneInstance>& out,
+                     std::vector<SceneItem>& out,
                      std::unordered_set<const GeometryObject*>& visited,
                      std::size_t& counter,
                      bool ancestorsVisible)
@@ -53,7 +61,9 @@ void collectFromNode(const Scene::Document::ObjectNode& node,
     bool nodeVisible = ancestorsVisible && node.visible;
     if (node.kind == Scene::Document::NodeKind::Geometry && node.geometry && nodeVisible) {
         if (visited.insert(node.geometry).second) {
-            out.push_back(makeInstance(node, kernel, ++counter));
+            ++counter;
+            std::string name = node.name.empty() ? (std::string("Object_") + std::to_string(counter)) : node.name;
+            out.push_back(makeItem(node.geometry, kernel, std::move(name)));
         }
     }
     for (const auto& child : node.children) {
@@ -61,13 +71,13 @@ void collectFromNode(const Scene::Document::ObjectNode& node,
     }
 }
 
-std::vector<SceneInstance> gatherSceneInstances(const Scene::Document& document)
+std::vector<SceneItem> gatherSceneItems(const Scene::Document& document)
 {
-    std::vector<SceneInstance> instances;
+    std::vector<SceneItem> items;
     std::unordered_set<const GeometryObject*> visited;
     std::size_t counter = 0;
     const auto& root = document.objectTree();
-    collectFromNode(root, document.geometry(), instances, visited, counter, true);
+    collectFromNode(root, document.geometry(), items, visited, counter, true);
 
     for (const auto& object : document.geometry().getObjects()) {
         if (!object) {
@@ -79,14 +89,11 @@ std::vector<SceneInstance> gatherSceneInstances(const Scene::Document& document)
         if (object->getType() != ObjectType::Solid) {
             continue;
         }
-        Scene::Document::ObjectNode placeholder;
-        placeholder.geometry = object.get();
-        placeholder.name = std::string("LooseObject_") + std::to_string(++counter);
-        placeholder.visible = true;
-        instances.push_back(makeInstance(placeholder, document.geometry(), counter));
+        ++counter;
+        items.push_back(makeItem(object.get(), document.geometry(), std::string("LooseObject_") + std::to_string(counter)));
     }
 
-    return instances;
+    return items;
 }
 
 bool ensureParentDirectory(const std::filesystem::path& filePath, std::string* error)
@@ -106,15 +113,182 @@ bool ensureParentDirectory(const std::filesystem::path& filePath, std::string* e
     return true;
 }
 
+void appendVector(std::string& out, std::string_view prefix, const Vector3& v)
+{
+    out.append(prefix.data(), prefix.size());
+    appendNumber(out, v.x);
+    out.push_back(' ');
+    appendNumber(out, v.y);
+    out.push_back(' ');
+    appendNumber(out, v.z);
+    out.push_back('\n');
+}
+
+// Mesh and serialised output for one item while its window is in flight.
+struct ExportChunk {
+    GeometryKernel::MeshBuffer mesh;
+    std::string text;
+    // One-based OBJ index of the chunk's first vertex.
+    std::uint64_t firstVertex = 1;
+    // meshShapeHash(), filled in by the glTF writer.
+    std::uint64_t hash = 0;
+    // Cache miss ratios of the index buffer as built and as exported; only
+    // measured when the caller asked for a summary.
+    double acmrBefore = 0.0;
+    double acmrAfter = 0.0;
+
+    bool empty() const { return mesh.indices.empty() || mesh.positions.empty(); }
+};
+
+constexpr std::size_t kExportWindow = 256;
+
+// Walks items in windows of kExportWindow objects. Within a window the mesh
+// buffers are prepared and format(item, chunk) runs on Core::WorkerPool with
+// up to options.threadCount threads, so windows reuse the pool's threads
+// rather than starting their own. emit(item, chunk) then runs on the calling
+// thread in item order and the window is released, so memory stays bounded by
+// one window of meshes. Mesh, triangle and cache statistics go to summary;
+// byte counts are left to the writers.
+template <typename Format, typename Emit>
+void exportInWindows(const std::vector<SceneItem>& items,
+                     const GeometryKernel& kernel,
+                     const ExportOptions& options,
+                     ExportSummary* summary,
+                     Format&& format,
+                     Emit&& emit)
+{
+    std::vector<ExportChunk> chunks;
+    std::uint64_t nextVertex = 1;
+    double missesBefore = 0.0;
+    double missesAfter = 0.0;
+    for (std::size_t begin = 0; begin < items.size(); begin += kExportWindow) {
+        const std::size_t count = std::min(kExportWindow, items.size() - begin);
+        chunks.clear();
+        chunks.resize(count);
+        Core::parallelFor(count, options.threadCount, [&](std::size_t i) {
+            ExportChunk& chunk = chunks[i];
+            chunk.mesh = kernel.buildMeshBuffer(*items[begin + i].geometry);
+            if (summary) {
+                chunk.acmrBefore = MeshOptimizer::averageCacheMissRatio(chunk.mesh.indices, chunk.mesh.positions.size());
+            }
+            if (options.optimizeMeshes && !chunk.mesh.indices.empty()) {
+                GeometryKernel::optimizeMeshBuffer(chunk.mesh);
+                if (summary) {
+                    chunk.acmrAfter = MeshOptimizer::averageCacheMissRatio(chunk.mesh.indices, chunk.mesh.positions.size());
+                }
+            } else {
+                chunk.acmrAfter = chunk.acmrBefore;
+            }
+        });
+        for (auto& chunk : chunks) {
+            chunk.firstVertex = nextVertex;
+            if (!chunk.empty()) {
+                nextVertex += chunk.mesh.positions.size();
+            }
+        }
+        Core::parallelFor(count, options.threadCount, [&](std::size_t i) {
+            format(items[begin + i], chunks[i]);
+        });
+        for (std::size_t i = 0; i < count; ++i) {
+            const ExportChunk& chunk = chunks[i];
+            if (summary && !chunk.empty()) {
+                const std::size_t triangles = chunk.mesh.indices.size() / 3;
+                summary->meshes += 1;
+                summary->triangles += triangles;
+                missesBefore += chunk.acmrBefore * static_cast<double>(triangles);
+                missesAfter += chunk.acmrAfter * static_cast<double>(triangles);
+            }
+            emit(items[begin + i], chunk);
+        }
+    }
+    if (summary && summary->triangles > 0) {
+        summary->acmrBefore = missesBefore / static_cast<double>(summary->triangles);
+        summary->acmrAfter = missesAfter / static_cast<double>(summary->triangles);
+    }
+}
+
+// OBJ and STL have no object transforms, so their vertices are written in
+// world space. The glTF writer puts the transform on the node instead.
+void placeChunk(const SceneItem& item, ExportChunk& chunk)
+{
+    if (GeometryTransforms::isIdentity(item.transform)) {
+        return;
+    }
+    for (auto& p : chunk.mesh.positions) {
+        p = GeometryTransforms::transformPoint(item.transform, p);
+    }
+    const auto normals = GeometryTransforms::normalMatrix(item.transform);
+    for (auto& n : chunk.mesh.normals) {
+        n = GeometryTransforms::transformDirection(normals, n).normalized();
+    }
+}
+
+void formatObjChunk(const SceneItem& item, ExportChunk& chunk)
+{
+    if (chunk.empty()) {
+        return;
+    }
+    placeChunk(item, chunk);
+    const auto& mesh = chunk.mesh;
+    std::string& out = chunk.text;
+    out.reserve(64 + (mesh.positions.size() + mesh.normals.size()) * 40 + mesh.indices.size() * 16);
+    out.append("o ").append(item.name).push_back('\n');
+    if (!item.material.empty()) {
+        out.append("usemtl ").append(item.material).push_back('\n');
+    }
+    for (const auto& v : mesh.positions) {
+        appendVector(out, "v ", v);
+    }
+    for (const auto& n : mesh.normals) {
+        appendVector(out, "vn ", n);
+    }
+    const auto& indices = mesh.indices;
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+        out.push_back('f');
+        for (std::size_t corner = 0; corner < 3; ++corner) {
+            const std::uint64_t index = indices[i + corner] + chunk.firstVertex;
+            out.push_back(' ');
+            appendNumber(out, index);
+            out.append("//");
+            appendNumber(out, index);
+        }
+        out.push_back('\n');
+    }
+}
+
+void formatStlChunk(const SceneItem& item, ExportChunk& chunk)
+{
+    placeChunk(item, chunk);
+    const auto& mesh = chunk.mesh;
+    std::string& out = chunk.text;
+    out.reserve(mesh.indices.size() / 3 * 256);
+    for (std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        const auto& a = mesh.positions[mesh.indices[i]];
+        const auto& b = mesh.positions[mesh.indices[i + 1]];
+        const auto& c = mesh.positions[mesh.indices[i + 2]];
+        Vector3 normal = (b - a).cross(c - a).normalized();
+        appendVector(out, "  facet normal ", normal);
+        out.append("    outer loop\n");
+        appendVector(out, "      vertex ", a);
+        appendVector(out, "      vertex ", b);
+        appendVector(out, "      vertex ", c);
+        out.append("    endloop\n");
+        out.append("  endfacet\n");
+    }
+}
+
 bool writeObj(const std::filesystem::path& output,
-              const std::vector<SceneInstance>& instances,
+              const std::vector<SceneItem>& items,
+              const GeometryKernel& kernel,
+              const ExportOptions& options,
+              ExportSummary* summary,
               std::string* error)
 {
     if (!ensureParentDirectory(output, error)) {
         return false;
     }
-    std::ofstream obj(output, std::ios::out | std::ios::trunc);
-    if (!obj) {
+    ExportWriter obj;
+    if (!obj.open(output.string())) {
         if (error) {
             *error = "Unable to open OBJ file for writing";
         }
@@ -122,9 +296,9 @@ bool writeObj(const std::filesystem::path& output,
     }
 
     std::unordered_set<std::string> materialNames;
-    for (const auto& instance : instances) {
-        if (!instance.material.empty()) {
-            materialNames.insert(instance.material);
+    for (const auto& item : items) {
+        if (!item.material.empty()) {
+            materialNames.insert(item.material);
         }
     }
 
@@ -132,35 +306,21 @@ bool writeObj(const std::filesystem::path& output,
     mtlPath.replace_extension(".mtl");
 
     if (!materialNames.empty()) {
-        obj << "mtllib " << mtlPath.filename().string() << "\n";
+        obj.text("mtllib ").text(mtlPath.filename().string()).put('\n');
     }
 
-    std::size_t vertexOffset = 1;
-    std::vector<Vector3> normals;
-    for (const auto& instance : instances) {
-        if (instance.mesh.indices.empty() || instance.mesh.positions.empty()) {
-            continue;
-        }
-        obj << "o " << instance.name << "\n";
-        if (!instance.material.empty()) {
-            obj << "usemtl " << instance.material << "\n";
-        }
-        for (const auto& v : instance.mesh.positions) {
-            obj << "v " << v.x << ' ' << v.y << ' ' << v.z << "\n";
-        }
-        for (const auto& n : instance.mesh.normals) {
-            obj << "vn " << n.x << ' ' << n.y << ' ' << n.z << "\n";
-        }
-        const auto& indices = instance.mesh.indices;
-        for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
-            const auto i0 = indices[i] + vertexOffset;
-            const auto i1 = indices[i + 1] + vertexOffset;
-            const auto i2 = indices[i + 2] + vertexOffset;
-            obj << "f " << i0 << "//" << i0 << ' '
-                << i1 << "//" << i1 << ' '
-                << i2 << "//" << i2 << "\n";
+    exportInWindows(items, kernel, options, summary, formatObjChunk,
+                    [&](const SceneItem&, const ExportChunk& chunk) { obj.text(chunk.text); });
+    if (summary) {
+        summary->geometryBytes = obj.offset();
+        summary->fullPrecisionBytes = obj.offset();
+    }
+
+    if (!obj.close()) {
+        if (error) {
+            *error = "Failed to write OBJ file";
         }
-        vertexOffset += instance.mesh.positions.size();
+        return false;
     }
 
     if (!materialNames.empty()) {
@@ -183,53 +343,53 @@ bool writeObj(const std::filesystem::path& output,
 }
 
 bool writeStl(const std::filesystem::path& output,
-              const std::vector<SceneInstance>& instances,
+              const std::vector<SceneItem>& items,
+              const GeometryKernel& kernel,
+              const ExportOptions& options,
+              ExportSummary* summary,
               std::string* error)
 {
     if (!ensureParentDirectory(output, error)) {
         return false;
     }
-    std::ofstream stl(output, std::ios::out | std::ios::trunc);
-    if (!stl) {
+    ExportWriter stl;
+    if (!stl.open(output.string())) {
         if (error) {
             *error = "Unable to open STL file for writing";
         }
         return false;
     }
-    stl << "solid FreeCrafter\n";
+    stl.text("solid FreeCrafter\n");
     QJsonArray metadata;
     std::size_t autoNameCounter = 0;
-    for (const auto& instance : instances) {
-        const auto& mesh = instance.mesh;
-        for (std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
-            const auto& a = mesh.positions[mesh.indices[i]];
-            const auto& b = mesh.positions[mesh.indices[i + 1]];
-            const auto& c = mesh.positions[mesh.indices[i + 2]];
-            Vector3 normal = (b - a).cross(c - a).normalized();
-            stl << "  facet normal " << normal.x << ' ' << normal.y << ' ' << normal.z << "\n";
-            stl << "    outer loop\n";
-            stl << "      vertex " << a.x << ' ' << a.y << ' ' << a.z << "\n";
-            stl << "      vertex " << b.x << ' ' << b.y << ' ' << b.z << "\n";
-            stl << "      vertex " << c.x << ' ' << c.y << ' ' << c.z << "\n";
-            stl << "    endloop\n";
-            stl << "  endfacet\n";
-        }
+    exportInWindows(items, kernel, options, summary, formatStlChunk, [&](const SceneItem& item, const ExportChunk& chunk) {
+        const auto& mesh = chunk.mesh;
+        stl.text(chunk.text);
         if (!mesh.indices.empty()) {
             QJsonObject entry;
-            std::string safeName = instance.name;
+            std::string safeName = item.name;
             if (safeName.empty()) {
                 safeName = std::string("Instance_") + std::to_string(++autoNameCounter);
             }
             entry.insert("name", QString::fromStdString(safeName));
-            if (!instance.material.empty()) {
-                entry.insert("material", QString::fromStdString(instance.material));
+            if (!item.material.empty()) {
+                entry.insert("material", QString::fromStdString(item.material));
             }
-            entry.insert("triangles", static_cast<int>(mesh.indices.size() / 3));
+            entry.insert("triangles", static_cast<qint64>(mesh.indices.size() / 3));
             metadata.append(entry);
         }
+    });
+    stl.text("endsolid FreeCrafter\n");
+    if (summary) {
+        summary->geometryBytes = stl.offset();
+        summary->fullPrecisionBytes = stl.offset();
+    }
+    if (!stl.close()) {
+        if (error) {
+            *error = "Failed to write STL file";
+        }
+        return false;
     }
-    stl << "endsolid FreeCrafter\n";
-    stl.close();
 
     if (!metadata.isEmpty()) {
         QJsonObject root;
@@ -253,14 +413,6 @@ bool writeStl(const std::filesystem::path& output,
     return true;
 }
 
-void appendAligned(QByteArray& data, const void* bytes, std::size_t length)
-{
-    while (data.size() % 4 != 0) {
-        data.append('\0');
-    }
-    data.append(static_cast<const char*>(bytes), static_cast<int>(length));
-}
-
 QJsonArray toMatrixArray(const std::array<float, 16>& matrix)
 {
     QJsonArray arr;
@@ -270,15 +422,269 @@ QJsonArray toMatrixArray(const std::array<float, 16>& matrix)
     return arr;
 }
 
+std::uint64_t combineHash(std::uint64_t seed, std::uint64_t value)
+{
+    return seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+}
+
+// Hashes a mesh with its positions taken relative to the first vertex, so
+// translated copies of the same geometry (moved component instances, arrays of
+// copies) hash equal and can share one glTF mesh.
+std::uint64_t meshShapeHash(const GeometryKernel::MeshBuffer& mesh, const std::string& material)
+{
+    if (mesh.positions.empty()) {
+        return 0;
+    }
+    const Vector3 origin = mesh.positions.front();
+    std::vector<Vector3> relative;
+    relative.reserve(mesh.positions.size());
+    for (const auto& p : mesh.positions) {
+        relative.push_back(p - origin);
+    }
+    std::uint64_t hash = GeometryIO::chunkHash(reinterpret_cast<const char*>(relative.data()),
+                                               relative.size() * sizeof(Vector3));
+    hash = combineHash(hash, GeometryIO::chunkHash(reinterpret_cast<const char*>(mesh.normals.data()),
+                                                   mesh.normals.size() * sizeof(Vector3)));
+    hash = combineHash(hash, GeometryIO::chunkHash(reinterpret_cast<const char*>(mesh.indices.data()),
+                                                   mesh.indices.size() * sizeof(std::uint32_t)));
+    return combineHash(hash, GeometryIO::chunkHash(material.data(), material.size()));
+}
+
+bool sameVector(const Vector3& a, const Vector3& b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+// True if b is exactly a translated copy of a, with the same topology and
+// normals.
+bool sameShape(const GeometryKernel::MeshBuffer& a, const GeometryKernel::MeshBuffer& b)
+{
+    if (a.positions.size() != b.positions.size() || a.normals.size() != b.normals.size()
+        || a.indices != b.indices || a.positions.empty()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.normals.size(); ++i) {
+        if (!sameVector(a.normals[i], b.normals[i])) {
+            return false;
+        }
+    }
+    const Vector3 originA = a.positions.front();
+    const Vector3 originB = b.positions.front();
+    for (std::size_t i = 0; i < a.positions.size(); ++i) {
+        if (!sameVector(a.positions[i] - originA, b.positions[i] - originB)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Column-major matrix * translation(offset).
+std::array<float, 16> withTranslation(std::array<float, 16> matrix, const Vector3& offset)
+{
+    for (int row = 0; row < 3; ++row) {
+        matrix[12 + row] += matrix[row] * offset.x + matrix[4 + row] * offset.y + matrix[8 + row] * offset.z;
+    }
+    return matrix;
+}
+
+// Column-major matrix * uniform scale.
+std::array<float, 16> withScale(std::array<float, 16> matrix, float scale)
+{
+    for (int i = 0; i < 12; ++i) {
+        matrix[i] *= scale;
+    }
+    return matrix;
+}
+
+// Writes one bufferView's worth of data to the .bin stream and records it.
+// byteStride is only set for interleaved or padded vertex data.
+int appendBufferView(ExportWriter& binary, QJsonArray& bufferViews, const void* data, std::size_t length, int target,
+                     int byteStride = 0)
+{
+    binary.align(4);
+    const std::uint64_t offset = binary.offset();
+    binary.bytes(data, length);
+
+    QJsonObject view;
+    view.insert("buffer", 0);
+    view.insert("byteOffset", static_cast<qint64>(offset));
+    view.insert("byteLength", static_cast<qint64>(length));
+    if (byteStride > 0) {
+        view.insert("byteStride", byteStride);
+    }
+    view.insert("target", target);
+    bufferViews.append(view);
+    return static_cast<int>(bufferViews.size() - 1);
+}
+
+QJsonArray toJsonArray(float x, float y, float z)
+{
+    QJsonArray arr;
+    arr.append(x);
+    arr.append(y);
+    arr.append(z);
+    return arr;
+}
+
+int appendAccessor(QJsonArray& accessors, int bufferView, int componentType, std::size_t count, const char* type,
+                   bool normalized = false)
+{
+    QJsonObject accessor;
+    accessor.insert("bufferView", bufferView);
+    accessor.insert("componentType", componentType);
+    if (normalized) {
+        accessor.insert("normalized", true);
+    }
+    accessor.insert("count", static_cast<qint64>(count));
+    accessor.insert("type", type);
+    accessors.append(accessor);
+    return static_cast<int>(accessors.size() - 1);
+}
+
+// Accessors of one written glTF primitive. Quantised positions decode as
+// origin + scale * value, which the node matrix applies.
+struct GltfPrimitive {
+    int positions = -1;
+    int normals = -1;
+    int indices = -1;
+    Vector3 origin;
+    float scale = 1.0f;
+};
+
+// Positions as unsigned 16-bit integers over the mesh bounds (padded to 8-byte
+// elements, as glTF requires 4-byte aligned vertex elements), normals as
+// normalised signed bytes and indices as 16-bit when the vertex count allows.
+GltfPrimitive appendQuantizedPrimitive(ExportWriter& binary,
+                                       QJsonArray& bufferViews,
+                                       QJsonArray& accessors,
+                                       const GeometryKernel::MeshBuffer& mesh)
+{
+    GltfPrimitive result;
+    Vector3 minPos = mesh.positions.front();
+    Vector3 maxPos = mesh.positions.front();
+    for (const auto& v : mesh.positions) {
+        minPos.x = std::min(minPos.x, v.x);
+        minPos.y = std::min(minPos.y, v.y);
+        minPos.z = std::min(minPos.z, v.z);
+        maxPos.x = std::max(maxPos.x, v.x);
+        maxPos.y = std::max(maxPos.y, v.y);
+        maxPos.z = std::max(maxPos.z, v.z);
+    }
+    const float extent = std::max({ maxPos.x - minPos.x, maxPos.y - minPos.y, maxPos.z - minPos.z });
+    result.origin = minPos;
+    result.scale = extent > 0.0f ? extent / 65535.0f : 1.0f;
+
+    auto quantize = [&](float value, float origin) {
+        const float q = std::round((value - origin) / result.scale);
+        return static_cast<std::uint16_t>(std::clamp(q, 0.0f, 65535.0f));
+    };
+    std::vector<std::uint16_t> positions(mesh.positions.size() * 4, 0);
+    std::uint16_t qmin[3] = { 65535, 65535, 65535 };
+    std::uint16_t qmax[3] = { 0, 0, 0 };
+    for (std::size_t i = 0; i < mesh.positions.size(); ++i) {
+        const Vector3& v = mesh.positions[i];
+        const std::uint16_t q[3] = { quantize(v.x, minPos.x), quantize(v.y, minPos.y), quantize(v.z, minPos.z) };
+        for (int c = 0; c < 3; ++c) {
+            positions[i * 4 + c] = q[c];
+            qmin[c] = std::min(qmin[c], q[c]);
+            qmax[c] = std::max(qmax[c], q[c]);
+        }
+    }
+
+    // buildMeshBuffer already normalises; this guards buffers built elsewhere.
+    std::vector<std::int8_t> normals(mesh.normals.size() * 4, 0);
+    for (std::size_t i = 0; i < mesh.normals.size(); ++i) {
+        const Vector3& n = mesh.normals[i];
+        const float length = n.length();
+        const Vector3 unit = length > 1e-12f ? n / length : Vector3(0.0f, 0.0f, 1.0f);
+        normals[i * 4] = static_cast<std::int8_t>(std::round(unit.x * 127.0f));
+        normals[i * 4 + 1] = static_cast<std::int8_t>(std::round(unit.y * 127.0f));
+        normals[i * 4 + 2] = static_cast<std::int8_t>(std::round(unit.z * 127.0f));
+    }
+
+    int positionView = appendBufferView(binary, bufferViews, positions.data(),
+                                        positions.size() * sizeof(std::uint16_t), 34962, 8);
+    int normalView = appendBufferView(binary, bufferViews, normals.data(), normals.size(), 34962, 4);
+
+    result.positions = appendAccessor(accessors, positionView, 5123, mesh.positions.size(), "VEC3");
+    QJsonObject positionAccessor = accessors[result.positions].toObject();
+    positionAccessor.insert("min", toJsonArray(qmin[0], qmin[1], qmin[2]));
+    positionAccessor.insert("max", toJsonArray(qmax[0], qmax[1], qmax[2]));
+    accessors[result.positions] = positionAccessor;
+    result.normals = appendAccessor(accessors, normalView, 5120, mesh.normals.size(), "VEC3", true);
+
+    if (mesh.positions.size() <= 65535) {
+        std::vector<std::uint16_t> indices(mesh.indices.begin(), mesh.indices.end());
+        int indexView = appendBufferView(binary, bufferViews, indices.data(),
+                                         indices.size() * sizeof(std::uint16_t), 34963);
+        result.indices = appendAccessor(accessors, indexView, 5123, indices.size(), "SCALAR");
+    } else {
+        int indexView = appendBufferView(binary, bufferViews, mesh.indices.data(),
+                                         mesh.indices.size() * sizeof(std::uint32_t), 34963);
+        result.indices = appendAccessor(accessors, indexView, 5125, mesh.indices.size(), "SCALAR");
+    }
+    return result;
+}
+
+GltfPrimitive appendPrimitive(ExportWriter& binary,
+                              QJsonArray& bufferViews,
+                              QJsonArray& accessors,
+                              const GeometryKernel::MeshBuffer& mesh)
+{
+    GltfPrimitive result;
+    int positionView = appendBufferView(binary, bufferViews, mesh.positions.data(),
+                                        mesh.positions.size() * sizeof(Vector3), 34962);
+    int normalView = appendBufferView(binary, bufferViews, mesh.normals.data(),
+                                      mesh.normals.size() * sizeof(Vector3), 34962);
+    int indexView = appendBufferView(binary, bufferViews, mesh.indices.data(),
+                                     mesh.indices.size() * sizeof(std::uint32_t), 34963);
+
+    Vector3 minPos = mesh.positions.front();
+    Vector3 maxPos = mesh.positions.front();
+    for (const auto& v : mesh.positions) {
+        minPos.x = std::min(minPos.x, v.x);
+        minPos.y = std::min(minPos.y, v.y);
+        minPos.z = std::min(minPos.z, v.z);
+        maxPos.x = std::max(maxPos.x, v.x);
+        maxPos.y = std::max(maxPos.y, v.y);
+        maxPos.z = std::max(maxPos.z, v.z);
+    }
+
+    result.positions = appendAccessor(accessors, positionView, 5126, mesh.positions.size(), "VEC3");
+    QJsonObject positionAccessor = accessors[result.positions].toObject();
+    positionAccessor.insert("min", toJsonArray(minPos.x, minPos.y, minPos.z));
+    positionAccessor.insert("max", toJsonArray(maxPos.x, maxPos.y, maxPos.z));
+    accessors[result.positions] = positionAccessor;
+    result.normals = appendAccessor(accessors, normalView, 5126, mesh.normals.size(), "VEC3");
+    result.indices = appendAccessor(accessors, indexView, 5125, mesh.indices.size(), "SCALAR");
+    return result;
+}
+
 bool writeGltf(const std::filesystem::path& output,
-               const std::vector<SceneInstance>& instances,
+               const std::vector<SceneItem>& items,
+               const GeometryKernel& kernel,
+               const ExportOptions& options,
+               ExportSummary* summary,
                std::string* error)
 {
+    static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 is written to glTF buffers as packed floats");
+
     if (!ensureParentDirectory(output, error)) {
         return false;
     }
 
-    QByteArray binary;
+    // Vertex data goes straight to the .bin file as each object is built; only
+    // the JSON description is kept until the end.
+    QFileInfo outputInfo(QString::fromStdString(output.string()));
+    const QString binName = outputInfo.completeBaseName() + ".bin";
+    ExportWriter binary;
+    if (!binary.open(outputInfo.dir().filePath(binName).toStdString(), true)) {
+        if (error) {
+            *error = "Failed to write glTF buffer";
+        }
+        return false;
+    }
+
     QJsonArray bufferViews;
     QJsonArray accessors;
     QJsonArray meshes;
@@ -286,163 +692,120 @@ bool writeGltf(const std::filesystem::path& output,
     QJsonArray materialsJson;
     QJsonArray sceneNodes;
     std::unordered_map<std::string, int> materialLookup;
-
-    int materialCounter = 0;
-    for (const auto& instance : instances) {
-        if (instance.mesh.indices.empty()) {
-            continue;
-        }
-        if (!instance.material.empty() && !materialLookup.count(instance.material)) {
-            QJsonObject mat;
-            mat.insert("name", QString::fromStdString(instance.material));
-            QJsonObject pbr;
-            QJsonArray baseColor;
-            baseColor.append(0.8);
-            baseColor.append(0.8);
-            baseColor.append(0.8);
-            baseColor.append(1.0);
-            pbr.insert("baseColorFactor", baseColor);
-            pbr.insert("metallicFactor", 0.0);
-            pbr.insert("roughnessFactor", 0.9);
-            mat.insert("pbrMetallicRoughness", pbr);
-            materialsJson.append(mat);
-            materialLookup[instance.material] = materialCounter++;
+    std::uint64_t fullPrecisionBytes = 0;
+
+    // Meshes that are translated copies of an earlier one (same hash, then an
+    // exact comparison) reuse its glTF mesh and only get their own node. The
+    // first copy's buffer is kept for the comparison, so later copies cost a
+    // compare rather than a rebuild on this thread.
+    struct SharedMesh {
+        std::shared_ptr<const GeometryKernel::MeshBuffer> mesh;
+        std::string material;
+        Vector3 origin;
+        int meshIndex;
+        Vector3 quantizedOrigin;
+        float quantizedScale;
+    };
+    std::unordered_map<std::uint64_t, std::vector<SharedMesh>> sharedMeshes;
+
+    auto hashMesh = [](const SceneItem& item, ExportChunk& chunk) {
+        chunk.hash = meshShapeHash(chunk.mesh, item.material);
+    };
+    exportInWindows(items, kernel, options, summary, hashMesh, [&](const SceneItem& item, const ExportChunk& chunk) {
+        if (chunk.empty()) {
+            return;
+        }
+        const auto& mesh = chunk.mesh;
+
+        const SharedMesh* shared = nullptr;
+        auto& candidates = sharedMeshes[chunk.hash];
+        for (const auto& candidate : candidates) {
+            if (candidate.material == item.material
+                && sameShape(*candidate.mesh, mesh)) {
+                shared = &candidate;
+                break;
+            }
         }
-    }
-
-    int bufferViewCounter = 0;
-    int accessorCounter = 0;
-    int meshCounter = 0;
 
-    for (const auto& instance : instances) {
-        if (instance.mesh.indices.empty() || instance.mesh.positions.empty()) {
-            continue;
-        }
+        if (!shared) {
+            if (!item.material.empty() && !materialLookup.count(item.material)) {
+                QJsonObject mat;
+                mat.insert("name", QString::fromStdString(item.material));
+                QJsonObject pbr;
+                QJsonArray baseColor;
+                baseColor.append(0.8);
+                baseColor.append(0.8);
+                baseColor.append(0.8);
+                baseColor.append(1.0);
+                pbr.insert("baseColorFactor", baseColor);
+                pbr.insert("metallicFactor", 0.0);
+                pbr.insert("roughnessFactor", 0.9);
+                mat.insert("pbrMetallicRoughness", pbr);
+                materialLookup[item.material] = static_cast<int>(materialsJson.size());
+                materialsJson.append(mat);
+            }
 
-        const auto& mesh = instance.mesh;
-        std::size_t positionOffset = static_cast<std::size_t>(binary.size());
-        for (const auto& v : mesh.positions) {
-            appendAligned(binary, &v.x, sizeof(float));
-            appendAligned(binary, &v.y, sizeof(float));
-            appendAligned(binary, &v.z, sizeof(float));
-        }
-        std::size_t positionByteLength = static_cast<std::size_t>(binary.size()) - positionOffset;
+            const GltfPrimitive written = options.quantizeGltf
+                ? appendQuantizedPrimitive(binary, bufferViews, accessors, mesh)
+                : appendPrimitive(binary, bufferViews, accessors, mesh);
+            fullPrecisionBytes += (mesh.positions.size() + mesh.normals.size()) * sizeof(Vector3)
+                + mesh.indices.size() * sizeof(std::uint32_t);
+
+            QJsonObject attributes;
+            attributes.insert("POSITION", written.positions);
+            attributes.insert("NORMAL", written.normals);
+
+            QJsonObject primitive;
+            primitive.insert("attributes", attributes);
+            primitive.insert("indices", written.indices);
+            if (!item.material.empty()) {
+                primitive.insert("material", materialLookup[item.material]);
+            }
 
-        std::size_t normalOffset = static_cast<std::size_t>(binary.size());
-        for (const auto& n : mesh.normals) {
-            appendAligned(binary, &n.x, sizeof(float));
-            appendAligned(binary, &n.y, sizeof(float));
-            appendAligned(binary, &n.z, sizeof(float));
-        }
-        std::size_t normalByteLength = static_cast<std::size_t>(binary.size()) - normalOffset;
+            QJsonArray primitives;
+            primitives.append(primitive);
 
-        std::size_t indexOffset = static_cast<std::size_t>(binary.size());
-        for (std::uint32_t idx : mesh.indices) {
-            appendAligned(binary, &idx, sizeof(std::uint32_t));
-        }
-        std::size_t indexByteLength = static_cast<std::size_t>(binary.size()) - indexOffset;
-
-        QJsonObject positionView;
-        positionView.insert("buffer", 0);
-        positionView.insert("byteOffset", static_cast<int>(positionOffset));
-        positionView.insert("byteLength", static_cast<int>(positionByteLength));
-        positionView.insert("target", 34962);
-        bufferViews.append(positionView);
-        int positionViewIndex = bufferViewCounter++;
-
-        QJsonObject normalView;
-        normalView.insert("buffer", 0);
-        normalView.insert("byteOffset", static_cast<int>(normalOffset));
-        normalView.insert("byteLength", static_cast<int>(normalByteLength));
-        normalView.insert("target", 34962);
-        bufferViews.append(normalView);
-        int normalViewIndex = bufferViewCounter++;
-
-        QJsonObject indexView;
-        indexView.insert("buffer", 0);
-        indexView.insert("byteOffset", static_cast<int>(indexOffset));
-        indexView.insert("byteLength", static_cast<int>(indexByteLength));
-        indexView.insert("target", 34963);
-        bufferViews.append(indexView);
-        int indexViewIndex = bufferViewCounter++;
-
-        Vector3 minPos = mesh.positions.front();
-        Vector3 maxPos = mesh.positions.front();
-        for (const auto& v : mesh.positions) {
-            minPos.x = std::min(minPos.x, v.x);
-            minPos.y = std::min(minPos.y, v.y);
-            minPos.z = std::min(minPos.z, v.z);
-            maxPos.x = std::max(maxPos.x, v.x);
-            maxPos.y = std::max(maxPos.y, v.y);
-            maxPos.z = std::max(maxPos.z, v.z);
+            QJsonObject meshJson;
+            meshJson.insert("name", QString::fromStdString(item.name));
+            meshJson.insert("primitives", primitives);
+            meshes.append(meshJson);
+            candidates.push_back({ std::make_shared<const GeometryKernel::MeshBuffer>(mesh), item.material,
+                                   mesh.positions.front(), static_cast<int>(meshes.size() - 1), written.origin,
+                                   written.scale });
+            shared = &candidates.back();
         }
 
-        QJsonArray minArray;
-        minArray.append(minPos.x);
-        minArray.append(minPos.y);
-        minArray.append(minPos.z);
-        QJsonArray maxArray;
-        maxArray.append(maxPos.x);
-        maxArray.append(maxPos.y);
-        maxArray.append(maxPos.z);
-
-        QJsonObject positionAccessor;
-        positionAccessor.insert("bufferView", positionViewIndex);
-        positionAccessor.insert("componentType", 5126);
-        positionAccessor.insert("count", static_cast<int>(mesh.positions.size()));
-        positionAccessor.insert("type", "VEC3");
-        positionAccessor.insert("min", minArray);
-        positionAccessor.insert("max", maxArray);
-        accessors.append(positionAccessor);
-        int positionAccessorIndex = accessorCounter++;
-
-        QJsonObject normalAccessor;
-        normalAccessor.insert("bufferView", normalViewIndex);
-        normalAccessor.insert("componentType", 5126);
-        normalAccessor.insert("count", static_cast<int>(mesh.normals.size()));
-        normalAccessor.insert("type", "VEC3");
-        accessors.append(normalAccessor);
-        int normalAccessorIndex = accessorCounter++;
-
-        QJsonObject indexAccessor;
-        indexAccessor.insert("bufferView", indexViewIndex);
-        indexAccessor.insert("componentType", 5125);
-        indexAccessor.insert("count", static_cast<int>(mesh.indices.size()));
-        indexAccessor.insert("type", "SCALAR");
-        accessors.append(indexAccessor);
-        int indexAccessorIndex = accessorCounter++;
-
-        QJsonObject attributes;
-        attributes.insert("POSITION", positionAccessorIndex);
-        attributes.insert("NORMAL", normalAccessorIndex);
-
-        QJsonObject primitive;
-        primitive.insert("attributes", attributes);
-        primitive.insert("indices", indexAccessorIndex);
-        if (!instance.material.empty() && materialLookup.count(instance.material)) {
-            primitive.insert("material", materialLookup[instance.material]);
+        // Place the shared mesh at this copy's position, then undo the
+        // quantisation (a no-op for float meshes).
+        const Vector3 offset = mesh.positions.front() - shared->origin + shared->quantizedOrigin;
+        auto matrix = withTranslation(item.transform, offset);
+        if (shared->quantizedScale != 1.0f) {
+            matrix = withScale(matrix, shared->quantizedScale);
         }
 
-        QJsonArray primitives;
-        primitives.append(primitive);
-
-        QJsonObject meshJson;
-        meshJson.insert("name", QString::fromStdString(instance.name));
-        meshJson.insert("primitives", primitives);
-        meshes.append(meshJson);
-        int meshIndex = meshCounter++;
-
         QJsonObject node;
-        node.insert("name", QString::fromStdString(instance.name));
-        node.insert("mesh", meshIndex);
-        node.insert("matrix", toMatrixArray(instance.transform));
+        node.insert("name", QString::fromStdString(item.name));
+        node.insert("mesh", shared->meshIndex);
+        node.insert("matrix", toMatrixArray(matrix));
         nodes.append(node);
         sceneNodes.append(nodes.size() - 1);
+    });
+
+    const std::uint64_t binaryLength = binary.offset();
+    if (!binary.close()) {
+        if (error) {
+            *error = "Failed to write glTF buffer";
+        }
+        return false;
+    }
+    if (summary) {
+        summary->geometryBytes = binaryLength;
+        summary->fullPrecisionBytes = fullPrecisionBytes;
     }
 
     QJsonObject buffer;
-    buffer.insert("byteLength", static_cast<int>(binary.size()));
-    buffer.insert("uri", QFileInfo(QString::fromStdString(output.string())).completeBaseName() + ".bin");
+    buffer.insert("byteLength", static_cast<qint64>(binaryLength));
+    buffer.insert("uri", binName);
     QJsonArray buffers;
     buffers.append(buffer);
 
@@ -456,6 +819,12 @@ bool writeGltf(const std::filesystem::path& output,
     asset.insert("version", "2.0");
     asset.insert("generator", "FreeCrafter SceneExporter");
     root.insert("asset", asset);
+    if (options.quantizeGltf && !meshes.isEmpty()) {
+        QJsonArray extensions;
+        extensions.append("KHR_mesh_quantization");
+        root.insert("extensionsUsed", extensions);
+        root.insert("extensionsRequired", extensions);
+    }
     root.insert("buffers", buffers);
     root.insert("bufferViews", bufferViews);
     root.insert("accessors", accessors);
@@ -477,18 +846,6 @@ bool writeGltf(const std::filesystem::path& output,
     QJsonDocument doc(root);
     jsonFile.write(doc.toJson(QJsonDocument::Indented));
     jsonFile.close();
-
-    QFileInfo outputInfo(QString::fromStdString(output.string()));
-    QString binPath = outputInfo.dir().filePath(outputInfo.completeBaseName() + ".bin");
-    QFile binFile(binPath);
-    if (!binFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        if (error) {
-            *error = "Failed to write glTF buffer";
-        }
-        return false;
-    }
-    binFile.write(binary);
-    binFile.close();
     return true;
 }
 
@@ -519,8 +876,16 @@ std::optional<SceneFormat> guessFormatFromFilename(const std::string& filename)
     return sceneFormatFromExtension(ext);
 }
 
-bool exportScene(const Scene::Document& document, const std::string& filePath, SceneFormat format, std::string* errorMessage)
+bool exportScene(const Scene::Document& document,
+                 const std::string& filePath,
+                 SceneFormat format,
+                 const ExportOptions& options,
+                 ExportSummary* summary,
+                 std::string* errorMessage)
 {
+    if (summary) {
+        *summary = ExportSummary{};
+    }
     if (!isFormatAvailable(format)) {
         if (errorMessage) {
             *errorMessage = "Requested format is not available in this build";
@@ -528,8 +893,8 @@ bool exportScene(const Scene::Document& document, const std::string& filePath, S
         return false;
     }
 
-    auto instances = gatherSceneInstances(document);
-    if (instances.empty()) {
+    auto items = gatherSceneItems(document);
+    if (items.empty()) {
         if (errorMessage) {
             *errorMessage = "Scene contains no exportable geometry";
         }
@@ -540,11 +905,11 @@ bool exportScene(const Scene::Document& document, const std::string& filePath, S
 
     switch (format) {
     case SceneFormat::OBJ:
-        return writeObj(outputPath, instances, errorMessage);
+        return writeObj(outputPath, items, document.geometry(), options, summary, errorMessage);
     case SceneFormat::STL:
-        return writeStl(outputPath, instances, errorMessage);
+        return writeStl(outputPath, items, document.geometry(), options, summary, errorMessage);
     case SceneFormat::GLTF:
-        return writeGltf(outputPath, instances, errorMessage);
+        return writeGltf(outputPath, items, document.geometry(), options, summary, errorMessage);
     case SceneFormat::FBX:
     case SceneFormat::DAE:
         if (errorMessage) {
@@ -563,4 +928,15 @@ bool exportScene(const Scene::Document& document, const std::string& filePath, S
     return false;
 }
 
+bool exportScene(const Scene::Document& document,
+                 const std::string& filePath,
+                 SceneFormat format,
+                 std::string* errorMessage,
+                 unsigned threadCount)
+{
+    ExportOptions options;
+    options.threadCount = threadCount;
+    return exportScene(document, filePath, format, options, nullptr, errorMessage);
+}
+
 }
@@ -6,8 +6,10 @@
 #include <QObject>
 #include <QtGlobal>
 
+#include <algorithm>
 #include <cctype>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <unordered_map>
@@ -20,7 +22,9 @@
 #include "GeometryKernel/Vector3.h"
 #include "GeometryKernel/Vector2.h"
 #include "Scene/Document.h"
+#include "FileIO/Importers/ObjParser.h"
 #include "FileIO/Importers/SceneImporter.h"
+#include "FileIO/Importers/StlReader.h"
 
 namespace FileIO::Importers {
 namespace {
@@ -37,7 +41,7 @@ Scene::Document::FileFormat detectFormat(const QString& path, Scene::Document::F
         return Scene::Document::FileFormat::Obj;
     if (suffix == QLatin1String("stl"))
         return Scene::Document::FileFormat::Stl;
-    if (suffix == QLatin1String("gltf"))
+    if (suffix == QLatin1String("gltf") || suffix == QLatin1String("glb"))
         return Scene::Document::FileFormat::Gltf;
     if (suffix == QLatin1String("fbx"))
         return Scene::Document::FileFormat::Fbx;
@@ -48,6 +52,44 @@ Scene::Document::FileFormat detectFormat(const QString& path, Scene::Document::F
     return Scene::Document::FileFormat::Auto;
 }
 
+// Polls for cancellation and reports progress once per this many faces.
+constexpr std::size_t kProgressBatch = 4096;
+
+// Tracks one import's progress against an optional ImportControl.
+class ImportMonitor {
+public:
+    ImportMonitor(const ImportControl* control, std::uint64_t totalBytes)
+        : control(control)
+    {
+        progress.totalBytes = totalBytes;
+    }
+
+    void setBytesRead(std::uint64_t bytes) { progress.bytesRead = std::min(bytes, progress.totalBytes); }
+    void setAllBytesRead() { progress.bytesRead = progress.totalBytes; }
+    void addTriangles(std::uint64_t count) { progress.trianglesBuilt += count; }
+
+    // Reports the current progress; returns true if the import should stop.
+    bool poll() const
+    {
+        if (!control)
+            return false;
+        if (control->onProgress)
+            control->onProgress(progress);
+        return control->cancelRequested && control->cancelRequested->load(std::memory_order_relaxed);
+    }
+
+private:
+    const ImportControl* control = nullptr;
+    ImportProgress progress;
+};
+
+bool cancelImport(ImportResult& result)
+{
+    result.cancelled = true;
+    result.errorMessage = QObject::tr("Import cancelled");
+    return false;
+}
+
 struct VertexKey {
     int position = -1;
     int texCoord = -1;
@@ -69,134 +111,95 @@ struct VertexKeyHasher {
     }
 };
 
-bool parseFaceVertex(const std::string& token, int vertexCount, int texCount, int normalCount,
-                     VertexKey& key)
+bool importObj(const QString& path, Document& document, ImportResult& result, ImportMonitor& monitor)
 {
-    if (token.empty())
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.errorMessage = QObject::tr("Unable to open OBJ file: %1").arg(path);
         return false;
+    }
 
-    int indices[3] = { -1, -1, -1 };
-    int index = 0;
-    std::string current;
-    for (char ch : token) {
-        if (ch == '/') {
-            if (index < 3) {
-                if (!current.empty()) {
-                    indices[index] = std::stoi(current);
-                }
-                current.clear();
-                ++index;
-            }
+    // Parse straight out of the mapped file; fall back to a single read when
+    // the filesystem does not support mapping.
+    const qint64 size = file.size();
+    const char* data = nullptr;
+    QByteArray fallback;
+    if (size > 0) {
+        if (uchar* mapped = file.map(0, size)) {
+            data = reinterpret_cast<const char*>(mapped);
         } else {
-            current.push_back(ch);
+            // The parser trusts size, so a short read must not get that far.
+            fallback = file.readAll();
+            if (fallback.size() != size) {
+                result.errorMessage = QObject::tr("Unable to read OBJ file: %1").arg(path);
+                return false;
+            }
+            data = fallback.constData();
         }
     }
-    if (!current.empty() && index < 3) {
-        indices[index] = std::stoi(current);
-    }
 
-    if (indices[0] == 0)
-        return false;
-
-    auto resolveIndex = [](int idx, int count) {
-        if (idx > 0) {
-            return idx - 1;
-        }
-        if (idx < 0) {
-            return count + idx;
-        }
-        return -1;
-    };
-
-    key.position = resolveIndex(indices[0], vertexCount);
-    key.texCoord = resolveIndex(indices[1], texCount);
-    key.normal = resolveIndex(indices[2], normalCount);
-    if (key.position < 0 || key.position >= vertexCount)
-        return false;
-    return true;
-}
-
-bool importObj(const QString& path, Document& document, ImportResult& result)
-{
-    std::ifstream stream(path.toStdString());
-    if (!stream.is_open()) {
-        result.errorMessage = QObject::tr("Unable to open OBJ file: %1").arg(path);
+    ObjData obj;
+    const bool parsed = data && parseObjBuffer(data, static_cast<std::size_t>(size), obj);
+    file.close();
+    if (!parsed) {
+        result.errorMessage = QObject::tr("No geometry found in OBJ file: %1").arg(path);
         return false;
     }
+    monitor.setBytesRead(static_cast<std::uint64_t>(size));
+    if (monitor.poll())
+        return cancelImport(result);
 
-    std::vector<Vector3> positions;
-    std::vector<Vector3> normals;
-    std::vector<Vector2> texCoords;
     std::unordered_set<std::string> materialSet;
     std::vector<std::string> materialOrder;
-    std::string activeMaterial;
+    for (const ObjNamedRun& run : obj.materials) {
+        if (!run.name.empty() && materialSet.insert(run.name).second)
+            materialOrder.push_back(run.name);
+    }
+
+    const int positionCount = static_cast<int>(obj.positions.size());
+    const int texCount = static_cast<int>(obj.texCoords.size());
+    const int normalCount = static_cast<int>(obj.normals.size());
 
     HalfEdgeMesh mesh;
     std::unordered_map<VertexKey, int, VertexKeyHasher> vertexMap;
-
-    std::string line;
-    while (std::getline(stream, line)) {
-        if (line.empty())
-            continue;
-        if (line[0] == '#')
-            continue;
-        std::istringstream ls(line);
-        std::string command;
-        ls >> command;
-        if (command == "v") {
-            float x = 0.0f, y = 0.0f, z = 0.0f;
-            ls >> x >> y >> z;
-            positions.emplace_back(x, y, z);
-        } else if (command == "vn") {
-            float x = 0.0f, y = 0.0f, z = 0.0f;
-            ls >> x >> y >> z;
-            normals.emplace_back(x, y, z);
-        } else if (command == "vt") {
-            float u = 0.0f, v = 0.0f;
-            ls >> u >> v;
-            texCoords.emplace_back(u, v);
-        } else if (command == "usemtl") {
-            ls >> activeMaterial;
-            if (!activeMaterial.empty()) {
-                if (materialSet.insert(activeMaterial).second) {
-                    materialOrder.push_back(activeMaterial);
-                }
-            }
-        } else if (command == "f") {
-            std::vector<int> loop;
-            std::string token;
-            while (ls >> token) {
-                VertexKey key;
-                if (!parseFaceVertex(token, static_cast<int>(positions.size()), static_cast<int>(texCoords.size()),
-                                     static_cast<int>(normals.size()), key)) {
-                    continue;
+    vertexMap.reserve(obj.positions.size());
+
+    std::vector<int> loop;
+    for (std::size_t face = 0; face < obj.faceCount(); ++face) {
+        if (face % kProgressBatch == kProgressBatch - 1 && monitor.poll())
+            return cancelImport(result);
+        loop.clear();
+        for (std::uint32_t c = obj.faceOffsets[face]; c < obj.faceOffsets[face + 1]; ++c) {
+            const ObjCorner& corner = obj.corners[c];
+            if (corner.position < 0 || corner.position >= positionCount)
+                continue;
+            VertexKey key{ corner.position, corner.texCoord, corner.normal };
+            auto found = vertexMap.find(key);
+            int vertexIndex;
+            if (found == vertexMap.end()) {
+                Vector3 normal;
+                bool hasNormal = false;
+                if (key.normal >= 0 && key.normal < normalCount) {
+                    normal = obj.normals[static_cast<std::size_t>(key.normal)];
+                    hasNormal = true;
                 }
-                auto found = vertexMap.find(key);
-                int vertexIndex;
-                if (found == vertexMap.end()) {
-                    Vector3 normal;
-                    bool hasNormal = false;
-                    if (key.normal >= 0 && key.normal < static_cast<int>(normals.size())) {
-                        normal = normals[static_cast<std::size_t>(key.normal)];
-                        hasNormal = true;
-                    }
-                    Vector2 uv;
-                    bool hasUV = false;
-                    if (key.texCoord >= 0 && key.texCoord < static_cast<int>(texCoords.size())) {
-                        uv = texCoords[static_cast<std::size_t>(key.texCoord)];
-                        hasUV = true;
-                    }
-                    const Vector3& pos = positions[static_cast<std::size_t>(key.position)];
-                    vertexIndex = mesh.addVertex(pos, normal, uv, hasNormal, hasUV);
-                    vertexMap.emplace(key, vertexIndex);
-                } else {
-                    vertexIndex = found->second;
+                Vector2 uv;
+                bool hasUV = false;
+                if (key.texCoord >= 0 && key.texCoord < texCount) {
+                    uv = obj.texCoords[static_cast<std::size_t>(key.texCoord)];
+                    hasUV = true;
                 }
-                loop.push_back(vertexIndex);
-            }
-            if (loop.size() >= 3) {
-                mesh.addFace(loop);
+                const Vector3& pos = obj.positions[static_cast<std::size_t>(key.position)];
+                vertexIndex = mesh.addVertex(pos, normal, uv, hasNormal, hasUV);
+                vertexMap.emplace(key, vertexIndex);
+            } else {
+                vertexIndex = found->second;
             }
+            loop.push_back(vertexIndex);
+        }
+        if (loop.size() >= 3) {
+            mesh.addFace(loop);
+            monitor.addTriangles(loop.size() - 2);
         }
     }
 
@@ -204,6 +207,8 @@ bool importObj(const QString& path, Document& document, ImportResult& result)
         result.errorMessage = QObject::tr("No geometry found in OBJ file: %1").arg(path);
         return false;
     }
+    if (monitor.poll())
+        return cancelImport(result);
 
     mesh.recomputeNormals();
 
@@ -228,53 +233,34 @@ bool importObj(const QString& path, Document& document, ImportResult& result)
     return true;
 }
 
-bool readBinaryStl(const QString& path, Document& document, ImportResult& result)
+bool readBinaryStl(const QString& path, const char* data, std::size_t size, Document& document, ImportResult& result,
+                   ImportMonitor& monitor)
 {
-    std::ifstream stream(path.toStdString(), std::ios::binary);
-    if (!stream.is_open()) {
-        result.errorMessage = QObject::tr("Unable to open STL file: %1").arg(path);
+    StlMesh indexed;
+    if (!readBinaryStlBuffer(data, size, indexed)) {
+        result.errorMessage = QObject::tr("STL file is truncated: %1").arg(path);
         return false;
     }
-
-    char header[80];
-    stream.read(header, 80);
-    if (!stream)
-        return false;
-    std::uint32_t triangleCount = 0;
-    stream.read(reinterpret_cast<char*>(&triangleCount), sizeof(triangleCount));
-    if (!stream)
-        return false;
+    monitor.setBytesRead(size);
+    if (monitor.poll())
+        return cancelImport(result);
 
     HalfEdgeMesh mesh;
-    for (std::uint32_t i = 0; i < triangleCount; ++i) {
-        float nx = 0.0f, ny = 0.0f, nz = 0.0f;
-        stream.read(reinterpret_cast<char*>(&nx), sizeof(float));
-        stream.read(reinterpret_cast<char*>(&ny), sizeof(float));
-        stream.read(reinterpret_cast<char*>(&nz), sizeof(float));
-        Vector3 faceNormal(nx, ny, nz);
-        int indices[3] = { -1, -1, -1 };
-        for (int v = 0; v < 3; ++v) {
-            float x = 0.0f, y = 0.0f, z = 0.0f;
-            stream.read(reinterpret_cast<char*>(&x), sizeof(float));
-            stream.read(reinterpret_cast<char*>(&y), sizeof(float));
-            stream.read(reinterpret_cast<char*>(&z), sizeof(float));
-            Vector3 position(x, y, z);
-            indices[v] = mesh.addVertex(position, faceNormal, Vector2(), faceNormal.lengthSquared() > 0.0f, false);
-        }
-        std::uint16_t attribute = 0;
-        stream.read(reinterpret_cast<char*>(&attribute), sizeof(attribute));
-        if (!stream)
-            return false;
-        std::vector<int> loop{ indices[0], indices[1], indices[2] };
-        mesh.addFace(loop);
+    mesh.getVertices().reserve(indexed.positions.size());
+    for (const Vector3& position : indexed.positions) {
+        mesh.addVertex(position);
     }
+    std::vector<Vector3>().swap(indexed.positions);
+    monitor.addTriangles(mesh.addTriangles(indexed.indices));
+    std::vector<std::uint32_t>().swap(indexed.indices);
 
     if (mesh.getVertices().empty()) {
         result.errorMessage = QObject::tr("No geometry found in STL file: %1").arg(path);
         return false;
     }
+    if (monitor.poll())
+        return cancelImport(result);
 
-    mesh.heal();
     mesh.recomputeNormals();
 
     auto solid = Solid::createFromMesh(std::move(mesh));
@@ -296,7 +282,7 @@ bool readBinaryStl(const QString& path, Document& document, ImportResult& result
     return true;
 }
 
-bool importStl(const QString& path, Document& document, ImportResult& result)
+bool importStl(const QString& path, Document& document, ImportResult& result, ImportMonitor& monitor)
 {
     QFile file(path);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -304,13 +290,29 @@ bool importStl(const QString& path, Document& document, ImportResult& result)
         return false;
     }
 
-    QByteArray header = file.peek(80);
-    bool isAscii = header.startsWith("solid");
-    file.close();
-
+    // Binary files are read straight out of the mapping; fall back to a single
+    // read when the filesystem does not support mapping.
+    const qint64 size = file.size();
+    const char* data = nullptr;
+    QByteArray fallback;
+    if (size > 0) {
+        if (uchar* mapped = file.map(0, size)) {
+            data = reinterpret_cast<const char*>(mapped);
+        } else {
+            fallback = file.readAll();
+            if (fallback.size() != size) {
+                result.errorMessage = QObject::tr("Unable to read STL file: %1").arg(path);
+                return false;
+            }
+            data = fallback.constData();
+        }
+    }
+    const std::size_t length = static_cast<std::size_t>(std::max<qint64>(size, 0));
+    const bool isAscii = !isBinaryStl(data, length) && length >= 5 && std::memcmp(data, "solid", 5) == 0;
     if (!isAscii) {
-        return readBinaryStl(path, document, result);
+        return readBinaryStl(path, data, length, document, result, monitor);
     }
+    file.close();
 
     std::ifstream stream(path.toStdString());
     if (!stream.is_open()) {
@@ -322,7 +324,15 @@ bool importStl(const QString& path, Document& document, ImportResult& result)
     std::string line;
     Vector3 currentNormal;
     bool normalValid = false;
+    std::size_t lineCount = 0;
     while (std::getline(stream, line)) {
+        if (++lineCount % kProgressBatch == 0) {
+            const std::streamoff position = stream.tellg();
+            if (position > 0)
+                monitor.setBytesRead(static_cast<std::uint64_t>(position));
+            if (monitor.poll())
+                return cancelImport(result);
+        }
         std::istringstream ls(line);
         std::string token;
         ls >> token;
@@ -344,6 +354,7 @@ bool importStl(const QString& path, Document& document, ImportResult& result)
             if (count >= 3) {
                 std::vector<int> loop{ static_cast<int>(count - 3), static_cast<int>(count - 2), static_cast<int>(count - 1) };
                 mesh.addFace(loop);
+                monitor.addTriangles(1);
             }
         }
     }
@@ -352,6 +363,9 @@ bool importStl(const QString& path, Document& document, ImportResult& result)
         result.errorMessage = QObject::tr("No geometry found in STL file: %1").arg(path);
         return false;
     }
+    monitor.setBytesRead(length);
+    if (monitor.poll())
+        return cancelImport(result);
 
     mesh.heal();
     mesh.recomputeNormals();
@@ -375,11 +389,15 @@ bool importStl(const QString& path, Document& document, ImportResult& result)
     return true;
 }
 
-bool importGltf(const QString& path, Document& document, ImportResult& result)
+bool importGltf(const QString& path, Document& document, ImportResult& result, ImportMonitor& monitor)
 {
-    Scene::Document tempDocument;
+    // The scene reader is not incremental; progress is reported before and
+    // after it runs.
+    if (monitor.poll())
+        return cancelImport(result);
+    std::vector<Scene::Document::ObjectId> created;
     std::string errorMessage;
-    if (!importScene(tempDocument, path.toStdString(), FileIO::SceneFormat::GLTF, &errorMessage)) {
+    if (!appendScene(document, path.toStdString(), FileIO::SceneFormat::GLTF, &created, &errorMessage)) {
         if (!errorMessage.empty()) {
             result.errorMessage = QString::fromStdString(errorMessage);
         } else {
@@ -388,75 +406,48 @@ bool importGltf(const QString& path, Document& document, ImportResult& result)
         return false;
     }
 
-    const auto& imported = tempDocument.geometry().getObjects();
-    if (imported.empty()) {
+    if (created.empty()) {
         result.errorMessage = QObject::tr("glTF file did not contain importable meshes: %1").arg(path);
         return false;
     }
 
-    std::unordered_map<GeometryObject::StableId, std::string> nameMap;
-    std::vector<const Scene::Document::ObjectNode*> stack;
-    stack.push_back(&tempDocument.objectTree());
-    while (!stack.empty()) {
-        const Scene::Document::ObjectNode* node = stack.back();
-        stack.pop_back();
-        if (!node)
-            continue;
-        if (node->geometry) {
-            GeometryObject::StableId id = node->geometry->getStableId();
-            if (id != 0)
-                nameMap[id] = node->name;
-        }
-        for (const auto& child : node->children) {
-            stack.push_back(child.get());
-        }
-    }
-
-    const auto& sourceMaterials = tempDocument.geometry().getMaterials();
-    for (const auto& objectPtr : imported) {
-        if (!objectPtr)
-            continue;
-
-        std::unique_ptr<GeometryObject> clone = objectPtr->clone();
-        if (!clone) {
-            result.errorMessage = QObject::tr("Failed to clone glTF geometry: %1").arg(path);
-            return false;
-        }
-
-        GeometryObject* target = document.geometry().addObject(std::move(clone));
-        if (!target) {
-            result.errorMessage = QObject::tr("Failed to register glTF geometry: %1").arg(path);
-            return false;
-        }
-
-        GeometryObject::StableId sourceId = objectPtr->getStableId();
-        auto materialIt = sourceMaterials.find(sourceId);
-        if (materialIt != sourceMaterials.end()) {
-            document.geometry().assignMaterial(target, materialIt->second);
-        }
-
-        std::string nodeName;
-        if (auto nameIt = nameMap.find(sourceId); nameIt != nameMap.end()) {
-            nodeName = nameIt->second;
-        } else {
-            nodeName = QFileInfo(path).completeBaseName().toStdString();
-        }
-
-        Scene::Document::ObjectId objectId = document.ensureObjectForGeometry(target, nodeName);
+    // Instances report the materials of all their parts, in part order.
+    const auto& materials = document.geometry().getMaterials();
+    for (Scene::Document::ObjectId objectId : created) {
         ImportedObjectSummary summary;
         summary.objectId = objectId;
-        if (materialIt != sourceMaterials.end()) {
-            summary.materialSlots.push_back(materialIt->second);
+        std::vector<const Scene::Document::ObjectNode*> stack{ document.findObject(objectId) };
+        while (!stack.empty()) {
+            const Scene::Document::ObjectNode* node = stack.back();
+            stack.pop_back();
+            if (!node)
+                continue;
+            if (node->geometry) {
+                monitor.addTriangles(node->geometry->getMesh().getTriangles().size());
+                auto materialIt = materials.find(node->geometry->getStableId());
+                if (materialIt != materials.end()
+                    && std::find(summary.materialSlots.begin(), summary.materialSlots.end(), materialIt->second)
+                        == summary.materialSlots.end()) {
+                    summary.materialSlots.push_back(materialIt->second);
+                }
+            }
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+                stack.push_back(it->get());
+            }
         }
         result.objects.push_back(std::move(summary));
     }
 
-    return !result.objects.empty();
+    monitor.setAllBytesRead();
+    if (monitor.poll())
+        return cancelImport(result);
+    return true;
 }
 
 } // namespace
 
-ImportResult FileImporter::import(const QString& filePath, Scene::Document& document, Scene::Document::FileFormat hint)
+ImportResult FileImporter::import(const QString& filePath, Scene::Document& document, Scene::Document::FileFormat hint,
+                                  const ImportControl* control)
 {
     ImportResult result;
     if (filePath.isEmpty()) {
@@ -472,17 +463,18 @@ ImportResult FileImporter::import(const QString& filePath, Scene::Document& docu
 
     auto format = detectFormat(filePath, hint);
     result.resolvedFormat = format;
+    ImportMonitor monitor(control, static_cast<std::uint64_t>(std::max<qint64>(info.size(), 0)));
 
     bool ok = false;
     switch (format) {
     case Scene::Document::FileFormat::Obj:
-        ok = importObj(filePath, document, result);
+        ok = importObj(filePath, document, result, monitor);
         break;
     case Scene::Document::FileFormat::Stl:
-        ok = importStl(filePath, document, result);
+        ok = importStl(filePath, document, result, monitor);
         break;
     case Scene::Document::FileFormat::Gltf:
-        ok = importGltf(filePath, document, result);
+        ok = importGltf(filePath, document, result, monitor);
         break;
     case Scene::Document::FileFormat::Fbx:
     case Scene::Document::FileFormat::Dxf:
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <QString>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -15,15 +18,33 @@ struct ImportedObjectSummary {
 
 struct ImportResult {
     bool success = false;
+    bool cancelled = false;
     QString errorMessage;
     Scene::Document::FileFormat resolvedFormat = Scene::Document::FileFormat::Auto;
     std::vector<ImportedObjectSummary> objects;
 };
 
+struct ImportProgress {
+    std::uint64_t bytesRead = 0;
+    std::uint64_t totalBytes = 0;
+    std::uint64_t trianglesBuilt = 0;
+};
+
+// Lets another thread follow and stop an import. onProgress is called on the
+// importing thread; cancelRequested is polled between batches of faces, and a
+// cancelled import returns with ImportResult::cancelled set.
+struct ImportControl {
+    std::function<void(const ImportProgress&)> onProgress;
+    const std::atomic<bool>* cancelRequested = nullptr;
+};
+
 class FileImporter {
 public:
+    // Adds the file's contents to document. Callers that must not expose a
+    // half-built import (or that import off the GUI thread) pass a detached
+    // document and merge it with Document::commitImport().
     static ImportResult import(const QString& filePath, Scene::Document& document,
-                               Scene::Document::FileFormat hint);
+                               Scene::Document::FileFormat hint, const ImportControl* control = nullptr);
 };
 
 } // namespace FileIO::Importers
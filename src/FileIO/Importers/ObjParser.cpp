@@ -0,0 +1,381 @@
+#include "ObjParser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "Core/Parallel.h"
+
+namespace FileIO::Importers {
+namespace {
+
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline bool isDigit(char c)
+{
+    return static_cast<unsigned>(c - '0') < 10u;
+}
+
+const char* skipBlanks(const char* p, const char* end)
+{
+    while (p < end && isBlank(*p))
+        ++p;
+    return p;
+}
+
+const char* skipToken(const char* p, const char* end)
+{
+    while (p < end && !isBlank(*p))
+        ++p;
+    return p;
+}
+
+bool matchesWord(const char* p, const char* end, const char* word)
+{
+    const std::size_t length = std::strlen(word);
+    if (static_cast<std::size_t>(end - p) < length || std::memcmp(p, word, length) != 0)
+        return false;
+    return true;
+}
+
+// Parses a decimal float in the style of std::from_chars (no locale, no
+// allocation, no terminator needed). Mantissas of up to 19 digits with
+// exponents in the exactly representable double range take the fast path;
+// anything else falls back to a long double scale, which is still far more
+// precise than the float we store. Returns the end of the number, or p itself
+// when nothing could be parsed.
+const char* parseFloat(const char* p, const char* end, float& value)
+{
+    static constexpr double kPow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    const char* start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    std::uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool sawDigit = false;
+    while (p < end && isDigit(*p)) {
+        sawDigit = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            if (mantissa != 0)
+                ++digits;
+        } else {
+            ++exponent;
+        }
+        ++p;
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end && isDigit(*p)) {
+            sawDigit = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                if (mantissa != 0)
+                    ++digits;
+                --exponent;
+            }
+            ++p;
+        }
+    }
+
+    if (!sawDigit) {
+        if (matchesWord(p, end, "inf") || matchesWord(p, end, "INF")) {
+            value = negative ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+            return skipToken(p, end);
+        }
+        if (matchesWord(p, end, "nan") || matchesWord(p, end, "NAN")) {
+            value = std::numeric_limits<float>::quiet_NaN();
+            return skipToken(p, end);
+        }
+        return start;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* mark = p++;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negativeExponent = *p == '-';
+            ++p;
+        }
+        if (p < end && isDigit(*p)) {
+            int explicitExponent = 0;
+            while (p < end && isDigit(*p)) {
+                if (explicitExponent < 100000)
+                    explicitExponent = explicitExponent * 10 + (*p - '0');
+                ++p;
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        } else {
+            p = mark;
+        }
+    }
+
+    double result;
+    if (mantissa == 0) {
+        result = 0.0;
+    } else if (mantissa <= (std::uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+        result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result / kPow10[-exponent] : result * kPow10[exponent];
+    } else {
+        result = static_cast<double>(static_cast<long double>(mantissa) * std::pow(10.0L, exponent));
+    }
+    value = static_cast<float>(negative ? -result : result);
+    return p;
+}
+
+const char* parseInt(const char* p, const char* end, long long& value)
+{
+    const char* start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    if (p >= end || !isDigit(*p))
+        return start;
+    long long result = 0;
+    while (p < end && isDigit(*p)) {
+        if (result < (std::numeric_limits<int>::max)())
+            result = result * 10 + (*p - '0');
+        ++p;
+    }
+    value = negative ? -result : result;
+    return p;
+}
+
+// Parses up to count floats; missing or malformed components stay 0 just like
+// a failed stream extraction.
+void parseFloats(const char* p, const char* end, float* values, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        p = skipBlanks(p, end);
+        const char* next = parseFloat(p, end, values[i]);
+        if (next == p)
+            return;
+        p = next;
+    }
+}
+
+std::string restOfLine(const char* p, const char* end)
+{
+    p = skipBlanks(p, end);
+    while (end > p && isBlank(end[-1]))
+        --end;
+    return std::string(p, end);
+}
+
+struct ChunkResult {
+    ObjData data;
+    // Corner slots whose index was relative and still needs the number of
+    // attributes defined by earlier chunks added.
+    std::vector<std::uint32_t> relativePositions;
+    std::vector<std::uint32_t> relativeTexCoords;
+    std::vector<std::uint32_t> relativeNormals;
+};
+
+// Resolves one face corner index. Positive indices are absolute; negative ones
+// count back from the attributes seen so far in this chunk and are recorded
+// for fixing up once the earlier chunks' counts are known.
+int resolveIndex(long long index, std::size_t localCount, std::uint32_t corner, std::vector<std::uint32_t>& relative)
+{
+    if (index > 0)
+        return static_cast<int>(index - 1);
+    if (index < 0) {
+        relative.push_back(corner);
+        return static_cast<int>(static_cast<long long>(localCount) + index);
+    }
+    return -1;
+}
+
+void parseFace(const char* p, const char* end, ChunkResult& chunk)
+{
+    ObjData& data = chunk.data;
+    while (true) {
+        p = skipBlanks(p, end);
+        if (p >= end)
+            break;
+        const char* tokenEnd = skipToken(p, end);
+        long long indices[3] = { 0, 0, 0 };
+        const char* cursor = p;
+        for (int slot = 0; slot < 3 && cursor < tokenEnd; ++slot) {
+            if (*cursor != '/')
+                cursor = parseInt(cursor, tokenEnd, indices[slot]);
+            if (cursor < tokenEnd && *cursor == '/')
+                ++cursor;
+            else
+                break;
+        }
+        p = tokenEnd;
+        if (indices[0] == 0)
+            continue;
+
+        const auto corner = static_cast<std::uint32_t>(data.corners.size());
+        ObjCorner resolved;
+        resolved.position = resolveIndex(indices[0], data.positions.size(), corner, chunk.relativePositions);
+        resolved.texCoord = resolveIndex(indices[1], data.texCoords.size(), corner, chunk.relativeTexCoords);
+        resolved.normal = resolveIndex(indices[2], data.normals.size(), corner, chunk.relativeNormals);
+        data.corners.push_back(resolved);
+    }
+    if (data.corners.size() != data.faceOffsets.back())
+        data.faceOffsets.push_back(static_cast<std::uint32_t>(data.corners.size()));
+}
+
+void parseSlice(const char* p, const char* end, ChunkResult& chunk)
+{
+    ObjData& data = chunk.data;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        if (!lineEnd)
+            lineEnd = end;
+
+        const char* cursor = skipBlanks(p, lineEnd);
+        const char* keywordEnd = skipToken(cursor, lineEnd);
+        const std::size_t keywordLength = static_cast<std::size_t>(keywordEnd - cursor);
+        if (keywordLength == 1) {
+            switch (*cursor) {
+            case 'v': {
+                float xyz[3] = { 0.0f, 0.0f, 0.0f };
+                parseFloats(keywordEnd, lineEnd, xyz, 3);
+                data.positions.emplace_back(xyz[0], xyz[1], xyz[2]);
+                break;
+            }
+            case 'f':
+                parseFace(keywordEnd, lineEnd, chunk);
+                break;
+            case 'o':
+            case 'g':
+                data.groups.push_back({ restOfLine(keywordEnd, lineEnd), data.faceCount() });
+                break;
+            default:
+                break;
+            }
+        } else if (keywordLength == 2 && cursor[0] == 'v') {
+            if (cursor[1] == 'n') {
+                float xyz[3] = { 0.0f, 0.0f, 0.0f };
+                parseFloats(keywordEnd, lineEnd, xyz, 3);
+                data.normals.emplace_back(xyz[0], xyz[1], xyz[2]);
+            } else if (cursor[1] == 't') {
+                float uv[2] = { 0.0f, 0.0f };
+                parseFloats(keywordEnd, lineEnd, uv, 2);
+                data.texCoords.emplace_back(uv[0], uv[1]);
+            }
+        } else if (keywordLength == 6 && std::memcmp(cursor, "usemtl", 6) == 0) {
+            const char* nameBegin = skipBlanks(keywordEnd, lineEnd);
+            data.materials.push_back({ std::string(nameBegin, skipToken(nameBegin, lineEnd)), data.faceCount() });
+        }
+
+        p = lineEnd < end ? lineEnd + 1 : end;
+    }
+}
+
+template <typename T>
+void copyInto(std::vector<T>& target, std::size_t offset, const std::vector<T>& source)
+{
+    std::copy(source.begin(), source.end(), target.begin() + static_cast<std::ptrdiff_t>(offset));
+}
+
+} // namespace
+
+bool parseObjBuffer(const char* data, std::size_t size, ObjData& out, unsigned threadCount, std::size_t minChunkSize)
+{
+    out = ObjData{};
+    if (!data || size == 0)
+        return false;
+
+    if (threadCount == 0)
+        threadCount = Core::defaultWorkerCount();
+    const std::size_t maxChunks = static_cast<std::size_t>(threadCount) * 4;
+    const std::size_t chunkCount = std::clamp<std::size_t>(size / std::max<std::size_t>(minChunkSize, 1), 1, maxChunks);
+
+    // Slice boundaries always sit just past a newline so no line is split.
+    std::vector<std::size_t> bounds(chunkCount + 1, size);
+    bounds[0] = 0;
+    for (std::size_t i = 1; i < chunkCount; ++i) {
+        std::size_t position = std::max(bounds[i - 1], size / chunkCount * i);
+        const void* newline = position < size ? std::memchr(data + position, '\n', size - position) : nullptr;
+        bounds[i] = newline ? static_cast<std::size_t>(static_cast<const char*>(newline) - data) + 1 : size;
+    }
+
+    std::vector<ChunkResult> chunks(chunkCount);
+    Core::parallelFor(chunkCount, threadCount, [&](std::size_t i) {
+        parseSlice(data + bounds[i], data + bounds[i + 1], chunks[i]);
+    });
+
+    struct Base {
+        std::size_t positions = 0;
+        std::size_t texCoords = 0;
+        std::size_t normals = 0;
+        std::size_t corners = 0;
+        std::size_t faces = 0;
+    };
+    std::vector<Base> bases(chunkCount + 1);
+    for (std::size_t i = 0; i < chunkCount; ++i) {
+        const ObjData& chunk = chunks[i].data;
+        bases[i + 1].positions = bases[i].positions + chunk.positions.size();
+        bases[i + 1].texCoords = bases[i].texCoords + chunk.texCoords.size();
+        bases[i + 1].normals = bases[i].normals + chunk.normals.size();
+        bases[i + 1].corners = bases[i].corners + chunk.corners.size();
+        bases[i + 1].faces = bases[i].faces + chunk.faceCount();
+    }
+    const Base& total = bases[chunkCount];
+    if (total.positions == 0 || total.corners > (std::numeric_limits<std::uint32_t>::max)())
+        return false;
+
+    out.positions.resize(total.positions);
+    out.texCoords.resize(total.texCoords);
+    out.normals.resize(total.normals);
+    out.corners.resize(total.corners);
+    out.faceOffsets.resize(total.faces + 1);
+
+    Core::parallelFor(chunkCount, threadCount, [&](std::size_t i) {
+        ChunkResult& chunk = chunks[i];
+        const Base& base = bases[i];
+        copyInto(out.positions, base.positions, chunk.data.positions);
+        copyInto(out.texCoords, base.texCoords, chunk.data.texCoords);
+        copyInto(out.normals, base.normals, chunk.data.normals);
+
+        for (std::uint32_t corner : chunk.relativePositions)
+            chunk.data.corners[corner].position += static_cast<int>(base.positions);
+        for (std::uint32_t corner : chunk.relativeTexCoords)
+            chunk.data.corners[corner].texCoord += static_cast<int>(base.texCoords);
+        for (std::uint32_t corner : chunk.relativeNormals)
+            chunk.data.corners[corner].normal += static_cast<int>(base.normals);
+        copyInto(out.corners, base.corners, chunk.data.corners);
+
+        const auto cornerBase = static_cast<std::uint32_t>(base.corners);
+        for (std::size_t face = 1; face < chunk.data.faceOffsets.size(); ++face)
+            out.faceOffsets[base.faces + face] = chunk.data.faceOffsets[face] + cornerBase;
+
+        std::vector<Vector3>().swap(chunk.data.positions);
+        std::vector<Vector3>().swap(chunk.data.normals);
+        std::vector<Vector2>().swap(chunk.data.texCoords);
+        std::vector<ObjCorner>().swap(chunk.data.corners);
+    });
+
+    for (std::size_t i = 0; i < chunkCount; ++i) {
+        for (auto& run : chunks[i].data.groups) {
+            run.firstFace += bases[i].faces;
+            out.groups.push_back(std::move(run));
+        }
+        for (auto& run : chunks[i].data.materials) {
+            run.firstFace += bases[i].faces;
+            out.materials.push_back(std::move(run));
+        }
+    }
+    return true;
+}
+
+}
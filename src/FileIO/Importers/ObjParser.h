@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GeometryKernel/Vector2.h"
+#include "GeometryKernel/Vector3.h"
+
+namespace FileIO::Importers {
+
+// One face corner with zero-based attribute indices. Relative (negative) OBJ
+// indices are already resolved against the whole file; -1 means the attribute
+// was not given. Indices are not range checked.
+struct ObjCorner {
+    int position = -1;
+    int texCoord = -1;
+    int normal = -1;
+};
+
+// A name that applies from firstFace onwards ("o"/"g" groups, "usemtl").
+struct ObjNamedRun {
+    std::string name;
+    std::size_t firstFace = 0;
+};
+
+struct ObjData {
+    std::vector<Vector3> positions;
+    std::vector<Vector3> normals;
+    std::vector<Vector2> texCoords;
+    std::vector<ObjCorner> corners;
+    // Face f owns corners [faceOffsets[f], faceOffsets[f + 1]).
+    std::vector<std::uint32_t> faceOffsets{ 0 };
+    std::vector<ObjNamedRun> groups;
+    std::vector<ObjNamedRun> materials;
+
+    std::size_t faceCount() const { return faceOffsets.size() - 1; }
+};
+
+// Parses an in-memory OBJ file. The buffer is split into newline-aligned
+// slices of at least minChunkSize bytes that are parsed on up to threadCount
+// workers (0 = one per core) and merged in file order. Only geometry
+// statements are read; everything else is skipped. Returns false if the
+// buffer holds no vertex positions.
+bool parseObjBuffer(const char* data, std::size_t size, ObjData& out, unsigned threadCount = 0,
+                    std::size_t minChunkSize = 4u << 20);
+
+}
@@ -8,12 +8,14 @@
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <functional>
+#include <memory>
 
 #include <QByteArray>
 #include <QFile>
@@ -21,30 +23,46 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QUrl>
 
 #include "GeometryKernel/GeometryKernel.h"
 #include "GeometryKernel/Solid.h"
+#include "GeometryKernel/TransformUtils.h"
+#include "FileIO/Importers/ObjParser.h"
+#include "FileIO/Importers/StlReader.h"
 #include "Scene/Document.h"
 
 namespace FileIO::Importers {
 namespace {
 
-std::string trim(const std::string& input)
-{
-    const auto first = std::find_if_not(input.begin(), input.end(), [](unsigned char c) { return std::isspace(c); });
-    const auto last = std::find_if_not(input.rbegin(), input.rend(), [](unsigned char c) { return std::isspace(c); }).base();
-    if (first >= last) {
-        return {};
-    }
-    return std::string(first, last);
-}
-
 struct ImportedMesh {
     std::string name;
    std::vector<Vector3> positions;
     std::vector<std::uint32_t> indices;
     std::string material;
     std::array<float, 16> transform = GeometryKernel::identityTransform();
+    // Positions were stored as integers and are only real coordinates once
+    // the node transform has been applied.
+    bool quantized = false;
+};
+
+// Parsed file contents. Meshes are placed directly; prototypes are meshes the
+// source file references from several places and become component
+// definitions with one instance per placement.
+struct ImportedScene {
+    struct Prototype {
+        std::string name;
+        std::vector<ImportedMesh> parts;
+    };
+    struct Instance {
+        std::size_t prototype = 0;
+        std::string name;
+        std::array<float, 16> transform = GeometryKernel::identityTransform();
+    };
+
+    std::vector<ImportedMesh> meshes;
+    std::vector<Prototype> prototypes;
+    std::vector<Instance> instances;
 };
 
 std::array<float, 16> readMatrix(const QJsonObject& node);
@@ -75,6 +93,40 @@ bool isIdentityTransform(const std::array<float, 16>& matrix)
     return true;
 }
 
+// True when the matrix survives Document::setWorldTransform(), which keeps
+// translation, rotation and scale only. Shear, such as a rotated child under a
+// non-uniformly scaled parent, would be lost.
+bool isExactTrs(const std::array<float, 16>& matrix)
+{
+    Vector3 translation;
+    Vector3 rotation;
+    Vector3 scale;
+    GeometryTransforms::decomposeTransform(matrix, translation, rotation, scale);
+    const auto rebuilt = GeometryTransforms::composeTransform(translation, rotation, scale);
+    for (int column = 0; column < 4; ++column) {
+        float extent = 0.0f;
+        for (int row = 0; row < 3; ++row) {
+            extent = std::max(extent, std::fabs(matrix[column * 4 + row]));
+        }
+        // Relative to the column, so tiny dequantisation scales are checked too.
+        const float tolerance = 1e-4f * (column == 3 ? std::max(extent, 1.0f) : extent);
+        for (int row = 0; row < 4; ++row) {
+            if (std::fabs(rebuilt[column * 4 + row] - matrix[column * 4 + row]) > tolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void bakeTransform(ImportedMesh& mesh, const std::array<float, 16>& transform)
+{
+    for (auto& v : mesh.positions) {
+        v = GeometryTransforms::transformPoint(transform, v);
+    }
+    mesh.transform = GeometryKernel::identityTransform();
+}
+
 std::array<float, 16> composeTrs(const QJsonObject& node)
 {
     std::array<float, 16> translation = GeometryKernel::identityTransform();
@@ -175,28 +227,30 @@ bool parseAsciiStl(const std::filesystem::path& path, ImportedMesh& mesh, std::s
 
 bool parseBinaryStl(const std::filesystem::path& path, ImportedMesh& mesh, std::string* error)
 {
-    std::ifstream file(path, std::ios::binary);
-    if (!file) {
+    QFile file(QString::fromStdString(path.string()));
+    if (!file.open(QIODevice::ReadOnly)) {
         if (error) {
             *error = "Unable to open STL file";
         }
         return false;
     }
 
-    std::array<char, 80> header{};
-    file.read(header.data(), header.size());
-    if (!file) {
-        if (error) {
-            *error = "Failed to read STL header";
+    const qint64 size = file.size();
+    const char* data = nullptr;
+    QByteArray fallback;
+    if (size > 0) {
+        if (uchar* mapped = file.map(0, size)) {
+            data = reinterpret_cast<const char*>(mapped);
+        } else {
+            fallback = file.readAll();
+            data = fallback.constData();
         }
-        return false;
     }
 
-    std::uint32_t triangleCount = 0;
-    file.read(reinterpret_cast<char*>(&triangleCount), sizeof(triangleCount));
-    if (!file) {
+    StlMesh indexed;
+    if (!readBinaryStlBuffer(data, static_cast<std::size_t>(std::max<qint64>(size, 0)), indexed)) {
         if (error) {
-            *error = "Failed to read STL triangle count";
+            *error = "Failed to read STL triangle data";
         }
         return false;
     }
@@ -204,140 +258,101 @@ bool parseBinaryStl(const std::filesystem::path& path, ImportedMesh& mesh, std::
     mesh = ImportedMesh{};
     mesh.name = path.stem().string();
     mesh.transform = GeometryKernel::identityTransform();
-    mesh.positions.reserve(static_cast<std::size_t>(triangleCount) * 3);
-    mesh.indices.reserve(static_cast<std::size_t>(triangleCount) * 3);
-
-    for (std::uint32_t i = 0; i < triangleCount; ++i) {
-        float normal[3];
-        file.read(reinterpret_cast<char*>(normal), sizeof(normal));
-        if (!file) {
-            if (error) {
-                *error = "Failed to read STL normal";
-            }
-            return false;
-        }
-
-        for (int v = 0; v < 3; ++v) {
-            float vertex[3];
-            file.read(reinterpret_cast<char*>(vertex), sizeof(vertex));
-            if (!file) {
-                if (error) {
-                    *error = "Failed to read STL vertex";
-                }
-                return false;
-            }
-            mesh.positions.emplace_back(vertex[0], vertex[1], vertex[2]);
-            mesh.indices.push_back(static_cast<std::uint32_t>(mesh.positions.size() - 1));
-        }
-
-        std::uint16_t attributeByteCount = 0;
-        file.read(reinterpret_cast<char*>(&attributeByteCount), sizeof(attributeByteCount));
-        if (!file) {
-            if (error) {
-                *error = "Failed to read STL attribute data";
-            }
-            return false;
-        }
-    }
-
+    mesh.positions = std::move(indexed.positions);
+    mesh.indices = std::move(indexed.indices);
     return true;
 }
 
 bool parseObj(const std::filesystem::path& path, std::vector<ImportedMesh>& meshes, std::string* error)
 {
-    std::ifstream file(path);
-    if (!file) {
+    QFile file(QString::fromStdString(path.string()));
+    if (!file.open(QIODevice::ReadOnly)) {
         if (error) {
             *error = "Unable to open OBJ file";
         }
         return false;
     }
 
-    std::vector<Vector3> globalPositions;
+    const qint64 size = file.size();
+    const char* data = nullptr;
+    QByteArray fallback;
+    if (size > 0) {
+        if (uchar* mapped = file.map(0, size)) {
+            data = reinterpret_cast<const char*>(mapped);
+        } else {
+            fallback = file.readAll();
+            data = fallback.constData();
+        }
+    }
+
+    ObjData obj;
+    const bool parsed = data && parseObjBuffer(data, static_cast<std::size_t>(size), obj);
+    file.close();
+
     ImportedMesh current;
     bool haveCurrent = false;
+    std::string activeMaterial;
     std::unordered_map<int, std::uint32_t> remap;
     std::size_t counter = 0;
 
     auto startObject = [&](const std::string& name) {
         if (haveCurrent && !current.indices.empty()) {
-            meshes.push_back(current);
+            meshes.push_back(std::move(current));
         }
         current = ImportedMesh{};
         current.name = name.empty() ? std::string("Object_") + std::to_string(++counter) : name;
         current.transform = GeometryKernel::identityTransform();
+        current.material = activeMaterial;
         remap.clear();
         haveCurrent = true;
     };
 
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty() || line[0] == '#') {
-            continue;
+    const int positionCount = static_cast<int>(obj.positions.size());
+    std::size_t nextGroup = 0;
+    std::size_t nextMaterial = 0;
+    std::vector<std::uint32_t> faceIndices;
+    for (std::size_t face = 0; parsed && face < obj.faceCount(); ++face) {
+        while (nextGroup < obj.groups.size() && obj.groups[nextGroup].firstFace <= face) {
+            startObject(obj.groups[nextGroup++].name);
         }
-        std::istringstream stream(line);
-        std::string tag;
-        stream >> tag;
-        if (tag == "v") {
-            float x = 0.0f, y = 0.0f, z = 0.0f;
-            stream >> x >> y >> z;
-            globalPositions.emplace_back(x, y, z);
-        } else if (tag == "o" || tag == "g") {
-            std::string name;
-            std::getline(stream, name);
-            startObject(trim(name));
-        } else if (tag == "usemtl") {
-            std::string name;
-            stream >> name;
+        while (nextMaterial < obj.materials.size() && obj.materials[nextMaterial].firstFace <= face) {
+            activeMaterial = obj.materials[nextMaterial++].name;
             if (!haveCurrent) {
                 startObject(std::string());
             }
-            current.material = name;
-        } else if (tag == "f") {
-            if (!haveCurrent) {
-                startObject(std::string());
+            current.material = activeMaterial;
+        }
+        if (!haveCurrent) {
+            startObject(std::string());
+        }
+
+        faceIndices.clear();
+        for (std::uint32_t c = obj.faceOffsets[face]; c < obj.faceOffsets[face + 1]; ++c) {
+            const int index = obj.corners[c].position;
+            if (index < 0 || index >= positionCount) {
+                continue;
             }
-            std::vector<std::uint32_t> faceIndices;
-            std::string token;
-            while (stream >> token) {
-                if (token.empty()) {
-                    continue;
-                }
-                std::string_view part(token);
-                auto slash = part.find('/');
-                if (slash != std::string_view::npos) {
-                    part = part.substr(0, slash);
-                }
-                int index = std::stoi(std::string(part));
-                if (index < 0) {
-                    index = static_cast<int>(globalPositions.size()) + index + 1;
-                }
-                index -= 1;
-                if (index < 0 || static_cast<std::size_t>(index) >= globalPositions.size()) {
-                    continue;
-                }
-                auto it = remap.find(index);
-                if (it == remap.end()) {
-                    std::uint32_t mapped = static_cast<std::uint32_t>(current.positions.size());
-                    current.positions.push_back(globalPositions[static_cast<std::size_t>(index)]);
-                    remap[index] = mapped;
-                    faceIndices.push_back(mapped);
-                } else {
-                    faceIndices.push_back(it->second);
-                }
+            auto it = remap.find(index);
+            if (it == remap.end()) {
+                std::uint32_t mapped = static_cast<std::uint32_t>(current.positions.size());
+                current.positions.push_back(obj.positions[static_cast<std::size_t>(index)]);
+                remap[index] = mapped;
+                faceIndices.push_back(mapped);
+            } else {
+                faceIndices.push_back(it->second);
             }
-            if (faceIndices.size() >= 3) {
-                for (std::size_t i = 1; i + 1 < faceIndices.size(); ++i) {
-                    current.indices.push_back(faceIndices[0]);
-                    current.indices.push_back(faceIndices[i]);
-                    current.indices.push_back(faceIndices[i + 1]);
-                }
+        }
+        if (faceIndices.size() >= 3) {
+            for (std::size_t i = 1; i + 1 < faceIndices.size(); ++i) {
+                current.indices.push_back(faceIndices[0]);
+                current.indices.push_back(faceIndices[i]);
+                current.indices.push_back(faceIndices[i + 1]);
             }
         }
     }
 
     if (haveCurrent && !current.indices.empty()) {
-        meshes.push_back(current);
+        meshes.push_back(std::move(current));
     }
 
     if (meshes.empty()) {
@@ -458,12 +473,13 @@ bool parseStl(const std::filesystem::path& path, std::vector<ImportedMesh>& mesh
         if (totalTriangles > 0 && sumTriangles == totalTriangles) {
             std::vector<ImportedMesh> splitMeshes;
             splitMeshes.reserve(metadataEntries.size());
-            std::size_t vertexCursor = 0;
+            std::size_t indexCursor = 0;
             std::size_t unnamedCounter = 0;
             std::string baseName = combined.name.empty() ? path.stem().string() : combined.name;
+            std::unordered_map<std::uint32_t, std::uint32_t> remap;
             for (const auto& entry : metadataEntries) {
-                std::size_t vertexCount = entry.triangles * 3;
-                if (vertexCursor + vertexCount > combined.positions.size()) {
+                std::size_t indexCount = entry.triangles * 3;
+                if (indexCursor + indexCount > combined.indices.size()) {
                     splitMeshes.clear();
                     break;
                 }
@@ -475,16 +491,20 @@ bool parseStl(const std::filesystem::path& path, std::vector<ImportedMesh>& mesh
                     split.name = baseName + std::string("_part") + std::to_string(++unnamedCounter);
                 }
                 split.material = entry.material;
-                split.positions.reserve(vertexCount);
-                split.indices.reserve(vertexCount);
-                for (std::size_t i = 0; i < vertexCount; ++i) {
-                    split.positions.push_back(combined.positions[vertexCursor + i]);
-                    split.indices.push_back(static_cast<std::uint32_t>(i));
+                split.indices.reserve(indexCount);
+                remap.clear();
+                for (std::size_t i = 0; i < indexCount; ++i) {
+                    std::uint32_t source = combined.indices[indexCursor + i];
+                    auto inserted = remap.emplace(source, static_cast<std::uint32_t>(split.positions.size()));
+                    if (inserted.second) {
+                        split.positions.push_back(combined.positions[source]);
+                    }
+                    split.indices.push_back(inserted.first->second);
                 }
-                vertexCursor += vertexCount;
+                indexCursor += indexCount;
                 splitMeshes.push_back(std::move(split));
             }
-            if (!splitMeshes.empty() && vertexCursor == combined.positions.size()) {
+            if (!splitMeshes.empty() && indexCursor == combined.indices.size()) {
                 for (auto& split : splitMeshes) {
                     meshes.push_back(std::move(split));
                 }
@@ -507,8 +527,10 @@ int componentWidth(int componentType)
     case 5125: // unsigned int
         return 4;
     case 5123: // unsigned short
+    case 5122: // short
         return 2;
     case 5121: // unsigned byte
+    case 5120: // byte
         return 1;
     default:
         return 0;
@@ -535,94 +557,245 @@ int typeElementCount(const QString& type)
     return 0;
 }
 
+// Bytes of one glTF buffer: a mapped external file, a decoded data URI or the
+// binary chunk of a GLB container.
+struct GltfBuffer {
+    const char* data = nullptr;
+    std::size_t size = 0;
+};
+
+// Keeps the mappings and fallback reads behind every GltfBuffer alive while
+// the accessors are read.
+struct GltfSources {
+    std::vector<std::unique_ptr<QFile>> files;
+    std::vector<QByteArray> owned;
+    std::vector<GltfBuffer> buffers;
+
+    GltfBuffer map(const QString& path)
+    {
+        auto file = std::make_unique<QFile>(path);
+        if (!file->open(QIODevice::ReadOnly)) {
+            return {};
+        }
+        GltfBuffer buffer;
+        buffer.size = static_cast<std::size_t>(std::max<qint64>(file->size(), 0));
+        if (buffer.size == 0) {
+            buffer.data = "";
+        } else if (uchar* mapped = file->map(0, file->size())) {
+            buffer.data = reinterpret_cast<const char*>(mapped);
+        } else {
+            owned.push_back(file->readAll());
+            buffer.data = owned.back().constData();
+            buffer.size = static_cast<std::size_t>(owned.back().size());
+        }
+        files.push_back(std::move(file));
+        return buffer;
+    }
+};
+
+// Validated location of an accessor's elements inside its buffer. count is
+// clamped to the elements that fit inside the buffer view.
+struct AccessorView {
+    const char* data = nullptr;
+    std::size_t count = 0;
+    std::size_t stride = 0;
+    int componentType = 0;
+    int elements = 0;
+    bool normalized = false;
+};
+
+bool resolveAccessor(const QJsonArray& bufferViews,
+                     const QJsonArray& accessors,
+                     int accessorIndex,
+                     const std::vector<GltfBuffer>& buffers,
+                     AccessorView& result)
+{
+    if (accessorIndex < 0 || accessorIndex >= accessors.size()) {
+        return false;
+    }
+    QJsonObject accessor = accessors[accessorIndex].toObject();
+    int bufferViewIndex = accessor.value("bufferView").toInt(-1);
+    if (bufferViewIndex < 0 || bufferViewIndex >= bufferViews.size()) {
+        return false;
+    }
+    QJsonObject view = bufferViews[bufferViewIndex].toObject();
+    int bufferIndex = view.value("buffer").toInt(0);
+    if (bufferIndex < 0 || bufferIndex >= static_cast<int>(buffers.size()) || !buffers[bufferIndex].data) {
+        return false;
+    }
+    const GltfBuffer& buffer = buffers[static_cast<std::size_t>(bufferIndex)];
+
+    result.componentType = accessor.value("componentType").toInt();
+    result.normalized = accessor.value("normalized").toBool(false);
+    result.elements = typeElementCount(accessor.value("type").toString());
+    const std::size_t elementSize = static_cast<std::size_t>(componentWidth(result.componentType) * result.elements);
+    if (elementSize == 0) {
+        return false;
+    }
+
+    const qint64 viewOffset = view.value("byteOffset").toInteger(0);
+    const qint64 accessorOffset = accessor.value("byteOffset").toInteger(0);
+    const qint64 viewLength = view.value("byteLength").toInteger(static_cast<qint64>(buffer.size) - viewOffset);
+    const qint64 count = accessor.value("count").toInteger(0);
+    if (viewOffset < 0 || accessorOffset < 0 || viewLength < 0 || count <= 0
+        || static_cast<std::uint64_t>(viewOffset) + static_cast<std::uint64_t>(viewLength) > buffer.size) {
+        return false;
+    }
+
+    const std::size_t viewEnd = static_cast<std::size_t>(viewOffset + viewLength);
+    const std::size_t base = static_cast<std::size_t>(viewOffset + accessorOffset);
+    result.stride = static_cast<std::size_t>(view.value("byteStride").toInt(0));
+    if (result.stride < elementSize) {
+        result.stride = elementSize;
+    }
+    if (base + elementSize > viewEnd) {
+        return false;
+    }
+    const std::size_t fitting = (viewEnd - base - elementSize) / result.stride + 1;
+    result.count = std::min(static_cast<std::size_t>(count), fitting);
+    result.data = buffer.data + base;
+    return true;
+}
+
+// Integer vec3 data as allowed by KHR_mesh_quantization. Normalized values map
+// to [0, 1] or [-1, 1]; others keep their integer value and rely on the node
+// transform for scale.
+template <typename T>
+void widenVec3(const AccessorView& view, std::vector<Vector3>& result)
+{
+    constexpr float kMax = static_cast<float>(std::numeric_limits<T>::max());
+    const bool normalized = view.normalized;
+    auto convert = [&](T value) {
+        const float f = static_cast<float>(value);
+        return normalized ? std::max(f / kMax, -1.0f) : f;
+    };
+    for (std::size_t i = 0; i < view.count; ++i) {
+        T xyz[3];
+        std::memcpy(xyz, view.data + i * view.stride, sizeof(xyz));
+        result[i] = Vector3(convert(xyz[0]), convert(xyz[1]), convert(xyz[2]));
+    }
+}
+
 std::vector<Vector3> readVec3Accessor(const QJsonArray& bufferViews,
                                       const QJsonArray& accessors,
                                       int accessorIndex,
-                                      const QByteArray& binary)
+                                      const std::vector<GltfBuffer>& buffers)
 {
+    static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be tightly packed for bulk copies");
+
     std::vector<Vector3> result;
-    if (accessorIndex < 0 || accessorIndex >= accessors.size()) {
+    AccessorView view;
+    if (!resolveAccessor(bufferViews, accessors, accessorIndex, buffers, view)) {
         return result;
     }
-    QJsonObject accessor = accessors[accessorIndex].toObject();
-    int bufferViewIndex = accessor.value("bufferView").toInt(-1);
-    if (bufferViewIndex < 0 || bufferViewIndex >= bufferViews.size()) {
+    if (view.elements != 3) {
         return result;
     }
-    QJsonObject view = bufferViews[bufferViewIndex].toObject();
-    int componentType = accessor.value("componentType").toInt();
-    int elements = typeElementCount(accessor.value("type").toString());
-    if (componentType != 5126 || elements != 3) {
+    result.resize(view.count);
+    switch (view.componentType) {
+    case 5126:
+        break;
+    case 5123:
+        widenVec3<std::uint16_t>(view, result);
+        return result;
+    case 5122:
+        widenVec3<std::int16_t>(view, result);
+        return result;
+    case 5121:
+        widenVec3<std::uint8_t>(view, result);
+        return result;
+    case 5120:
+        widenVec3<std::int8_t>(view, result);
+        return result;
+    default:
+        result.clear();
         return result;
     }
-    int componentSize = componentWidth(componentType);
-    int stride = view.value("byteStride").toInt(componentSize * elements);
-    int count = accessor.value("count").toInt();
-    int accessorOffset = accessor.value("byteOffset").toInt(0);
-    int viewOffset = view.value("byteOffset").toInt(0);
-    std::size_t base = static_cast<std::size_t>(viewOffset + accessorOffset);
-    result.reserve(static_cast<std::size_t>(count));
-    for (int i = 0; i < count; ++i) {
-        std::size_t offset = base + static_cast<std::size_t>(i * stride);
-        if (offset + 3 * componentSize > static_cast<std::size_t>(binary.size())) {
-            break;
-        }
-        float values[3];
-        std::memcpy(&values[0], binary.constData() + static_cast<int>(offset), sizeof(float));
-        std::memcpy(&values[1], binary.constData() + static_cast<int>(offset + componentSize), sizeof(float));
-        std::memcpy(&values[2], binary.constData() + static_cast<int>(offset + 2 * componentSize), sizeof(float));
-        result.emplace_back(values[0], values[1], values[2]);
+    if (view.stride == sizeof(Vector3)) {
+        std::memcpy(result.data(), view.data, view.count * sizeof(Vector3));
+    } else {
+        for (std::size_t i = 0; i < view.count; ++i) {
+            std::memcpy(&result[i], view.data + i * view.stride, sizeof(Vector3));
+        }
     }
     return result;
 }
 
+template <typename T>
+void widenIndices(const AccessorView& view, std::vector<std::uint32_t>& result)
+{
+    for (std::size_t i = 0; i < view.count; ++i) {
+        T value = 0;
+        std::memcpy(&value, view.data + i * view.stride, sizeof(T));
+        result[i] = static_cast<std::uint32_t>(value);
+    }
+}
+
 std::vector<std::uint32_t> readIndexAccessor(const QJsonArray& bufferViews,
                                              const QJsonArray& accessors,
                                              int accessorIndex,
-                                             const QByteArray& binary)
+                                             const std::vector<GltfBuffer>& buffers)
 {
     std::vector<std::uint32_t> result;
-    if (accessorIndex < 0 || accessorIndex >= accessors.size()) {
+    AccessorView view;
+    if (!resolveAccessor(bufferViews, accessors, accessorIndex, buffers, view) || view.elements != 1) {
         return result;
     }
-    QJsonObject accessor = accessors[accessorIndex].toObject();
-    int bufferViewIndex = accessor.value("bufferView").toInt(-1);
-    if (bufferViewIndex < 0 || bufferViewIndex >= bufferViews.size()) {
-        return result;
+    switch (view.componentType) {
+    case 5125:
+        result.resize(view.count);
+        if (view.stride == sizeof(std::uint32_t)) {
+            std::memcpy(result.data(), view.data, view.count * sizeof(std::uint32_t));
+        } else {
+            widenIndices<std::uint32_t>(view, result);
+        }
+        break;
+    case 5123:
+        result.resize(view.count);
+        widenIndices<std::uint16_t>(view, result);
+        break;
+    case 5121:
+        result.resize(view.count);
+        widenIndices<std::uint8_t>(view, result);
+        break;
+    default:
+        break;
     }
-    QJsonObject view = bufferViews[bufferViewIndex].toObject();
-    int componentType = accessor.value("componentType").toInt();
-    int componentSize = componentWidth(componentType);
-    int elements = typeElementCount(accessor.value("type").toString());
-    if (elements != 1 || componentSize == 0) {
-        return result;
+    return result;
+}
+
+// Splits a GLB container into its JSON text and optional binary chunk.
+bool readGlbContainer(const char* data, std::size_t size, QByteArray& json, GltfBuffer& binary)
+{
+    constexpr std::uint32_t kJsonChunk = 0x4E4F534A;
+    constexpr std::uint32_t kBinChunk = 0x004E4942;
+
+    std::uint32_t header[3];
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(header, data, sizeof(header));
+    if (header[1] != 2 || header[2] > size) {
+        return false;
     }
-    int stride = view.value("byteStride").toInt(componentSize * elements);
-    int count = accessor.value("count").toInt();
-    int accessorOffset = accessor.value("byteOffset").toInt(0);
-    int viewOffset = view.value("byteOffset").toInt(0);
-    std::size_t base = static_cast<std::size_t>(viewOffset + accessorOffset);
-    result.reserve(static_cast<std::size_t>(count));
-    for (int i = 0; i < count; ++i) {
-        std::size_t offset = base + static_cast<std::size_t>(i * stride);
-        if (offset + componentSize > static_cast<std::size_t>(binary.size())) {
-            break;
-        }
-        if (componentType == 5125) {
-            std::uint32_t value = 0;
-            std::memcpy(&value, binary.constData() + static_cast<int>(offset), sizeof(std::uint32_t));
-            result.push_back(value);
-        } else if (componentType == 5123) {
-            std::uint16_t value = 0;
-            std::memcpy(&value, binary.constData() + static_cast<int>(offset), sizeof(std::uint16_t));
-            result.push_back(static_cast<std::uint32_t>(value));
-        } else if (componentType == 5121) {
-            std::uint8_t value = 0;
-            std::memcpy(&value, binary.constData() + static_cast<int>(offset), sizeof(std::uint8_t));
-            result.push_back(static_cast<std::uint32_t>(value));
+    std::size_t cursor = sizeof(header);
+    const std::size_t end = header[2];
+    while (cursor + 8 <= end) {
+        std::uint32_t chunk[2];
+        std::memcpy(chunk, data + cursor, sizeof(chunk));
+        cursor += sizeof(chunk);
+        if (chunk[0] > end - cursor) {
+            return false;
+        }
+        if (chunk[1] == kJsonChunk && json.isNull()) {
+            json = QByteArray::fromRawData(data + cursor, static_cast<qsizetype>(chunk[0]));
+        } else if (chunk[1] == kBinChunk && !binary.data) {
+            binary.data = data + cursor;
+            binary.size = chunk[0];
         }
+        cursor += chunk[0];
     }
-    return result;
+    return !json.isNull();
 }
 
 std::array<float, 16> readMatrix(const QJsonObject& node)
@@ -637,27 +810,33 @@ std::array<float, 16> readMatrix(const QJsonObject& node)
     return matrix;
 }
 
-Vector3 applyTransform(const std::array<float, 16>& m, const Vector3& v)
-{
-    // Column-major 4x4 matrix multiplication
-    float x = m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12];
-    float y = m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13];
-    float z = m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14];
-    return Vector3(x, y, z);
-}
-
-bool parseGltf(const std::filesystem::path& path, std::vector<ImportedMesh>& meshes, std::string* error)
+bool parseGltf(const std::filesystem::path& path, ImportedScene& scene, std::string* error)
 {
-    QFile jsonFile(QString::fromStdString(path.string()));
-    if (!jsonFile.open(QIODevice::ReadOnly)) {
+    // Both the .gltf text and GLB containers are read through a mapping; the
+    // GLB binary chunk is then used in place as buffer 0.
+    GltfSources sources;
+    const GltfBuffer container = sources.map(QString::fromStdString(path.string()));
+    if (!container.data) {
         if (error) {
             *error = "Unable to open glTF file";
         }
         return false;
     }
+    QByteArray jsonText;
+    GltfBuffer glbBinary;
+    if (container.size >= 4 && std::memcmp(container.data, "glTF", 4) == 0) {
+        if (!readGlbContainer(container.data, container.size, jsonText, glbBinary)) {
+            if (error) {
+                *error = "Invalid GLB container";
+            }
+            return false;
+        }
+    } else {
+        jsonText = QByteArray::fromRawData(container.data, static_cast<qsizetype>(container.size));
+    }
+
     QJsonParseError parseError{};
-    QJsonDocument document = QJsonDocument::fromJson(jsonFile.readAll(), &parseError);
-    jsonFile.close();
+    QJsonDocument document = QJsonDocument::fromJson(jsonText, &parseError);
     if (parseError.error != QJsonParseError::NoError || document.isNull()) {
         if (error) {
             *error = "Failed to parse glTF JSON";
@@ -672,18 +851,33 @@ bool parseGltf(const std::filesystem::path& path, std::vector<ImportedMesh>& mes
         }
         return false;
     }
-    QString uri = buffers[0].toObject().value("uri").toString();
-    QFileInfo info(QString::fromStdString(path.string()));
-    QString binPath = info.dir().filePath(uri);
-    QFile binFile(binPath);
-    if (!binFile.open(QIODevice::ReadOnly)) {
-        if (error) {
-            *error = "Unable to open glTF buffer";
+
+    QDir baseDir = QFileInfo(QString::fromStdString(path.string())).dir();
+    for (int bufferIndex = 0; bufferIndex < buffers.size(); ++bufferIndex) {
+        QString uri = buffers[bufferIndex].toObject().value("uri").toString();
+        GltfBuffer buffer;
+        if (uri.isEmpty()) {
+            if (bufferIndex == 0) {
+                buffer = glbBinary;
+            }
+        } else if (uri.startsWith(QLatin1String("data:"))) {
+            int comma = uri.indexOf(QLatin1Char(','));
+            if (comma > 0 && uri.left(comma).endsWith(QLatin1String(";base64"))) {
+                sources.owned.push_back(QByteArray::fromBase64(uri.mid(comma + 1).toLatin1()));
+                buffer.data = sources.owned.back().constData();
+                buffer.size = static_cast<std::size_t>(sources.owned.back().size());
+            }
+        } else {
+            buffer = sources.map(baseDir.filePath(QUrl::fromPercentEncoding(uri.toUtf8())));
         }
-        return false;
+        if (!buffer.data) {
+            if (error) {
+                *error = "Unable to open glTF buffer";
+            }
+            return false;
+        }
+        sources.buffers.push_back(buffer);
     }
-    QByteArray binary = binFile.readAll();
-    binFile.close();
 
     QJsonArray bufferViews = root.value("bufferViews").toArray();
     QJsonArray accessors = root.value("accessors").toArray();
@@ -700,6 +894,16 @@ bool parseGltf(const std::filesystem::path& path, std::vector<ImportedMesh>& mes
 
     const auto identity = GeometryKernel::identityTransform();
 
+    // Walk the node graph first and only record where each mesh is placed, so
+    // meshes referenced by several nodes are decoded once.
+    struct Placement {
+        int mesh = -1;
+        QString name;
+        std::array<float, 16> transform;
+    };
+    std::vector<Placement> placements;
+    std::vector<int> referenceCounts(static_cast<std::size_t>(meshesArray.size()), 0);
+
     std::function<void(int, const std::array<float, 16>&)> processNode =
         [&](int nodeIndex, const std::array<float, 16>& parentTransform) {
             if (nodeIndex < 0 || nodeIndex >= nodes.size()) {
@@ -712,43 +916,10 @@ bool parseGltf(const std::filesystem::path& path, std::vector<ImportedMesh>& mes
             int meshIndex = nodeObj.value("mesh").toInt(-1);
             if (meshIndex >= 0 && meshIndex < meshesArray.size()) {
                 QJsonObject meshObj = meshesArray[meshIndex].toObject();
-                QJsonArray primitives = meshObj.value("primitives").toArray();
-                if (!primitives.isEmpty()) {
+                if (!meshObj.value("primitives").toArray().isEmpty()) {
                     QString baseName = nodeObj.value("name").toString(meshObj.value("name").toString(QStringLiteral("Mesh")));
-                    for (int primitiveIndex = 0; primitiveIndex < primitives.size(); ++primitiveIndex) {
-                        QJsonObject primitive = primitives[primitiveIndex].toObject();
-                        QJsonObject attributes = primitive.value("attributes").toObject();
-                        int positionAccessor = attributes.value("POSITION").toInt(-1);
-                        int indexAccessor = primitive.value("indices").toInt(-1);
-                        if (positionAccessor < 0 || indexAccessor < 0) {
-                            continue;
-                        }
-                        auto positions = readVec3Accessor(bufferViews, accessors, positionAccessor, binary);
-                        auto indices = readIndexAccessor(bufferViews, accessors, indexAccessor, binary);
-                        if (positions.empty() || indices.empty()) {
-                            continue;
-                        }
-                        ImportedMesh mesh;
-                        QString primitiveName = baseName;
-                        if (primitives.size() > 1) {
-                            primitiveName += QStringLiteral("_primitive%1").arg(primitiveIndex);
-                        }
-                        mesh.name = primitiveName.toStdString();
-                        mesh.positions = std::move(positions);
-                        mesh.indices = std::move(indices);
-                        mesh.transform = worldTransform;
-                        int materialIndex = primitive.value("material").toInt(-1);
-                        if (materialIndex >= 0 && materialIndex < materials.size()) {
-                            mesh.material = materials[materialIndex].toObject().value("name").toString().toStdString();
-                        }
-                        if (!isIdentityTransform(mesh.transform)) {
-                            for (auto& v : mesh.positions) {
-                                v = applyTransform(mesh.transform, v);
-                            }
-                            mesh.transform = identity;
-                        }
-                        meshes.push_back(std::move(mesh));
-                    }
+                    placements.push_back({ meshIndex, baseName, worldTransform });
+                    ++referenceCounts[static_cast<std::size_t>(meshIndex)];
                 }
             }
 
@@ -761,6 +932,41 @@ bool parseGltf(const std::filesystem::path& path, std::vector<ImportedMesh>& mes
             }
         };
 
+    // Decodes the primitives of one mesh in its local space.
+    auto decodeMesh = [&](int meshIndex, const QString& baseName) {
+        std::vector<ImportedMesh> parts;
+        QJsonArray primitives = meshesArray[meshIndex].toObject().value("primitives").toArray();
+        for (int primitiveIndex = 0; primitiveIndex < primitives.size(); ++primitiveIndex) {
+            QJsonObject primitive = primitives[primitiveIndex].toObject();
+            QJsonObject attributes = primitive.value("attributes").toObject();
+            int positionAccessor = attributes.value("POSITION").toInt(-1);
+            int indexAccessor = primitive.value("indices").toInt(-1);
+            if (positionAccessor < 0 || indexAccessor < 0) {
+                continue;
+            }
+            auto positions = readVec3Accessor(bufferViews, accessors, positionAccessor, sources.buffers);
+            auto indices = readIndexAccessor(bufferViews, accessors, indexAccessor, sources.buffers);
+            if (positions.empty() || indices.empty()) {
+                continue;
+            }
+            ImportedMesh mesh;
+            QString primitiveName = baseName;
+            if (primitives.size() > 1) {
+                primitiveName += QStringLiteral("_primitive%1").arg(primitiveIndex);
+            }
+            mesh.name = primitiveName.toStdString();
+            mesh.positions = std::move(positions);
+            mesh.indices = std::move(indices);
+            mesh.quantized = accessors[positionAccessor].toObject().value("componentType").toInt(5126) != 5126;
+            int materialIndex = primitive.value("material").toInt(-1);
+            if (materialIndex >= 0 && materialIndex < materials.size()) {
+                mesh.material = materials[materialIndex].toObject().value("name").toString().toStdString();
+            }
+            parts.push_back(std::move(mesh));
+        }
+        return parts;
+    };
+
     std::vector<int> rootNodes;
     QJsonArray scenes = root.value("scenes").toArray();
     int defaultScene = root.value("scene").toInt(-1);
@@ -783,7 +989,46 @@ bool parseGltf(const std::filesystem::path& path, std::vector<ImportedMesh>& mes
         processNode(rootIndex, identity);
     }
 
-    if (meshes.empty()) {
+    std::unordered_map<int, std::size_t> prototypeForMesh;
+    for (const Placement& placement : placements) {
+        // A placement the node transform cannot hold exactly gets its own
+        // baked copy of the mesh instead of an instance.
+        const bool exact = isExactTrs(placement.transform);
+        if (exact && referenceCounts[static_cast<std::size_t>(placement.mesh)] > 1) {
+            auto found = prototypeForMesh.find(placement.mesh);
+            if (found == prototypeForMesh.end()) {
+                QJsonObject meshObj = meshesArray[placement.mesh].toObject();
+                ImportedScene::Prototype prototype;
+                QString meshName = meshObj.value("name").toString(QStringLiteral("Mesh_%1").arg(placement.mesh));
+                prototype.name = meshName.toStdString();
+                prototype.parts = decodeMesh(placement.mesh, meshName);
+                if (prototype.parts.empty()) {
+                    continue;
+                }
+                found = prototypeForMesh.emplace(placement.mesh, scene.prototypes.size()).first;
+                scene.prototypes.push_back(std::move(prototype));
+            }
+            ImportedScene::Instance instance;
+            instance.prototype = found->second;
+            instance.name = placement.name.toStdString();
+            instance.transform = placement.transform;
+            scene.instances.push_back(std::move(instance));
+            continue;
+        }
+
+        for (ImportedMesh& mesh : decodeMesh(placement.mesh, placement.name)) {
+            // Quantised positions are baked too, so the solid holds real
+            // coordinates rather than raw integers scaled by its placement.
+            if (!exact || mesh.quantized) {
+                bakeTransform(mesh, placement.transform);
+            } else {
+                mesh.transform = placement.transform;
+            }
+            scene.meshes.push_back(std::move(mesh));
+        }
+    }
+
+    if (scene.meshes.empty() && scene.instances.empty()) {
         if (error) {
             *error = "glTF file did not contain primitives";
         }
@@ -792,62 +1037,117 @@ bool parseGltf(const std::filesystem::path& path, std::vector<ImportedMesh>& mes
     return true;
 }
 
-bool buildDocument(Scene::Document& document, std::vector<ImportedMesh>& meshes, std::string* error)
+GeometryObject* addImportedMesh(GeometryKernel& kernel, const ImportedMesh& mesh, std::string* error)
+{
+    HalfEdgeMesh halfEdge = GeometryKernel::meshFromIndexedData(mesh.positions, mesh.indices);
+    auto solidPtr = Solid::createFromMesh(std::move(halfEdge));
+    if (!solidPtr) {
+        if (error) {
+            *error = "Failed to reconstruct solid from mesh";
+        }
+        return nullptr;
+    }
+    GeometryObject* object = kernel.addObject(std::move(solidPtr));
+    if (!mesh.material.empty()) {
+        kernel.assignMaterial(object, mesh.material);
+    }
+    return object;
+}
+
+bool buildDocument(Scene::Document& document, ImportedScene& scene, std::vector<Scene::Document::ObjectId>* created,
+                   std::string* error)
 {
-    document.reset();
     auto& kernel = document.geometry();
-    for (auto& mesh : meshes) {
+    for (auto& mesh : scene.meshes) {
         if (mesh.positions.empty() || mesh.indices.size() < 3) {
             continue;
         }
-        HalfEdgeMesh halfEdge = GeometryKernel::meshFromIndexedData(mesh.positions, mesh.indices);
-        auto solidPtr = Solid::createFromMesh(std::move(halfEdge));
-        if (!solidPtr) {
-            if (error) {
-                *error = "Failed to reconstruct solid from mesh";
-            }
+        GeometryObject* object = addImportedMesh(kernel, mesh, error);
+        if (!object) {
             return false;
         }
-        GeometryObject* object = kernel.addObject(std::move(solidPtr));
-        if (!mesh.material.empty()) {
-            kernel.assignMaterial(object, mesh.material);
+        Scene::Document::ObjectId id = document.ensureObjectForGeometry(object, mesh.name);
+        if (!isIdentityTransform(mesh.transform)) {
+            document.setWorldTransform(id, mesh.transform);
+        }
+        if (created) {
+            created->push_back(id);
         }
-        document.ensureObjectForGeometry(object, mesh.name);
     }
-    document.synchronizeWithGeometry();
-    return true;
-}
 
-}
+    // Each prototype is added once, captured as a component definition and
+    // removed again; every placement then becomes an instance whose node
+    // transform positions it, so all instances keep sharing the mesh.
+    std::vector<Scene::Document::ComponentDefinitionId> definitions(scene.prototypes.size(), 0);
+    for (std::size_t i = 0; i < scene.prototypes.size(); ++i) {
+        const ImportedScene::Prototype& prototype = scene.prototypes[i];
+        std::vector<Scene::Document::ObjectId> sourceIds;
+        for (const ImportedMesh& part : prototype.parts) {
+            if (part.positions.empty() || part.indices.size() < 3) {
+                continue;
+            }
+            GeometryObject* object = addImportedMesh(kernel, part, error);
+            if (!object) {
+                return false;
+            }
+            sourceIds.push_back(document.ensureObjectForGeometry(object, part.name));
+        }
+        definitions[i] = document.createComponentDefinition(sourceIds, prototype.name);
+        document.removeObjects(sourceIds);
+    }
 
-bool isFormatAvailable(SceneFormat format)
-{
-    return isSceneFormatAvailable(format);
+    for (const ImportedScene::Instance& instance : scene.instances) {
+        Scene::Document::ComponentDefinitionId definitionId = definitions[instance.prototype];
+        if (definitionId == 0) {
+            continue;
+        }
+        Scene::Document::ObjectId instanceId = document.instantiateComponent(definitionId, instance.name);
+        const Scene::Document::ObjectNode* node = document.findObject(instanceId);
+        if (!node) {
+            continue;
+        }
+        if (!isIdentityTransform(instance.transform)) {
+            document.setWorldTransform(instanceId, instance.transform);
+        }
+        const ImportedScene::Prototype& prototype = scene.prototypes[instance.prototype];
+        std::size_t partIndex = 0;
+        for (const auto& child : node->children) {
+            if (!child->geometry) {
+                continue;
+            }
+            while (partIndex < prototype.parts.size() && prototype.parts[partIndex].indices.size() < 3) {
+                ++partIndex;
+            }
+            if (partIndex < prototype.parts.size() && !prototype.parts[partIndex].material.empty()) {
+                kernel.assignMaterial(child->geometry, prototype.parts[partIndex].material);
+            }
+            ++partIndex;
+        }
+        if (created) {
+            created->push_back(instanceId);
+        }
+    }
+
+    document.synchronizeWithGeometry();
+    return true;
 }
 
-bool importScene(Scene::Document& document, const std::string& filePath, SceneFormat format, std::string* errorMessage)
+bool parseScene(const std::filesystem::path& path, SceneFormat format, ImportedScene& scene, std::string* errorMessage)
 {
-    if (!isFormatAvailable(format)) {
+    if (!isSceneFormatAvailable(format)) {
         if (errorMessage) {
             *errorMessage = "Requested format is not available";
         }
         return false;
     }
 
-    std::filesystem::path path(filePath);
-    std::vector<ImportedMesh> meshes;
-
-    bool parsed = false;
     switch (format) {
     case SceneFormat::OBJ:
-        parsed = parseObj(path, meshes, errorMessage);
-        break;
+        return parseObj(path, scene.meshes, errorMessage);
     case SceneFormat::STL:
-        parsed = parseStl(path, meshes, errorMessage);
-        break;
+        return parseStl(path, scene.meshes, errorMessage);
     case SceneFormat::GLTF:
-        parsed = parseGltf(path, meshes, errorMessage);
-        break;
+        return parseGltf(path, scene, errorMessage);
     case SceneFormat::FBX:
     case SceneFormat::DAE:
         if (errorMessage) {
@@ -860,13 +1160,34 @@ bool importScene(Scene::Document& document, const std::string& filePath, SceneFo
         }
         return false;
     }
+    return false;
+}
 
-    if (!parsed) {
+}
+
+bool isFormatAvailable(SceneFormat format)
+{
+    return isSceneFormatAvailable(format);
+}
+
+bool importScene(Scene::Document& document, const std::string& filePath, SceneFormat format, std::string* errorMessage)
+{
+    ImportedScene scene;
+    if (!parseScene(std::filesystem::path(filePath), format, scene, errorMessage)) {
         return false;
     }
-
-    return buildDocument(document, meshes, errorMessage);
+    document.reset();
+    return buildDocument(document, scene, nullptr, errorMessage);
 }
 
+bool appendScene(Scene::Document& document, const std::string& filePath, SceneFormat format,
+                 std::vector<Scene::Document::ObjectId>* createdObjects, std::string* errorMessage)
+{
+    ImportedScene scene;
+    if (!parseScene(std::filesystem::path(filePath), format, scene, errorMessage)) {
+        return false;
+    }
+    return buildDocument(document, scene, createdObjects, errorMessage);
 }
 
+}
@@ -1,16 +1,21 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "FileIO/SceneIOFormat.h"
-
-namespace Scene {
-class Document;
-}
+#include "Scene/Document.h"
 
 namespace FileIO::Importers {
 
 bool isFormatAvailable(SceneFormat format);
 bool importScene(Scene::Document& document, const std::string& filePath, SceneFormat format, std::string* errorMessage = nullptr);
 
+// Like importScene but adds to the document instead of replacing it. Meshes
+// the file references from several nodes become one component definition with
+// an instance per node. Ids of the created top-level objects are appended to
+// createdObjects.
+bool appendScene(Scene::Document& document, const std::string& filePath, SceneFormat format,
+                 std::vector<Scene::Document::ObjectId>* createdObjects = nullptr, std::string* errorMessage = nullptr);
+
 }
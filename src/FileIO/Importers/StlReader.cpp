@@ -0,0 +1,133 @@
+#include "StlReader.h"
+
+#include <cstring>
+
+namespace FileIO::Importers {
+namespace {
+
+constexpr std::size_t kHeaderSize = 80;
+constexpr std::size_t kRecordSize = 50;
+
+std::uint32_t readCount(const char* data)
+{
+    std::uint32_t count = 0;
+    std::memcpy(&count, data + kHeaderSize, sizeof(count));
+    return count;
+}
+
+// Open-addressed map from exact vertex bits to the welded index. Slots hold
+// index + 1 so zero marks an empty slot; the table doubles at half load.
+class VertexWelder {
+public:
+    VertexWelder(std::vector<Vector3>& positions, std::size_t expected)
+        : positions(positions)
+    {
+        std::size_t capacity = 1024;
+        while (capacity < expected * 2)
+            capacity <<= 1;
+        slots.assign(capacity, 0);
+    }
+
+    std::uint32_t insert(const std::uint32_t bits[3])
+    {
+        if ((positions.size() + 1) * 2 > slots.size())
+            grow();
+        std::size_t slot = hash(bits) & (slots.size() - 1);
+        while (std::uint32_t entry = slots[slot]) {
+            if (sameBits(positions[entry - 1], bits))
+                return entry - 1;
+            slot = (slot + 1) & (slots.size() - 1);
+        }
+        Vector3 position;
+        std::memcpy(&position.x, &bits[0], sizeof(float));
+        std::memcpy(&position.y, &bits[1], sizeof(float));
+        std::memcpy(&position.z, &bits[2], sizeof(float));
+        positions.push_back(position);
+        slots[slot] = static_cast<std::uint32_t>(positions.size());
+        return static_cast<std::uint32_t>(positions.size() - 1);
+    }
+
+private:
+    static std::size_t hash(const std::uint32_t bits[3])
+    {
+        std::uint64_t h = bits[0] * 0x9E3779B97F4A7C15ull;
+        h ^= (h >> 29) ^ (bits[1] * 0xBF58476D1CE4E5B9ull);
+        h ^= (h >> 31) ^ (bits[2] * 0x94D049BB133111EBull);
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+
+    static bool sameBits(const Vector3& position, const std::uint32_t bits[3])
+    {
+        std::uint32_t stored[3];
+        std::memcpy(&stored[0], &position.x, sizeof(float));
+        std::memcpy(&stored[1], &position.y, sizeof(float));
+        std::memcpy(&stored[2], &position.z, sizeof(float));
+        return stored[0] == bits[0] && stored[1] == bits[1] && stored[2] == bits[2];
+    }
+
+    void grow()
+    {
+        std::vector<std::uint32_t> previous(slots.size() * 2, 0);
+        previous.swap(slots);
+        for (std::uint32_t entry : previous) {
+            if (!entry)
+                continue;
+            std::uint32_t bits[3];
+            const Vector3& position = positions[entry - 1];
+            std::memcpy(&bits[0], &position.x, sizeof(float));
+            std::memcpy(&bits[1], &position.y, sizeof(float));
+            std::memcpy(&bits[2], &position.z, sizeof(float));
+            std::size_t slot = hash(bits) & (slots.size() - 1);
+            while (slots[slot])
+                slot = (slot + 1) & (slots.size() - 1);
+            slots[slot] = entry;
+        }
+    }
+
+    std::vector<Vector3>& positions;
+    std::vector<std::uint32_t> slots;
+};
+
+} // namespace
+
+bool isBinaryStl(const char* data, std::size_t size)
+{
+    if (!data || size < kHeaderSize + sizeof(std::uint32_t))
+        return false;
+    return size == kHeaderSize + sizeof(std::uint32_t) + static_cast<std::size_t>(readCount(data)) * kRecordSize;
+}
+
+bool readBinaryStlBuffer(const char* data, std::size_t size, StlMesh& out)
+{
+    out = StlMesh{};
+    if (!data || size < kHeaderSize + sizeof(std::uint32_t))
+        return false;
+    const std::size_t triangleCount = readCount(data);
+    const char* record = data + kHeaderSize + sizeof(std::uint32_t);
+    if (static_cast<std::size_t>(data + size - record) / kRecordSize < triangleCount)
+        return false;
+
+    // Closed meshes have roughly half as many vertices as triangles.
+    VertexWelder welder(out.positions, triangleCount / 2 + 1);
+    out.positions.reserve(triangleCount / 2 + 1);
+    out.indices.reserve(triangleCount * 3);
+
+    for (std::size_t t = 0; t < triangleCount; ++t, record += kRecordSize) {
+        // Skip the 12-byte facet normal; vertex normals are recomputed.
+        std::uint32_t bits[9];
+        std::memcpy(bits, record + 12, sizeof(bits));
+        std::uint32_t corners[3];
+        for (int v = 0; v < 3; ++v) {
+            std::uint32_t* xyz = bits + v * 3;
+            for (int c = 0; c < 3; ++c) {
+                if (xyz[c] == 0x80000000u)
+                    xyz[c] = 0;
+            }
+            corners[v] = welder.insert(xyz);
+        }
+        out.indices.insert(out.indices.end(), corners, corners + 3);
+    }
+    return true;
+}
+
+}
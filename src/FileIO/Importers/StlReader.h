@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GeometryKernel/Vector3.h"
+
+namespace FileIO::Importers {
+
+// Indexed triangle soup produced by the binary STL reader.
+struct StlMesh {
+    std::vector<Vector3> positions;
+    std::vector<std::uint32_t> indices;
+};
+
+// True when the buffer has the exact size of a binary STL with the triangle
+// count stored in its header. Some exporters write "solid" into binary
+// headers, so this is more reliable than sniffing the first bytes.
+bool isBinaryStl(const char* data, std::size_t size);
+
+// Reads binary STL records straight from the buffer in a single pass. Corners
+// are welded when their coordinates have identical float bits (treating -0 as
+// 0). Every record yields one index triple, even if it collapses after
+// welding, so triangle counts still line up with the file. Fails if the
+// buffer is shorter than the header's triangle count requires.
+bool readBinaryStlBuffer(const char* data, std::size_t size, StlMesh& out);
+
+}
@@ -35,8 +35,8 @@
 #include "CameraNavigation.h"
 #include "GeometryKernel/Curve.h"
 #include "GeometryKernel/Solid.h"
-#include "GeometryKernel/Vector3.h"
 #include "GeometryKernel/TransformUtils.h"
+#include "GeometryKernel/Vector3.h"
 #include "Interaction/InferenceEngine.h"
 #include "SunModel.h"
 
@@ -971,37 +971,23 @@ Tool::ModifierState toModifierState(Qt::KeyboardModifiers mods)
     return state;
 }
 
-Vector3 applyGhostTransform(const Vector3& position, const Tool::PreviewGhost& ghost)
+// The ghost transform as a model matrix: scale and rotate about the pivot,
+// then translate.
+QMatrix4x4 ghostModelMatrix(const Tool::PreviewGhost& ghost)
 {
-    Vector3 result = position;
+    QMatrix4x4 model;
     const float eps = 1e-6f;
-
+    model.translate(toQt(ghost.translation));
     if (ghost.usePivot) {
-        Vector3 relative = result - ghost.pivot;
-        if (std::fabs(ghost.scale.x - 1.0f) > eps || std::fabs(ghost.scale.y - 1.0f) > eps || std::fabs(ghost.scale.z - 1.0f) > eps) {
-            relative.x *= ghost.scale.x;
-            relative.y *= ghost.scale.y;
-            relative.z *= ghost.scale.z;
-        }
-        if (std::fabs(ghost.rotationAngle) > eps && ghost.rotationAxis.lengthSquared() > eps) {
-            Vector3 scaled = ghost.pivot + relative;
-            result = GeometryTransforms::rotateAroundAxis(scaled, ghost.pivot, ghost.rotationAxis, ghost.rotationAngle);
-        } else {
-            result = ghost.pivot + relative;
-        }
+        model.translate(toQt(ghost.pivot));
+        if (std::fabs(ghost.rotationAngle) > eps && ghost.rotationAxis.lengthSquared() > eps)
+            model.rotate(qRadiansToDegrees(ghost.rotationAngle), toQt(ghost.rotationAxis));
+        model.scale(toQt(ghost.scale));
+        model.translate(-toQt(ghost.pivot));
     } else {
-        if (std::fabs(ghost.scale.x - 1.0f) > eps || std::fabs(ghost.scale.y - 1.0f) > eps || std::fabs(ghost.scale.z - 1.0f) > eps) {
-            result.x *= ghost.scale.x;
-            result.y *= ghost.scale.y;
-            result.z *= ghost.scale.z;
-        }
-    }
-
-    if (ghost.translation.lengthSquared() > eps) {
-        result += ghost.translation;
+        model.scale(toQt(ghost.scale));
     }
-
-    return result;
+    return model;
 }
 
 float luminance(const QVector4D& color)
@@ -1016,6 +1002,13 @@ QVector4D grayscaleWithRange(const QVector4D& color, float minValue, float maxVa
     return QVector4D(tone, tone, tone, color.w());
 }
 
+// World position of an object-space point; a no-op for unplaced objects.
+QVector3D placedPosition(const GeometryObject& object, const Vector3& point)
+{
+    return toQt(object.isPlaced() ? GeometryTransforms::transformPoint(object.placement(), point) : point);
+}
+
+
 void drawCurve(Renderer& renderer,
                const Curve& curve,
                bool selected,
@@ -1030,7 +1023,7 @@ void drawCurve(Renderer& renderer,
     std::vector<QVector3D> positions;
     positions.reserve(pts.size());
     for (const auto& p : pts) {
-        positions.push_back(toQt(p));
+        positions.push_back(placedPosition(curve, p));
     }
     QVector4D color;
     float width = selected ? 3.0f : 2.0f;
@@ -1072,6 +1065,7 @@ void drawSolid(Renderer& renderer,
     const HalfEdgeMesh& mesh = solid.getMesh();
     const auto& vertices = mesh.getVertices();
     const auto& triangles = mesh.getTriangles();
+    const GeometryTransforms::Matrix4 normals = GeometryTransforms::normalMatrix(solid.placement());
 
     QVector4D fillColor = selected ? palette.fillSelected : palette.fill;
     if (style == Renderer::RenderStyle::Monochrome) {
@@ -1089,11 +1083,12 @@ void drawSolid(Renderer& renderer,
                 tri.v2 >= static_cast<int>(vertices.size())) {
                 continue;
             }
-            QVector3D normal = toQt(tri.normal);
+            QVector3D normal = toQt(solid.isPlaced() ? GeometryTransforms::transformDirection(normals, tri.normal).normalized()
+                                                     : tri.normal);
             renderer.addTriangle(
-                toQt(vertices[(size_t)tri.v0].position),
-                toQt(vertices[(size_t)tri.v1].position),
-                toQt(vertices[(size_t)tri.v2].position),
+                placedPosition(solid, vertices[(size_t)tri.v0].position),
+                placedPosition(solid, vertices[(size_t)tri.v1].position),
+                placedPosition(solid, vertices[(size_t)tri.v2].position),
                 normal,
                 fillColor);
         }
@@ -1121,7 +1116,7 @@ void drawSolid(Renderer& renderer,
                 positions.clear();
                 break;
             }
-            positions.push_back(toQt(vertices[(size_t)idx].position));
+            positions.push_back(placedPosition(solid, vertices[(size_t)idx].position));
         }
         if (positions.size() < 2) {
             continue;
@@ -1155,30 +1150,16 @@ void drawSolid(Renderer& renderer,
     }
 }
 
-void drawGhostCurve(Renderer& renderer,
-                    const Curve& curve,
-                    const Tool::PreviewGhost& ghost,
-                    const PalettePreferences::ColorSet& palette)
+void appendGhostCurveOutline(const Curve& curve, std::vector<QVector3D>& segments)
 {
     const auto& pts = curve.getBoundaryLoop();
-    if (pts.size() < 2) {
-        return;
-    }
-    std::vector<QVector3D> positions;
-    positions.reserve(pts.size());
-    for (const auto& p : pts) {
-        Vector3 transformed = applyGhostTransform(p, ghost);
-        positions.push_back(toQt(transformed));
+    for (size_t i = 1; i < pts.size(); ++i) {
+        segments.push_back(toQt(pts[i - 1]));
+        segments.push_back(toQt(pts[i]));
     }
-    QVector4D ghostColor = palette.highlight;
-    ghostColor.setW(kGhostAlpha);
-    renderer.addLineStrip(positions, ghostColor, 2.4f, false, true, true);
 }
 
-void drawGhostSolid(Renderer& renderer,
-                    const Solid& solid,
-                    const Tool::PreviewGhost& ghost,
-                    const PalettePreferences::ColorSet& palette)
+void appendGhostSolidOutline(const Solid& solid, std::vector<QVector3D>& segments)
 {
     const HalfEdgeMesh& mesh = solid.getMesh();
     const auto& vertices = mesh.getVertices();
@@ -1189,23 +1170,20 @@ void drawGhostSolid(Renderer& renderer,
         if (loop.size() < 2) {
             continue;
         }
-        std::vector<QVector3D> positions;
-        positions.reserve(loop.size());
         bool valid = true;
         for (int idx : loop) {
             if (idx < 0 || idx >= static_cast<int>(vertices.size())) {
                 valid = false;
                 break;
             }
-            Vector3 transformed = applyGhostTransform(vertices[(size_t)idx].position, ghost);
-            positions.push_back(toQt(transformed));
         }
-        if (!valid || positions.size() < 2) {
+        if (!valid) {
             continue;
         }
-        QVector4D ghostColor = palette.highlight;
-        ghostColor.setW(kGhostAlpha);
-        renderer.addLineStrip(positions, ghostColor, 2.0f, true, true, true);
+        for (size_t i = 0; i < loop.size(); ++i) {
+            segments.push_back(toQt(vertices[(size_t)loop[i]].position));
+            segments.push_back(toQt(vertices[(size_t)loop[(i + 1) % loop.size()]].position));
+        }
     }
 }
 
@@ -1515,16 +1493,41 @@ void GLViewport::drawSceneOverlays()
         }
     }
 
+    if (preview.ghosts.empty()) {
+        ghostOutlines.clear();
+    }
+    QVector4D ghostColor = paletteColors.highlight;
+    ghostColor.setW(kGhostAlpha);
     for (const auto& ghost : preview.ghosts) {
         if (!ghost.object) {
             continue;
         }
-        if (ghost.object->getType() == ObjectType::Curve) {
-            drawGhostCurve(renderer, *static_cast<const Curve*>(ghost.object), ghost, paletteColors);
-        } else if (ghost.object->getType() == ObjectType::Solid) {
-            drawGhostSolid(renderer, *static_cast<const Solid*>(ghost.object), ghost, paletteColors);
+        const std::vector<QVector3D>& outline = ghostOutline(*ghost.object);
+        const float width = ghost.object->getType() == ObjectType::Curve ? 2.4f : 2.0f;
+        QMatrix4x4 model = ghostModelMatrix(ghost);
+        if (ghost.object->isPlaced()) {
+            // The outline is in object space; placement() is column-major.
+            model *= QMatrix4x4(ghost.object->placement().data()).transposed();
+        }
+        renderer.setModelTransform(model);
+        renderer.addLineSegments(outline, ghostColor, width, true, true);
+    }
+    renderer.resetModelTransform();
+}
+
+const std::vector<QVector3D>& GLViewport::ghostOutline(const GeometryObject& object)
+{
+    GhostOutline& outline = ghostOutlines[&object];
+    if (outline.revision != object.contentRevision() || outline.segments.empty()) {
+        outline.revision = object.contentRevision();
+        outline.segments.clear();
+        if (object.getType() == ObjectType::Curve) {
+            appendGhostCurveOutline(static_cast<const Curve&>(object), outline.segments);
+        } else if (object.getType() == ObjectType::Solid) {
+            appendGhostSolidOutline(static_cast<const Solid&>(object), outline.segments);
         }
     }
+    return outline.segments;
 }
 
 std::pair<float, float> GLViewport::depthRangeForAspect(float aspect) const
@@ -1994,10 +1997,11 @@ bool GLViewport::computeBounds(bool selectedOnly, bool includeHidden, Vector3& o
         if (!includeHidden && object->isHidden()) {
             continue;
         }
-        const HalfEdgeMesh& mesh = object->getMesh();
+        const HalfEdgeMesh& mesh = static_cast<const GeometryObject&>(*object).getMesh();
         const auto& vertices = mesh.getVertices();
         for (const auto& vertex : vertices) {
-            const Vector3& p = vertex.position;
+            const Vector3 p = object->isPlaced() ? GeometryTransforms::transformPoint(object->placement(), vertex.position)
+                                                 : vertex.position;
             if (!hasBounds) {
                 outMin = p;
                 outMax = p;
@@ -31,6 +31,8 @@
 
 #include <optional>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 class ToolManager;
 class Tool;
@@ -144,6 +146,7 @@ private:
     void drawHorizonBand();
     void drawSceneGeometry();
     void drawSceneOverlays();
+    const std::vector<QVector3D>& ghostOutline(const GeometryObject& object);
     void initializeRawDebugTriangle();
     void drawRawDebugTriangle();
     QMatrix4x4 buildProjectionMatrix(float aspect) const;
@@ -199,6 +202,13 @@ private:
     int lastDrawCalls = 0;
     mutable int currentDrawCalls = 0;
     Renderer renderer;
+    // Untransformed edge segments of the objects a tool is previewing, kept
+    // for the length of a drag; the renderer applies the drag transform.
+    struct GhostOutline {
+        std::uint64_t revision = 0;
+        std::vector<QVector3D> segments;
+    };
+    std::unordered_map<const GeometryObject*, GhostOutline> ghostOutlines;
     Renderer::RenderStyle renderStyle = Renderer::RenderStyle::ShadedWithEdges;
     bool showHiddenGeometry = false;
     bool gridVisible = true;
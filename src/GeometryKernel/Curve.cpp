@@ -140,6 +140,7 @@ std::unique_ptr<Curve> Curve::createFromPoints(const std::vector<Vector3>& pts,
 
 bool Curve::rebuildFromPoints(const std::vector<Vector3>& pts, const std::vector<bool>& edgeHardness)
 {
+    touch();
     auto sanitized = sanitizePoints(pts);
     if (sanitized.size() < 2)
         return false;
@@ -195,8 +196,27 @@ std::unique_ptr<GeometryObject> Curve::clone() const
     return copy;
 }
 
+bool Curve::assignContent(const GeometryObject& source)
+{
+    if (source.getType() != ObjectType::Curve)
+        return false;
+    const auto& curve = static_cast<const Curve&>(source);
+    touch();
+    boundaryLoop = curve.boundaryLoop;
+    mesh = curve.mesh;
+    hardnessFlags = curve.hardnessFlags;
+    return true;
+}
+
+std::size_t Curve::memoryFootprint() const
+{
+    return sizeof(Curve) + boundaryLoop.capacity() * sizeof(Vector3) + hardnessFlags.capacity() / 8
+        + mesh.memoryFootprint();
+}
+
 void Curve::applyTransform(const std::function<Vector3(const Vector3&)>& fn)
 {
+    touch();
     for (auto& point : boundaryLoop) {
         point = fn(point);
     }
@@ -205,6 +225,7 @@ void Curve::applyTransform(const std::function<Vector3(const Vector3&)>& fn)
 
 void Curve::setEdgeHardness(std::vector<bool> hardness)
 {
+    touch();
     if (hardness.empty()) {
         hardnessFlags.assign(boundaryLoop.size(), false);
         return;
@@ -215,6 +236,7 @@ void Curve::setEdgeHardness(std::vector<bool> hardness)
 
 void Curve::tagAllEdgesHard(bool hard)
 {
+    touch();
     hardnessFlags.assign(boundaryLoop.size(), hard);
 }
 
@@ -21,8 +21,10 @@ public:
 
     ObjectType getType() const override { return ObjectType::Curve; }
     const HalfEdgeMesh& getMesh() const override { return mesh; }
-    HalfEdgeMesh& getMesh() override { return mesh; }
+    HalfEdgeMesh& getMesh() override { touch(); return mesh; }
     std::unique_ptr<GeometryObject> clone() const override;
+    bool assignContent(const GeometryObject& source) override;
+    std::size_t memoryFootprint() const override;
 
     const std::vector<Vector3>& getBoundaryLoop() const { return boundaryLoop; }
     const std::vector<bool>& getEdgeHardness() const { return hardnessFlags; }
@@ -6,7 +6,9 @@
 #include <fstream>
 #include <limits>
 #include <string>
+#include <unordered_set>
 
+#include "MeshOptimizer.h"
 #include "MeshUtils.h"
 
 namespace {
@@ -25,9 +27,7 @@ GeometryObject* GeometryKernel::addCurve(const std::vector<Vector3>& points) {
     if (!obj) {
         return nullptr;
     }
-    GeometryObject* raw = obj.get();
-    assignStableId(*raw);
-    objects.push_back(std::move(obj));
+    GeometryObject* raw = appendObject(std::move(obj));
     markModified();
     return raw;
 }
@@ -46,9 +46,7 @@ GeometryObject* GeometryKernel::extrudeCurve(GeometryObject* curveObj, float hei
     if (!obj) {
         return nullptr;
     }
-    GeometryObject* raw = obj.get();
-    assignStableId(*raw);
-    objects.push_back(std::move(obj));
+    GeometryObject* raw = appendObject(std::move(obj));
     markModified();
     return raw;
 }
@@ -76,7 +74,7 @@ GeometryObject* GeometryKernel::extrudeCurveAlongVector(GeometryObject* curveObj
         return nullptr;
 
     ExtrudeOptions effective = options;
-    bool hasFace = !curve->getMesh().getFaces().empty();
+    bool hasFace = !static_cast<const Curve*>(curve)->getMesh().getFaces().empty();
     if (!hasFace) {
         effective.capStart = false;
         effective.capEnd = false;
@@ -86,9 +84,7 @@ GeometryObject* GeometryKernel::extrudeCurveAlongVector(GeometryObject* curveObj
     if (!obj) {
         return nullptr;
     }
-    GeometryObject* raw = obj.get();
-    assignStableId(*raw);
-    objects.push_back(std::move(obj));
+    GeometryObject* raw = appendObject(std::move(obj));
     markModified();
     return raw;
 }
@@ -97,9 +93,7 @@ GeometryObject* GeometryKernel::addObject(std::unique_ptr<GeometryObject> object
 {
     if (!object)
         return nullptr;
-    GeometryObject* raw = object.get();
-    assignStableId(*raw);
-    objects.push_back(std::move(object));
+    GeometryObject* raw = appendObject(std::move(object));
     markModified();
     return raw;
 }
@@ -109,9 +103,7 @@ GeometryObject* GeometryKernel::cloneObject(const GeometryObject& source)
     auto clone = source.clone();
     if (!clone)
         return nullptr;
-    GeometryObject* raw = clone.get();
-    assignStableId(*raw);
-    objects.push_back(std::move(clone));
+    GeometryObject* raw = appendObject(std::move(clone));
     GeometryObject::StableId sourceId = source.getStableId();
     GeometryObject::StableId cloneId = raw->getStableId();
     if (sourceId != 0 && cloneId != 0) {
@@ -128,21 +120,105 @@ GeometryObject* GeometryKernel::cloneObject(const GeometryObject& source)
     return raw;
 }
 
-void GeometryKernel::deleteObject(GeometryObject* obj) {
-    if (!obj) return;
-    GeometryObject::StableId id = obj->getStableId();
-    if (id != 0) {
+void GeometryKernel::adoptObjects(GeometryKernel& source)
+{
+    if (&source == this || source.objects.empty())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(source.optimizedMeshes.mutex);
+        source.optimizedMeshes.entries.clear();
+    }
+    objects.reserve(objects.size() + source.objects.size());
+    for (auto& object : source.objects) {
+        if (!object)
+            continue;
+        const GeometryObject::StableId sourceId = object->getStableId();
+        object->setStableId(0);
+        const GeometryObject::StableId id = appendObject(std::move(object))->getStableId();
+        auto materialIt = source.materialAssignments.find(sourceId);
+        if (materialIt != source.materialAssignments.end())
+            materialAssignments[id] = std::move(materialIt->second);
+        auto metaIt = source.metadataMap.find(sourceId);
+        if (metaIt != source.metadataMap.end())
+            metadataMap[id] = std::move(metaIt->second);
+    }
+    source.objects.clear();
+    source.slots.clear();
+    source.materialAssignments.clear();
+    source.metadataMap.clear();
+    source.markModified();
+    markModified();
+}
+
+GeometryObject* GeometryKernel::findObject(GeometryObject::StableId id) const
+{
+    auto it = slots.find(id);
+    if (it == slots.end() || objects[it->second]->getStableId() != id)
+        return nullptr;
+    return objects[it->second].get();
+}
+
+void GeometryKernel::deleteObject(GeometryObject* obj)
+{
+    if (obj)
+        deleteObjects({ obj });
+}
+
+void GeometryKernel::deleteObjects(const std::vector<GeometryObject*>& targets)
+{
+    {
+        std::lock_guard<std::mutex> lock(optimizedMeshes.mutex);
+        for (GeometryObject* obj : targets)
+            optimizedMeshes.entries.erase(obj);
+    }
+
+    // Leave a tombstone in each slot, then close the gaps in one pass so the
+    // survivors keep their creation order. A repeated target is skipped: its
+    // first visit has already freed it.
+    bool removed = false;
+    std::unordered_set<const GeometryObject*> visited;
+    visited.reserve(targets.size());
+    for (GeometryObject* obj : targets) {
+        if (!visited.insert(obj).second)
+            continue;
+        const std::size_t slot = slotOf(obj);
+        if (slot == objects.size())
+            continue;
+        const GeometryObject::StableId id = obj->getStableId();
         materialAssignments.erase(id);
         metadataMap.erase(id);
+        if (auto it = slots.find(id); it != slots.end() && it->second == slot)
+            slots.erase(it);
+        // Deleted objects leave the selection of whoever is observing it.
+        obj->setSelected(false);
+        objects[slot].reset();
+        removed = true;
     }
-    for (auto it = objects.begin(); it != objects.end(); ++it) {
-        if (it->get() == obj) { objects.erase(it); markModified(); return; }
+    if (!removed)
+        return;
+
+    std::size_t write = 0;
+    for (std::size_t read = 0; read < objects.size(); ++read) {
+        if (!objects[read])
+            continue;
+        if (write != read) {
+            objects[write] = std::move(objects[read]);
+            slots[objects[write]->getStableId()] = write;
+        }
+        ++write;
     }
+    objects.resize(write);
+    markModified();
 }
 
 void GeometryKernel::clear()
 {
+    {
+        std::lock_guard<std::mutex> lock(optimizedMeshes.mutex);
+        optimizedMeshes.entries.clear();
+    }
     objects.clear();
+    slots.clear();
     materialAssignments.clear();
     metadataMap.clear();
     textAnnotations.clear();
@@ -196,15 +272,13 @@ bool GeometryKernel::loadFromFile(const std::string& filename) {
         if (type == "Curve") {
             auto c = GeometryIO::readCurve(is);
             if (c) {
-                assignStableId(*c);
-                objects.push_back(std::move(c));
+                appendObject(std::move(c));
                 changed = true;
             }
         } else if (type == "Solid") {
             auto s = GeometryIO::readSolid(is);
             if (s) {
-                assignStableId(*s);
-                objects.push_back(std::move(s));
+                appendObject(std::move(s));
                 changed = true;
             }
         } else {
@@ -228,15 +302,13 @@ void GeometryKernel::loadFromStream(std::istream& is, const std::string& termina
         if (type == "Curve") {
             auto curve = GeometryIO::readCurve(is);
             if (curve) {
-                assignStableId(*curve);
-                objects.push_back(std::move(curve));
+                appendObject(std::move(curve));
                 changed = true;
             }
         } else if (type == "Solid") {
             auto solid = GeometryIO::readSolid(is);
             if (solid) {
-                assignStableId(*solid);
-                objects.push_back(std::move(solid));
+                appendObject(std::move(solid));
                 changed = true;
             }
         } else {
@@ -512,6 +584,37 @@ GeometryKernel::MeshBuffer GeometryKernel::buildMeshBuffer(const GeometryObject&
     return buffer;
 }
 
+std::shared_ptr<const GeometryKernel::MeshBuffer> GeometryKernel::optimizedMeshBuffer(const GeometryObject& object) const
+{
+    const std::uint64_t revision = object.contentRevision();
+    {
+        std::lock_guard<std::mutex> lock(optimizedMeshes.mutex);
+        auto it = optimizedMeshes.entries.find(&object);
+        if (it != optimizedMeshes.entries.end() && it->second.revision == revision)
+            return it->second.buffer;
+    }
+
+    // Build outside the lock so other objects can be optimised concurrently.
+    auto buffer = std::make_shared<MeshBuffer>(buildMeshBuffer(object));
+    optimizeMeshBuffer(*buffer);
+
+    std::lock_guard<std::mutex> lock(optimizedMeshes.mutex);
+    auto& entry = optimizedMeshes.entries[&object];
+    entry.revision = revision;
+    entry.buffer = buffer;
+    return buffer;
+}
+
+void GeometryKernel::optimizeMeshBuffer(MeshBuffer& buffer)
+{
+    if (buffer.indices.empty())
+        return;
+    buffer.indices = MeshOptimizer::optimizeVertexCache(buffer.indices, buffer.positions.size());
+    const auto remap = MeshOptimizer::optimizeVertexFetch(buffer.indices, buffer.positions.size());
+    MeshOptimizer::remapVertices(buffer.positions, remap);
+    MeshOptimizer::remapVertices(buffer.normals, remap);
+}
+
 std::array<float, 16> GeometryKernel::identityTransform()
 {
     return { 1.0f, 0.0f, 0.0f, 0.0f,
@@ -524,23 +627,11 @@ HalfEdgeMesh GeometryKernel::meshFromIndexedData(const std::vector<Vector3>& pos
                                                  const std::vector<std::uint32_t>& indices)
 {
     HalfEdgeMesh mesh;
+    mesh.getVertices().reserve(positions.size());
     for (const auto& pos : positions) {
         mesh.addVertex(pos);
     }
-    for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
-        std::uint32_t i0 = indices[i];
-        std::uint32_t i1 = indices[i + 1];
-        std::uint32_t i2 = indices[i + 2];
-        if (i0 >= positions.size() || i1 >= positions.size() || i2 >= positions.size()) {
-            continue;
-        }
-        std::vector<int> face = {
-            static_cast<int>(i0),
-            static_cast<int>(i1),
-            static_cast<int>(i2)
-        };
-        mesh.addFace(face);
-    }
+    mesh.addTriangles(indices);
     mesh.heal();
     return mesh;
 }
@@ -579,6 +670,31 @@ void GeometryKernel::resetAxes()
     markModified();
 }
 
+GeometryObject* GeometryKernel::appendObject(std::unique_ptr<GeometryObject> object)
+{
+    GeometryObject* raw = object.get();
+    const GeometryObject::StableId id = assignStableId(*raw);
+    slots[id] = objects.size();
+    objects.push_back(std::move(object));
+    return raw;
+}
+
+std::size_t GeometryKernel::slotOf(const GeometryObject* object) const
+{
+    if (!object)
+        return objects.size();
+    auto it = slots.find(object->getStableId());
+    if (it != slots.end() && objects[it->second].get() == object)
+        return it->second;
+    // The id was rewritten after the object was added, or is shared with
+    // another object; fall back to a scan.
+    for (std::size_t slot = 0; slot < objects.size(); ++slot) {
+        if (objects[slot].get() == object)
+            return slot;
+    }
+    return objects.size();
+}
+
 GeometryObject::StableId GeometryKernel::assignStableId(GeometryObject& object)
 {
     GeometryObject::StableId id = object.getStableId();
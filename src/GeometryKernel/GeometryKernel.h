@@ -4,9 +4,11 @@
 #include <cstdint>
 #include <iosfwd>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include "GeometryObject.h"
 #include "Curve.h"
@@ -29,7 +31,18 @@ public:
         const ExtrudeOptions& options);
     GeometryObject* addObject(std::unique_ptr<GeometryObject> object);
     GeometryObject* cloneObject(const GeometryObject& source);
+    // Moves every object of source into this kernel under fresh stable ids,
+    // with its material and shape metadata. Object addresses do not change.
+    // Annotations, dimensions, guides and axes stay with source.
+    void adoptObjects(GeometryKernel& source);
+    // Deleting removes the object from the slot index in constant time, but
+    // closing the gap moves every later slot; delete many objects with one
+    // deleteObjects() call rather than a loop.
     void deleteObject(GeometryObject* obj);
+    // Deletes all targets with a single compaction pass. Null and unknown
+    // pointers are ignored. The remaining objects keep their order.
+    void deleteObjects(const std::vector<GeometryObject*>& targets);
+    GeometryObject* findObject(GeometryObject::StableId id) const;
     void clear();
     bool saveToFile(const std::string& filename) const;
     bool loadFromFile(const std::string& filename);
@@ -151,15 +164,44 @@ public:
     };
 
     MeshBuffer buildMeshBuffer(const GeometryObject& object) const;
+    // buildMeshBuffer() with triangles reordered for the post-transform vertex
+    // cache and vertices renumbered in first-use order. The result is cached per
+    // object until its contentRevision() changes. Safe to call from several
+    // threads.
+    std::shared_ptr<const MeshBuffer> optimizedMeshBuffer(const GeometryObject& object) const;
+    // The reordering optimizedMeshBuffer() applies, for buffers built elsewhere.
+    static void optimizeMeshBuffer(MeshBuffer& buffer);
     static std::array<float, 16> identityTransform();
     static HalfEdgeMesh meshFromIndexedData(const std::vector<Vector3>& positions,
                                            const std::vector<std::uint32_t>& indices);
 
 private:
+    struct OptimizedMeshCache {
+        struct Entry {
+            std::uint64_t revision = 0;
+            std::shared_ptr<const MeshBuffer> buffer;
+        };
+
+        OptimizedMeshCache() = default;
+        OptimizedMeshCache(OptimizedMeshCache&& other) noexcept : entries(std::move(other.entries)) {}
+        OptimizedMeshCache& operator=(OptimizedMeshCache&& other) noexcept
+        {
+            entries = std::move(other.entries);
+            return *this;
+        }
+
+        std::mutex mutex;
+        std::unordered_map<const GeometryObject*, Entry> entries;
+    };
+
     void markModified();
+    GeometryObject* appendObject(std::unique_ptr<GeometryObject> object);
+    // Slot of object in objects, or objects.size() if it is not held here.
+    std::size_t slotOf(const GeometryObject* object) const;
     GeometryObject::StableId assignStableId(GeometryObject& object);
 
     std::vector<std::unique_ptr<GeometryObject>> objects;
+    std::unordered_map<GeometryObject::StableId, std::size_t> slots;
     std::unordered_map<GeometryObject::StableId, std::string> materialAssignments;
     std::unordered_map<GeometryObject::StableId, ShapeMetadata> metadataMap;
     std::vector<TextAnnotation> textAnnotations;
@@ -168,4 +210,5 @@ private:
     AxesState axes;
     std::uint64_t revisionCounter = 0;
     GeometryObject::StableId nextStableId = 1;
+    mutable OptimizedMeshCache optimizedMeshes;
 };
@@ -1,9 +1,13 @@
 #pragma once
 #include "Vector3.h"
 #include "HalfEdgeMesh.h"
+#include "TransformUtils.h"
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 enum class ObjectType { Curve, Solid };
 
@@ -11,22 +15,94 @@ class GeometryObject {
 public:
     using StableId = std::uint64_t;
 
+    // Told about every change made through setSelected(). Document uses it to
+    // keep its selection set current; clone() does not copy it.
+    class SelectionObserver {
+    public:
+        virtual void selectionChanged(GeometryObject& object, bool selected) = 0;
+
+    protected:
+        ~SelectionObserver() = default;
+    };
+
     virtual ~GeometryObject() = default;
     virtual ObjectType getType() const = 0;
     virtual const HalfEdgeMesh& getMesh() const = 0;
     virtual HalfEdgeMesh& getMesh() = 0;
+    // Clones share mesh storage with the original until either is modified.
     virtual std::unique_ptr<GeometryObject> clone() const = 0;
-    void setStableId(StableId id) { stableId = id; }
+    // Replaces the geometry with that of source, sharing its mesh storage as
+    // clone() does. Returns false and changes nothing if the types differ.
+    virtual bool assignContent(const GeometryObject& source) = 0;
+    // Approximate heap and object bytes; see HalfEdgeMesh::memoryFootprint().
+    virtual std::size_t memoryFootprint() const = 0;
+    void setStableId(StableId id) { stableId = id; touch(); }
     StableId getStableId() const { return stableId; }
-    void setSelected(bool sel) { selected = sel; }
+    // Process-wide unique value that changes whenever the object's geometry may
+    // have changed, so equal revisions imply identical content.
+    std::uint64_t contentRevision() const { return revision; }
+    void setSelected(bool sel)
+    {
+        if (selected == sel)
+            return;
+        selected = sel;
+        if (selectionObserver)
+            selectionObserver->selectionChanged(*this, sel);
+    }
     bool isSelected() const { return selected; }
     void setVisible(bool vis) { visible = vis; }
     bool isVisible() const { return visible; }
     void setHidden(bool hiddenState) { hidden = hiddenState; }
     bool isHidden() const { return hidden; }
+    void setSelectionObserver(SelectionObserver* observer) { selectionObserver = observer; }
+    // Object-to-world matrix. Mesh positions are in object space; Document
+    // composes this from the transforms of the object's node and its parents.
+    // It is not part of the content, so changing it leaves contentRevision()
+    // alone and clone() does not copy it.
+    const GeometryTransforms::Matrix4& placement() const { return placementMatrix; }
+    bool isPlaced() const { return placed; }
+    void setPlacement(const GeometryTransforms::Matrix4& matrix)
+    {
+        if (matrix == placementMatrix)
+            return;
+        placementMatrix = matrix;
+        placed = !GeometryTransforms::isIdentity(matrix);
+        placementStamp = nextRevision();
+    }
+    // Changes whenever placement() does.
+    std::uint64_t placementRevision() const { return placementStamp; }
+    // Maps object-space points, such as mesh positions, to world space.
+    Vector3 toWorld(const Vector3& point) const
+    {
+        return placed ? GeometryTransforms::transformPoint(placementMatrix, point) : point;
+    }
+    std::vector<Vector3> toWorld(std::vector<Vector3> points) const
+    {
+        if (placed) {
+            for (auto& point : points)
+                point = GeometryTransforms::transformPoint(placementMatrix, point);
+        }
+        return points;
+    }
+protected:
+    // Call from every path that can modify geometry. Handing out a mutable mesh
+    // counts, so read-only callers should go through a const reference.
+    void touch() { revision = nextRevision(); }
+
 private:
+    static std::uint64_t nextRevision()
+    {
+        static std::atomic<std::uint64_t> counter{ 0 };
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
     StableId stableId = 0;
+    std::uint64_t revision = nextRevision();
+    GeometryTransforms::Matrix4 placementMatrix = GeometryTransforms::identityMatrix();
+    std::uint64_t placementStamp = 0;
+    bool placed = false;
     bool selected = false;
     bool visible = true;
     bool hidden = false;
+    SelectionObserver* selectionObserver = nullptr;
 };
@@ -16,7 +16,8 @@ inline long long makeUndirectedKey(int a, int b) {
 
 int HalfEdgeMesh::addVertex(const Vector3& position, const Vector3& normal, const Vector2& uv, bool hasNormal, bool hasUV)
 {
-    int index = static_cast<int>(vertices.size());
+    Buffers& d = writable();
+    int index = static_cast<int>(d.vertices.size());
     HalfEdgeVertex vertex;
     vertex.position = position;
     vertex.normal = normal;
@@ -24,18 +25,19 @@ int HalfEdgeMesh::addVertex(const Vector3& position, const Vector3& normal, cons
     vertex.hasNormal = hasNormal;
     vertex.hasUV = hasUV;
     vertex.halfEdge = -1;
-    vertices.push_back(vertex);
+    d.vertices.push_back(vertex);
     return index;
 }
 
 int HalfEdgeMesh::addFace(const std::vector<int>& loop) {
     if (loop.size() < 3) return -1;
-    int faceIndex = static_cast<int>(faces.size());
+    Buffers& d = writable();
+    int faceIndex = static_cast<int>(d.faces.size());
     HalfEdgeFace face;
-    face.halfEdge = static_cast<int>(halfEdges.size());
-    faces.push_back(face);
+    face.halfEdge = static_cast<int>(d.halfEdges.size());
+    d.faces.push_back(face);
 
-    size_t start = halfEdges.size();
+    size_t start = d.halfEdges.size();
     size_t count = loop.size();
     std::vector<std::pair<int, int>> touchedVertices;
     std::vector<std::pair<int, int>> updatedOpposites;
@@ -52,42 +54,42 @@ int HalfEdgeMesh::addFace(const std::vector<int>& loop) {
         record.destination = destination;
         record.face = faceIndex;
         record.next = static_cast<int>(start + (i + 1) % count);
-        halfEdges.push_back(record);
-        int previous = vertices[origin].halfEdge;
+        d.halfEdges.push_back(record);
+        int previous = d.vertices[origin].halfEdge;
         if (previous == -1) {
             touchedVertices.emplace_back(origin, previous);
-            vertices[origin].halfEdge = static_cast<int>(halfEdges.size() - 1);
+            d.vertices[origin].halfEdge = static_cast<int>(d.halfEdges.size() - 1);
         }
         long long key = makeEdgeKey(origin, destination);
-        auto it = directedEdgeMap.find(key);
-        if (it != directedEdgeMap.end()) {
+        auto it = d.directedEdgeMap.find(key);
+        if (it != d.directedEdgeMap.end()) {
             // rollback and reject face
             for (const auto& tv : touchedVertices) {
-                vertices[tv.first].halfEdge = tv.second;
+                d.vertices[tv.first].halfEdge = tv.second;
             }
             for (const auto& oppEntry : updatedOpposites) {
-                halfEdges[oppEntry.first].opposite = oppEntry.second;
+                d.halfEdges[oppEntry.first].opposite = oppEntry.second;
             }
-            halfEdges.resize(start);
-            faces.pop_back();
+            d.halfEdges.resize(start);
+            d.faces.pop_back();
             for (long long inserted : insertedKeys) {
-                directedEdgeMap.erase(inserted);
+                d.directedEdgeMap.erase(inserted);
             }
             return -1;
         }
-        directedEdgeMap[key] = static_cast<int>(halfEdges.size() - 1);
+        d.directedEdgeMap[key] = static_cast<int>(d.halfEdges.size() - 1);
         insertedKeys.push_back(key);
         long long oppositeKey = makeEdgeKey(destination, origin);
-        auto opp = directedEdgeMap.find(oppositeKey);
-        if (opp != directedEdgeMap.end()) {
-            int previousOpp = halfEdges[opp->second].opposite;
+        auto opp = d.directedEdgeMap.find(oppositeKey);
+        if (opp != d.directedEdgeMap.end()) {
+            int previousOpp = d.halfEdges[opp->second].opposite;
             updatedOpposites.emplace_back(opp->second, previousOpp);
-            halfEdges[opp->second].opposite = static_cast<int>(halfEdges.size() - 1);
-            halfEdges.back().opposite = opp->second;
+            d.halfEdges[opp->second].opposite = static_cast<int>(d.halfEdges.size() - 1);
+            d.halfEdges.back().opposite = opp->second;
         }
     }
 
-    faces.back().normal = computeFaceNormal(loop);
+    d.faces.back().normal = computeFaceNormal(loop);
 
     // triangulate face using simple fan
     if (loop.size() >= 3) {
@@ -96,49 +98,108 @@ int HalfEdgeMesh::addFace(const std::vector<int>& loop) {
             tri.v0 = loop[0];
             tri.v1 = loop[i];
             tri.v2 = loop[i + 1];
-            tri.normal = faces.back().normal;
-            triangles.push_back(tri);
+            tri.normal = d.faces.back().normal;
+            d.triangles.push_back(tri);
         }
     }
 
     return faceIndex;
 }
 
+std::size_t HalfEdgeMesh::addTriangles(const std::vector<std::uint32_t>& indices)
+{
+    Buffers& d = writable();
+    const std::size_t triangleCount = indices.size() / 3;
+    d.halfEdges.reserve(d.halfEdges.size() + triangleCount * 3);
+    d.faces.reserve(d.faces.size() + triangleCount);
+    d.triangles.reserve(d.triangles.size() + triangleCount);
+    d.directedEdgeMap.reserve(d.directedEdgeMap.size() + triangleCount * 3);
+
+    const std::size_t vertexCount = d.vertices.size();
+    std::size_t added = 0;
+    for (std::size_t t = 0; t < triangleCount; ++t) {
+        const std::uint32_t* corner = &indices[t * 3];
+        if (corner[0] >= vertexCount || corner[1] >= vertexCount || corner[2] >= vertexCount)
+            continue;
+        const int loop[3] = { static_cast<int>(corner[0]), static_cast<int>(corner[1]), static_cast<int>(corner[2]) };
+        if (loop[0] == loop[1] || loop[1] == loop[2] || loop[0] == loop[2])
+            continue;
+        const long long keys[3] = { makeEdgeKey(loop[0], loop[1]), makeEdgeKey(loop[1], loop[2]),
+                                    makeEdgeKey(loop[2], loop[0]) };
+        if (d.directedEdgeMap.count(keys[0]) || d.directedEdgeMap.count(keys[1]) || d.directedEdgeMap.count(keys[2]))
+            continue;
+
+        const int faceIndex = static_cast<int>(d.faces.size());
+        const int start = static_cast<int>(d.halfEdges.size());
+        for (int i = 0; i < 3; ++i) {
+            HalfEdgeRecord record;
+            record.origin = loop[i];
+            record.destination = loop[(i + 1) % 3];
+            record.face = faceIndex;
+            record.next = start + (i + 1) % 3;
+            const int edgeIndex = start + i;
+            auto opp = d.directedEdgeMap.find(makeEdgeKey(record.destination, record.origin));
+            if (opp != d.directedEdgeMap.end()) {
+                record.opposite = opp->second;
+                d.halfEdges[opp->second].opposite = edgeIndex;
+            }
+            d.halfEdges.push_back(record);
+            d.directedEdgeMap.emplace(keys[i], edgeIndex);
+            if (d.vertices[loop[i]].halfEdge == -1)
+                d.vertices[loop[i]].halfEdge = edgeIndex;
+        }
+
+        const Vector3& a = d.vertices[loop[0]].position;
+        HalfEdgeFace face;
+        face.halfEdge = start;
+        face.normal = (d.vertices[loop[1]].position - a).cross(d.vertices[loop[2]].position - a).normalized();
+        d.faces.push_back(face);
+
+        HalfEdgeTriangle tri;
+        tri.v0 = loop[0];
+        tri.v1 = loop[1];
+        tri.v2 = loop[2];
+        tri.normal = face.normal;
+        d.triangles.push_back(tri);
+        ++added;
+    }
+    return added;
+}
+
 void HalfEdgeMesh::clear() {
-    vertices.clear();
-    halfEdges.clear();
-    faces.clear();
-    triangles.clear();
-    directedEdgeMap.clear();
+    buffers.reset();
 }
 
 void HalfEdgeMesh::setVertexNormal(int index, const Vector3& normal)
 {
-    if (index < 0 || static_cast<std::size_t>(index) >= vertices.size())
+    if (index < 0 || static_cast<std::size_t>(index) >= data().vertices.size())
         return;
-    vertices[static_cast<std::size_t>(index)].normal = normal;
-    vertices[static_cast<std::size_t>(index)].hasNormal = true;
+    Buffers& d = writable();
+    d.vertices[static_cast<std::size_t>(index)].normal = normal;
+    d.vertices[static_cast<std::size_t>(index)].hasNormal = true;
 }
 
 void HalfEdgeMesh::setVertexUV(int index, const Vector2& uv)
 {
-    if (index < 0 || static_cast<std::size_t>(index) >= vertices.size())
+    if (index < 0 || static_cast<std::size_t>(index) >= data().vertices.size())
         return;
-    vertices[static_cast<std::size_t>(index)].uv = uv;
-    vertices[static_cast<std::size_t>(index)].hasUV = true;
+    Buffers& d = writable();
+    d.vertices[static_cast<std::size_t>(index)].uv = uv;
+    d.vertices[static_cast<std::size_t>(index)].hasUV = true;
 }
 
 bool HalfEdgeMesh::isManifold() const {
+    const Buffers& d = data();
     std::unordered_map<long long, int> undirectedCounts;
-    for (size_t i = 0; i < halfEdges.size(); ++i) {
-        const auto& edge = halfEdges[i];
+    for (size_t i = 0; i < d.halfEdges.size(); ++i) {
+        const auto& edge = d.halfEdges[i];
         if (edge.origin < 0 || edge.destination < 0) continue;
         long long key = makeUndirectedKey(edge.origin, edge.destination);
         int count = ++undirectedCounts[key];
         if (count > 2) return false;
         if (count == 2) {
             if (edge.opposite == -1) return false;
-            const auto& opp = halfEdges[edge.opposite];
+            const auto& opp = d.halfEdges[edge.opposite];
             if (opp.opposite != static_cast<int>(i)) return false;
         }
     }
@@ -146,11 +207,12 @@ bool HalfEdgeMesh::isManifold() const {
 }
 
 Vector3 HalfEdgeMesh::computeFaceNormal(const std::vector<int>& loop) const {
+    const Buffers& d = data();
     Vector3 normal(0.0f, 0.0f, 0.0f);
     if (loop.size() < 3) return normal;
     for (size_t i = 0; i < loop.size(); ++i) {
-        const Vector3& current = vertices[loop[i]].position;
-        const Vector3& next = vertices[loop[(i + 1) % loop.size()]].position;
+        const Vector3& current = d.vertices[loop[i]].position;
+        const Vector3& next = d.vertices[loop[(i + 1) % loop.size()]].position;
         normal.x += (current.y - next.y) * (current.z + next.z);
         normal.y += (current.z - next.z) * (current.x + next.x);
         normal.z += (current.x - next.x) * (current.y + next.y);
@@ -160,7 +222,8 @@ Vector3 HalfEdgeMesh::computeFaceNormal(const std::vector<int>& loop) const {
 
 void HalfEdgeMesh::recomputeNormals()
 {
-    for (auto& face : faces) {
+    Buffers& d = writable();
+    for (auto& face : d.faces) {
         if (face.halfEdge < 0) {
             face.normal = Vector3();
             continue;
@@ -170,11 +233,11 @@ void HalfEdgeMesh::recomputeNormals()
         int current = start;
         loop.clear();
         do {
-            if (current < 0 || current >= static_cast<int>(halfEdges.size())) {
+            if (current < 0 || current >= static_cast<int>(d.halfEdges.size())) {
                 loop.clear();
                 break;
             }
-            const HalfEdgeRecord& edge = halfEdges[current];
+            const HalfEdgeRecord& edge = d.halfEdges[current];
             loop.push_back(edge.origin);
             current = edge.next;
         } while (current != start && current != -1);
@@ -185,14 +248,14 @@ void HalfEdgeMesh::recomputeNormals()
         }
     }
 
-    for (auto& tri : triangles) {
+    for (auto& tri : d.triangles) {
         if (tri.v0 < 0 || tri.v1 < 0 || tri.v2 < 0) {
             tri.normal = Vector3();
             continue;
         }
-        const Vector3& a = vertices[tri.v0].position;
-        const Vector3& b = vertices[tri.v1].position;
-        const Vector3& c = vertices[tri.v2].position;
+        const Vector3& a = d.vertices[tri.v0].position;
+        const Vector3& b = d.vertices[tri.v1].position;
+        const Vector3& c = d.vertices[tri.v2].position;
         Vector3 normal = (b - a).cross(c - a);
         if (normal.lengthSquared() > 1e-8f) {
             tri.normal = normal.normalized();
@@ -201,18 +264,18 @@ void HalfEdgeMesh::recomputeNormals()
         }
     }
 
-    std::vector<Vector3> accum(vertices.size(), Vector3());
-    std::vector<int> counts(vertices.size(), 0);
-    for (const auto& tri : triangles) {
+    std::vector<Vector3> accum(d.vertices.size(), Vector3());
+    std::vector<int> counts(d.vertices.size(), 0);
+    for (const auto& tri : d.triangles) {
         if (tri.v0 < 0 || tri.v1 < 0 || tri.v2 < 0)
             continue;
         const Vector3& n = tri.normal;
         if (n.lengthSquared() <= 1e-8f)
             continue;
         auto accumulate = [&](int idx) {
-            if (idx < 0 || static_cast<std::size_t>(idx) >= vertices.size())
+            if (idx < 0 || static_cast<std::size_t>(idx) >= d.vertices.size())
                 return;
-            if (vertices[idx].hasNormal)
+            if (d.vertices[idx].hasNormal)
                 return;
             accum[idx] += n;
             counts[idx] += 1;
@@ -222,48 +285,49 @@ void HalfEdgeMesh::recomputeNormals()
         accumulate(tri.v2);
     }
 
-    for (std::size_t i = 0; i < vertices.size(); ++i) {
-        if (vertices[i].hasNormal)
+    for (std::size_t i = 0; i < d.vertices.size(); ++i) {
+        if (d.vertices[i].hasNormal)
             continue;
         if (counts[i] == 0) {
-            vertices[i].normal = Vector3();
+            d.vertices[i].normal = Vector3();
             continue;
         }
         Vector3 n = accum[i];
         float lengthSq = n.lengthSquared();
         if (lengthSq > 1e-8f) {
-            vertices[i].normal = n / std::sqrt(lengthSq);
-            vertices[i].hasNormal = true;
+            d.vertices[i].normal = n / std::sqrt(lengthSq);
+            d.vertices[i].hasNormal = true;
         }
     }
 }
 
 void HalfEdgeMesh::heal(float weldTolerance, float minEdgeLength)
 {
-    if (vertices.empty() || faces.empty()) {
+    if (data().vertices.empty() || data().faces.empty()) {
         return;
     }
+    Buffers& d = writable();
 
     float weldSq = weldTolerance * weldTolerance;
     float minEdgeSq = minEdgeLength * minEdgeLength;
 
     std::vector<HalfEdgeVertex> uniqueVertices;
-    uniqueVertices.reserve(vertices.size());
-    std::vector<int> remap(vertices.size(), -1);
+    uniqueVertices.reserve(d.vertices.size());
+    std::vector<int> remap(d.vertices.size(), -1);
 
-    for (std::size_t i = 0; i < vertices.size(); ++i) {
-        const Vector3& position = vertices[i].position;
+    for (std::size_t i = 0; i < d.vertices.size(); ++i) {
+        const Vector3& position = d.vertices[i].position;
         bool merged = false;
         for (std::size_t j = 0; j < uniqueVertices.size(); ++j) {
             Vector3 delta = uniqueVertices[j].position - position;
             if (delta.lengthSquared() <= weldSq) {
                 remap[i] = static_cast<int>(j);
-                if (vertices[i].hasNormal && !uniqueVertices[j].hasNormal) {
-                    uniqueVertices[j].normal = vertices[i].normal;
+                if (d.vertices[i].hasNormal && !uniqueVertices[j].hasNormal) {
+                    uniqueVertices[j].normal = d.vertices[i].normal;
                     uniqueVertices[j].hasNormal = true;
                 }
-                if (vertices[i].hasUV && !uniqueVertices[j].hasUV) {
-                    uniqueVertices[j].uv = vertices[i].uv;
+                if (d.vertices[i].hasUV && !uniqueVertices[j].hasUV) {
+                    uniqueVertices[j].uv = d.vertices[i].uv;
                     uniqueVertices[j].hasUV = true;
                 }
                 merged = true;
@@ -274,11 +338,11 @@ void HalfEdgeMesh::heal(float weldTolerance, float minEdgeLength)
             remap[i] = static_cast<int>(uniqueVertices.size());
             HalfEdgeVertex v;
             v.position = position;
-            v.normal = vertices[i].normal;
-            v.uv = vertices[i].uv;
-            v.hasNormal = vertices[i].hasNormal;
-            v.hasUV = vertices[i].hasUV;
-            v.halfEdge = vertices[i].halfEdge;
+            v.normal = d.vertices[i].normal;
+            v.uv = d.vertices[i].uv;
+            v.hasNormal = d.vertices[i].hasNormal;
+            v.hasUV = d.vertices[i].hasUV;
+            v.halfEdge = d.vertices[i].halfEdge;
             uniqueVertices.push_back(v);
         }
     }
@@ -291,9 +355,9 @@ void HalfEdgeMesh::heal(float weldTolerance, float minEdgeLength)
     };
 
     std::vector<std::vector<int>> rebuiltFaces;
-    rebuiltFaces.reserve(faces.size());
+    rebuiltFaces.reserve(d.faces.size());
 
-    for (const auto& face : faces) {
+    for (const auto& face : d.faces) {
         if (face.halfEdge < 0) {
             continue;
         }
@@ -302,15 +366,15 @@ void HalfEdgeMesh::heal(float weldTolerance, float minEdgeLength)
         int current = start;
         std::size_t guard = 0;
         while (current != -1) {
-            if (guard++ > halfEdges.size()) {
+            if (guard++ > d.halfEdges.size()) {
                 loop.clear();
                 break;
             }
-            if (current < 0 || current >= static_cast<int>(halfEdges.size())) {
+            if (current < 0 || current >= static_cast<int>(d.halfEdges.size())) {
                 loop.clear();
                 break;
             }
-            const HalfEdgeRecord& edge = halfEdges[current];
+            const HalfEdgeRecord& edge = d.halfEdges[current];
             if (edge.origin < 0 || edge.origin >= static_cast<int>(remap.size())) {
                 loop.clear();
                 break;
@@ -369,14 +433,14 @@ void HalfEdgeMesh::heal(float weldTolerance, float minEdgeLength)
         }
     }
 
-    vertices = uniqueVertices;
-    for (auto& vertex : vertices) {
+    d.vertices = uniqueVertices;
+    for (auto& vertex : d.vertices) {
         vertex.halfEdge = -1;
     }
-    halfEdges.clear();
-    faces.clear();
-    triangles.clear();
-    directedEdgeMap.clear();
+    d.halfEdges.clear();
+    d.faces.clear();
+    d.triangles.clear();
+    d.directedEdgeMap.clear();
 
     for (const auto& loop : rebuiltFaces) {
         addFace(loop);
@@ -384,3 +448,32 @@ void HalfEdgeMesh::heal(float weldTolerance, float minEdgeLength)
 
     recomputeNormals();
 }
+
+const HalfEdgeMesh::Buffers& HalfEdgeMesh::data() const
+{
+    static const Buffers empty;
+    return buffers ? *buffers : empty;
+}
+
+HalfEdgeMesh::Buffers& HalfEdgeMesh::writable()
+{
+    if (!buffers)
+        buffers = std::make_shared<Buffers>();
+    else if (buffers.use_count() > 1)
+        buffers = std::make_shared<Buffers>(*buffers);
+    return *buffers;
+}
+
+std::size_t HalfEdgeMesh::memoryFootprint() const
+{
+    if (!buffers)
+        return 0;
+    const Buffers& d = *buffers;
+    // Node-based map: one allocation per entry plus the bucket array.
+    const std::size_t mapBytes = d.directedEdgeMap.size() * (sizeof(std::pair<const long long, int>) + 2 * sizeof(void*))
+        + d.directedEdgeMap.bucket_count() * sizeof(void*);
+    const std::size_t bytes = sizeof(Buffers) + d.vertices.capacity() * sizeof(HalfEdgeVertex)
+        + d.halfEdges.capacity() * sizeof(HalfEdgeRecord) + d.faces.capacity() * sizeof(HalfEdgeFace)
+        + d.triangles.capacity() * sizeof(HalfEdgeTriangle) + mapBytes;
+    return bytes / static_cast<std::size_t>(std::max<long>(buffers.use_count(), 1));
+}
@@ -1,4 +1,7 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 #include "Vector3.h"
@@ -33,29 +36,37 @@ struct HalfEdgeTriangle {
     Vector3 normal;
 };
 
+// Copies of a mesh share one set of buffers until either side is modified,
+// so copying a mesh (and cloning the object that owns it) is O(1). Every
+// non-const member, including the non-const getVertices(), takes a private
+// copy first if the buffers are shared.
 class HalfEdgeMesh {
 public:
     int addVertex(const Vector3& position, const Vector3& normal = Vector3(), const Vector2& uv = Vector2(),
                   bool hasNormal = false, bool hasUV = false);
     int addFace(const std::vector<int>& loop);
+    // Bulk form of addFace for indexed triangle lists (three indices per face).
+    // Triangles that repeat or reference a missing vertex, or that would reuse
+    // an existing directed edge, are skipped. Returns the number of faces added.
+    std::size_t addTriangles(const std::vector<std::uint32_t>& indices);
     void clear();
 
     bool isManifold() const;
 
-    const std::vector<HalfEdgeVertex>& getVertices() const { return vertices; }
-    std::vector<HalfEdgeVertex>& getVertices() { return vertices; }
+    const std::vector<HalfEdgeVertex>& getVertices() const { return data().vertices; }
+    std::vector<HalfEdgeVertex>& getVertices() { return writable().vertices; }
 
     void setVertexNormal(int index, const Vector3& normal);
     void setVertexUV(int index, const Vector2& uv);
 
-    const std::vector<HalfEdgeRecord>& getHalfEdges() const { return halfEdges; }
-    const std::vector<HalfEdgeFace>& getFaces() const { return faces; }
-    const std::vector<HalfEdgeTriangle>& getTriangles() const { return triangles; }
+    const std::vector<HalfEdgeRecord>& getHalfEdges() const { return data().halfEdges; }
+    const std::vector<HalfEdgeFace>& getFaces() const { return data().faces; }
+    const std::vector<HalfEdgeTriangle>& getTriangles() const { return data().triangles; }
 
     template <typename Fn>
     void transformVertices(const Fn& fn)
     {
-        for (auto& vertex : vertices) {
+        for (auto& vertex : writable().vertices) {
             vertex.position = fn(vertex.position);
         }
         recomputeNormals();
@@ -64,12 +75,23 @@ public:
     void recomputeNormals();
     void heal(float weldTolerance = 1e-5f, float minEdgeLength = 1e-5f);
 
+    bool sharesStorageWith(const HalfEdgeMesh& other) const { return buffers && buffers == other.buffers; }
+    // Bytes held by the buffers. Shared buffers are split evenly between the
+    // meshes that hold them, so summing over meshes does not double count.
+    std::size_t memoryFootprint() const;
+
 private:
+    struct Buffers {
+        std::vector<HalfEdgeVertex> vertices;
+        std::vector<HalfEdgeRecord> halfEdges;
+        std::vector<HalfEdgeFace> faces;
+        std::vector<HalfEdgeTriangle> triangles;
+        std::unordered_map<long long, int> directedEdgeMap;
+    };
+
+    const Buffers& data() const;
+    Buffers& writable();
     Vector3 computeFaceNormal(const std::vector<int>& loop) const;
 
-    std::vector<HalfEdgeVertex> vertices;
-    std::vector<HalfEdgeRecord> halfEdges;
-    std::vector<HalfEdgeFace> faces;
-    std::vector<HalfEdgeTriangle> triangles;
-    std::unordered_map<long long, int> directedEdgeMap;
+    std::shared_ptr<Buffers> buffers;
 };
@@ -0,0 +1,136 @@
+#include "MeshOptimizer.h"
+
+namespace MeshOptimizer {
+namespace {
+
+// Triangles around each vertex, stored as one flat list with offsets.
+struct VertexAdjacency {
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> triangles;
+
+    VertexAdjacency(const std::vector<std::uint32_t>& indices, std::size_t vertexCount)
+        : offsets(vertexCount + 1, 0)
+        , triangles(indices.size())
+    {
+        for (std::uint32_t v : indices)
+            ++offsets[v + 1];
+        for (std::size_t v = 0; v < vertexCount; ++v)
+            offsets[v + 1] += offsets[v];
+        std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < indices.size(); ++i)
+            triangles[fill[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+    }
+};
+
+} // namespace
+
+std::vector<std::uint32_t> optimizeVertexCache(const std::vector<std::uint32_t>& indices,
+                                               std::size_t vertexCount,
+                                               unsigned cacheSize)
+{
+    const std::size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0)
+        return indices;
+
+    const VertexAdjacency adjacency(indices, vertexCount);
+    std::vector<std::uint32_t> live(vertexCount, 0);
+    for (std::size_t v = 0; v < vertexCount; ++v)
+        live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+    // A vertex is in the cache while time - cacheTime[v] <= cacheSize.
+    std::vector<std::uint64_t> cacheTime(vertexCount, 0);
+    std::uint64_t time = cacheSize + 1;
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<std::uint32_t> deadEnd;
+    std::vector<std::uint32_t> candidates;
+
+    std::vector<std::uint32_t> result;
+    result.reserve(triangleCount * 3);
+
+    std::size_t cursor = 0;
+    auto nextUnfinished = [&]() -> long long {
+        while (!deadEnd.empty()) {
+            const std::uint32_t v = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[v] > 0)
+                return v;
+        }
+        for (; cursor < vertexCount; ++cursor) {
+            if (live[cursor] > 0)
+                return static_cast<long long>(cursor);
+        }
+        return -1;
+    };
+
+    long long fan = nextUnfinished();
+    while (fan >= 0) {
+        candidates.clear();
+        const std::uint32_t f = static_cast<std::uint32_t>(fan);
+        for (std::uint32_t i = adjacency.offsets[f]; i < adjacency.offsets[f + 1]; ++i) {
+            const std::uint32_t t = adjacency.triangles[i];
+            if (emitted[t])
+                continue;
+            emitted[t] = true;
+            for (int corner = 0; corner < 3; ++corner) {
+                const std::uint32_t v = indices[t * 3 + corner];
+                result.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                if (time - cacheTime[v] > cacheSize)
+                    cacheTime[v] = time++;
+            }
+        }
+
+        // Prefer the candidate that entered the cache earliest but will still
+        // be cached after its remaining triangles are emitted.
+        long long best = -1;
+        long long bestPriority = -1;
+        for (std::uint32_t v : candidates) {
+            if (live[v] == 0)
+                continue;
+            long long priority = 0;
+            if (time - cacheTime[v] + 2 * static_cast<std::uint64_t>(live[v]) <= cacheSize)
+                priority = static_cast<long long>(time - cacheTime[v]);
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                best = v;
+            }
+        }
+        fan = best >= 0 ? best : nextUnfinished();
+    }
+    return result;
+}
+
+std::vector<std::uint32_t> optimizeVertexFetch(std::vector<std::uint32_t>& indices, std::size_t vertexCount)
+{
+    std::vector<std::uint32_t> remap(vertexCount, kUnusedVertex);
+    std::uint32_t next = 0;
+    for (std::uint32_t& index : indices) {
+        std::uint32_t& target = remap[index];
+        if (target == kUnusedVertex)
+            target = next++;
+        index = target;
+    }
+    return remap;
+}
+
+double averageCacheMissRatio(const std::vector<std::uint32_t>& indices, std::size_t vertexCount, unsigned cacheSize)
+{
+    const std::size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return 0.0;
+    // FIFO: a vertex stays cached until cacheSize newer misses have happened.
+    std::vector<std::uint64_t> insertedAt(vertexCount, 0);
+    std::uint64_t misses = 0;
+    for (std::size_t i = 0; i < triangleCount * 3; ++i) {
+        const std::uint32_t v = indices[i];
+        if (insertedAt[v] == 0 || misses - insertedAt[v] >= cacheSize) {
+            ++misses;
+            insertedAt[v] = misses;
+        }
+    }
+    return static_cast<double>(misses) / static_cast<double>(triangleCount);
+}
+
+}
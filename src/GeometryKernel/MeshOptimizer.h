@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Index and vertex reordering for triangle lists. All functions expect a
+// triangle list (three indices per triangle) whose indices are below
+// vertexCount.
+namespace MeshOptimizer {
+
+constexpr unsigned kDefaultCacheSize = 16;
+constexpr std::uint32_t kUnusedVertex = 0xFFFFFFFFu;
+
+// Reorders triangles for a post-transform vertex cache of cacheSize entries
+// using Tipsify (Sander, Nehab and Barczak 2007). Runs in linear time; the
+// triangle set and winding are unchanged.
+std::vector<std::uint32_t> optimizeVertexCache(const std::vector<std::uint32_t>& indices,
+                                               std::size_t vertexCount,
+                                               unsigned cacheSize = kDefaultCacheSize);
+
+// Renumbers vertices in the order the index buffer first uses them, which
+// makes vertex fetches sequential and the attribute streams compress better.
+// Rewrites indices in place and returns the old-to-new map; vertices no
+// triangle uses map to kUnusedVertex and are dropped by remapVertices().
+std::vector<std::uint32_t> optimizeVertexFetch(std::vector<std::uint32_t>& indices, std::size_t vertexCount);
+
+template <typename T>
+void remapVertices(std::vector<T>& values, const std::vector<std::uint32_t>& remap)
+{
+    std::size_t kept = 0;
+    for (std::uint32_t target : remap) {
+        if (target != kUnusedVertex)
+            ++kept;
+    }
+    std::vector<T> result(kept);
+    for (std::size_t i = 0; i < remap.size() && i < values.size(); ++i) {
+        if (remap[i] != kUnusedVertex)
+            result[remap[i]] = values[i];
+    }
+    values.swap(result);
+}
+
+// Average cache miss ratio: vertex transforms per triangle with a FIFO cache
+// of cacheSize entries. 3.0 is the worst case; 0.5 to 0.7 is typical of well
+// ordered closed meshes.
+double averageCacheMissRatio(const std::vector<std::uint32_t>& indices,
+                             std::size_t vertexCount,
+                             unsigned cacheSize = kDefaultCacheSize);
+
+}
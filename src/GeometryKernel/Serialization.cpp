@@ -1,9 +1,16 @@
 #include "Serialization.h"
 #include "Curve.h"
 #include "Solid.h"
+#include "HalfEdgeMesh.h"
+#include "Vector2.h"
+#include "../Core/Parallel.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <vector>
 #include <ostream>
 #include <istream>
+#include <string>
 
 namespace GeometryIO {
 
@@ -42,3 +49,300 @@ std::unique_ptr<Solid> readSolid(std::istream& is) {
 }
 
 } // namespace
+
+namespace {
+
+constexpr std::uint8_t kChunkCurve = 1;
+constexpr std::uint8_t kChunkSolid = 2;
+constexpr std::uint8_t kVertexHasNormal = 0x1;
+constexpr std::uint8_t kVertexHasUV = 0x2;
+constexpr std::size_t kVertexRecordSize = sizeof(Vector3) * 2 + sizeof(Vector2) + sizeof(std::uint8_t);
+
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must stay tightly packed for chunk IO");
+static_assert(sizeof(Vector2) == 2 * sizeof(float), "Vector2 must stay tightly packed for chunk IO");
+
+template <typename T>
+void appendPod(std::string& out, const T& value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void appendPoints(std::string& out, const std::vector<Vector3>& points)
+{
+    appendPod(out, static_cast<std::uint32_t>(points.size()));
+    if (!points.empty())
+        out.append(reinterpret_cast<const char*>(points.data()), points.size() * sizeof(Vector3));
+}
+
+void appendMesh(std::string& out, const HalfEdgeMesh& mesh)
+{
+    const auto& vertices = mesh.getVertices();
+    appendPod(out, static_cast<std::uint32_t>(vertices.size()));
+    out.reserve(out.size() + vertices.size() * kVertexRecordSize);
+    for (const auto& vertex : vertices) {
+        appendPod(out, vertex.position);
+        appendPod(out, vertex.normal);
+        appendPod(out, vertex.uv);
+        std::uint8_t flags = 0;
+        if (vertex.hasNormal)
+            flags |= kVertexHasNormal;
+        if (vertex.hasUV)
+            flags |= kVertexHasUV;
+        appendPod(out, flags);
+    }
+
+    // Faces are stored as size-prefixed vertex loops; the half-edge links are
+    // rebuilt by addFace on load.
+    const auto& halfEdges = mesh.getHalfEdges();
+    std::vector<std::uint32_t> loops;
+    loops.reserve(halfEdges.size() + mesh.getFaces().size());
+    std::uint32_t faceCount = 0;
+    for (const auto& face : mesh.getFaces()) {
+        if (face.halfEdge < 0)
+            continue;
+        const std::size_t sizeSlot = loops.size();
+        loops.push_back(0);
+        std::uint32_t loopSize = 0;
+        int current = face.halfEdge;
+        do {
+            if (current < 0 || static_cast<std::size_t>(current) >= halfEdges.size() || loopSize > halfEdges.size())
+                break;
+            loops.push_back(static_cast<std::uint32_t>(halfEdges[current].origin));
+            ++loopSize;
+            current = halfEdges[current].next;
+        } while (current != face.halfEdge);
+        if (loopSize < 3) {
+            loops.resize(sizeSlot);
+            continue;
+        }
+        loops[sizeSlot] = loopSize;
+        ++faceCount;
+    }
+    appendPod(out, faceCount);
+    appendPod(out, static_cast<std::uint32_t>(loops.size()));
+    if (!loops.empty())
+        out.append(reinterpret_cast<const char*>(loops.data()), loops.size() * sizeof(std::uint32_t));
+}
+
+class ChunkReader {
+public:
+    ChunkReader(const char* data, std::size_t size)
+        : cursor(data)
+        , end(data + size)
+    {
+    }
+
+    template <typename T>
+    bool read(T& value)
+    {
+        if (remaining() < sizeof(T))
+            return false;
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    bool readArray(std::vector<T>& values, std::size_t count)
+    {
+        if (remaining() / sizeof(T) < count)
+            return false;
+        values.resize(count);
+        if (count > 0)
+            std::memcpy(values.data(), cursor, count * sizeof(T));
+        cursor += count * sizeof(T);
+        return true;
+    }
+
+    bool readPoints(std::vector<Vector3>& points)
+    {
+        std::uint32_t count = 0;
+        return read(count) && readArray(points, count);
+    }
+
+    std::size_t remaining() const { return static_cast<std::size_t>(end - cursor); }
+
+private:
+    const char* cursor;
+    const char* end;
+};
+
+bool readMesh(ChunkReader& reader, HalfEdgeMesh& mesh)
+{
+    std::uint32_t vertexCount = 0;
+    if (!reader.read(vertexCount) || reader.remaining() / kVertexRecordSize < vertexCount)
+        return false;
+    for (std::uint32_t i = 0; i < vertexCount; ++i) {
+        Vector3 position;
+        Vector3 normal;
+        Vector2 uv;
+        std::uint8_t flags = 0;
+        if (!reader.read(position) || !reader.read(normal) || !reader.read(uv) || !reader.read(flags))
+            return false;
+        mesh.addVertex(position, normal, uv, (flags & kVertexHasNormal) != 0, (flags & kVertexHasUV) != 0);
+    }
+
+    std::uint32_t faceCount = 0;
+    std::uint32_t loopDataCount = 0;
+    std::vector<std::uint32_t> loops;
+    if (!reader.read(faceCount) || !reader.read(loopDataCount) || !reader.readArray(loops, loopDataCount))
+        return false;
+
+    std::size_t cursor = 0;
+    std::vector<int> loop;
+    for (std::uint32_t f = 0; f < faceCount; ++f) {
+        if (cursor >= loops.size())
+            return false;
+        const std::uint32_t loopSize = loops[cursor++];
+        if (loopSize > loops.size() - cursor)
+            return false;
+        loop.clear();
+        for (std::uint32_t i = 0; i < loopSize; ++i) {
+            const std::uint32_t index = loops[cursor + i];
+            if (index >= vertexCount)
+                return false;
+            loop.push_back(static_cast<int>(index));
+        }
+        cursor += loopSize;
+        mesh.addFace(loop);
+    }
+    return true;
+}
+
+} // namespace
+
+namespace GeometryIO {
+
+void appendObjectChunk(std::string& out, const GeometryObject& object)
+{
+    const bool isCurve = object.getType() == ObjectType::Curve;
+    appendPod(out, isCurve ? kChunkCurve : kChunkSolid);
+    const char reserved[3] = { 0, 0, 0 };
+    out.append(reserved, sizeof(reserved));
+    appendPod(out, static_cast<std::uint64_t>(object.getStableId()));
+
+    if (isCurve) {
+        const auto& curve = static_cast<const Curve&>(object);
+        appendPoints(out, curve.getBoundaryLoop());
+        const auto& hardness = curve.getEdgeHardness();
+        appendPod(out, static_cast<std::uint32_t>(hardness.size()));
+        for (bool hard : hardness)
+            appendPod(out, static_cast<std::uint8_t>(hard ? 1 : 0));
+    } else {
+        const auto& solid = static_cast<const Solid&>(object);
+        appendPoints(out, solid.getBaseLoop());
+        appendPod(out, solid.getHeight());
+    }
+    appendMesh(out, object.getMesh());
+}
+
+std::unique_ptr<GeometryObject> decodeObjectChunk(const char* data, std::size_t size)
+{
+    if (!data)
+        return nullptr;
+    ChunkReader reader(data, size);
+    std::uint8_t type = 0;
+    char reserved[3];
+    std::uint64_t stableId = 0;
+    if (!reader.read(type) || !reader.read(reserved) || !reader.read(stableId))
+        return nullptr;
+
+    std::unique_ptr<GeometryObject> object;
+    if (type == kChunkCurve) {
+        std::vector<Vector3> loop;
+        std::uint32_t hardnessCount = 0;
+        std::vector<std::uint8_t> hardnessBytes;
+        if (!reader.readPoints(loop) || !reader.read(hardnessCount) || !reader.readArray(hardnessBytes, hardnessCount))
+            return nullptr;
+        std::vector<bool> hardness(hardnessBytes.begin(), hardnessBytes.end());
+        HalfEdgeMesh mesh;
+        if (!readMesh(reader, mesh))
+            return nullptr;
+        object = std::make_unique<Curve>(std::move(loop), std::move(mesh), std::move(hardness));
+    } else if (type == kChunkSolid) {
+        std::vector<Vector3> base;
+        float height = 0.0f;
+        if (!reader.readPoints(base) || !reader.read(height))
+            return nullptr;
+        HalfEdgeMesh mesh;
+        if (!readMesh(reader, mesh))
+            return nullptr;
+        object = Solid::restore(std::move(base), height, std::move(mesh));
+    } else {
+        return nullptr;
+    }
+
+    object->setStableId(static_cast<GeometryObject::StableId>(stableId));
+    return object;
+}
+
+std::uint64_t chunkHash(const char* data, std::size_t size)
+{
+    // FNV-1a over 64-bit words with a byte tail; fast enough to run on every
+    // chunk during save and load.
+    constexpr std::uint64_t kPrime = 1099511628211ull;
+    std::uint64_t hash = 14695981039346656037ull ^ static_cast<std::uint64_t>(size);
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * kPrime;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; ++i)
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * kPrime;
+    return hash == 0 ? 1 : hash;
+}
+
+bool decodeObjectChunks(const char* data, std::size_t size, const std::vector<ChunkRange>& ranges,
+                        std::vector<std::unique_ptr<GeometryObject>>& objects, unsigned threadCount,
+                        const ChunkInflater& inflate)
+{
+    objects.clear();
+    if (ranges.empty())
+        return true;
+    if (!data)
+        return false;
+    for (const auto& range : ranges) {
+        if (range.offset > size || range.length > size - range.offset)
+            return false;
+        if (range.rawLength != 0 && !inflate)
+            return false;
+    }
+
+    // Each worker writes only its own slot, so file order survives no matter
+    // which chunk finishes first.
+    objects.resize(ranges.size());
+    std::atomic<bool> failed{ false };
+    Core::parallelFor(ranges.size(), threadCount, [&](std::size_t index) {
+        if (failed.load(std::memory_order_relaxed))
+            return;
+        const ChunkRange& range = ranges[index];
+        const char* bytes = data + range.offset;
+        std::size_t length = static_cast<std::size_t>(range.length);
+        std::string inflated;
+        if (range.rawLength != 0) {
+            if (!inflate(bytes, length, static_cast<std::size_t>(range.rawLength), inflated)
+                || inflated.size() != range.rawLength) {
+                failed.store(true, std::memory_order_relaxed);
+                return;
+            }
+            bytes = inflated.data();
+            length = inflated.size();
+        }
+        if (range.hash != 0 && chunkHash(bytes, length) != range.hash) {
+            failed.store(true, std::memory_order_relaxed);
+            return;
+        }
+        objects[index] = decodeObjectChunk(bytes, length);
+        if (!objects[index])
+            failed.store(true, std::memory_order_relaxed);
+    });
+    if (failed.load()) {
+        objects.clear();
+        return false;
+    }
+    return true;
+}
+
+} // namespace GeometryIO
@@ -1,9 +1,15 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <iosfwd>
+#include <string>
+#include <vector>
 
 class Curve;
 class Solid;
+class GeometryObject;
 
 namespace GeometryIO {
 void writeCurve(std::ostream& os, const Curve& curve);
@@ -11,4 +17,34 @@ std::unique_ptr<Curve> readCurve(std::istream& is);
 
 void writeSolid(std::ostream& os, const Solid& solid);
 std::unique_ptr<Solid> readSolid(std::istream& is);
+
+// Binary per-object chunks used by the chunked scene container. Unlike the text
+// records above they carry the full half-edge mesh, so decoding never has to
+// rebuild a solid from its profile.
+void appendObjectChunk(std::string& out, const GeometryObject& object);
+std::unique_ptr<GeometryObject> decodeObjectChunk(const char* data, std::size_t size);
+
+struct ChunkRange {
+    std::uint64_t offset = 0;
+    std::uint64_t length = 0;
+    // Decoded size when the chunk is stored compressed; 0 means stored raw.
+    std::uint64_t rawLength = 0;
+    // chunkHash() of the decoded bytes; 0 skips verification.
+    std::uint64_t hash = 0;
+};
+
+// Expands a compressed chunk into out. Must be safe to call from several
+// threads at once.
+using ChunkInflater = std::function<bool(const char* data, std::size_t size, std::size_t rawLength, std::string& out)>;
+
+// Content hash used to detect unchanged and corrupt chunks. Never returns 0.
+std::uint64_t chunkHash(const char* data, std::size_t size);
+
+// Decodes every range of data on up to threadCount workers (0 = one per core)
+// and returns the objects in range order. Compressed ranges go through inflate.
+// Fails as a whole if any range lies outside the buffer, does not match its
+// hash or does not decode; objects is left empty in that case.
+bool decodeObjectChunks(const char* data, std::size_t size, const std::vector<ChunkRange>& ranges,
+                        std::vector<std::unique_ptr<GeometryObject>>& objects, unsigned threadCount = 0,
+                        const ChunkInflater& inflate = ChunkInflater());
 }
@@ -151,8 +151,14 @@ std::unique_ptr<Solid> Solid::createFromMesh(HalfEdgeMesh meshData)
     return std::unique_ptr<Solid>(new Solid(std::move(base), height, std::move(meshData)));
 }
 
+std::unique_ptr<Solid> Solid::restore(std::vector<Vector3> base, float h, HalfEdgeMesh meshData)
+{
+    return std::unique_ptr<Solid>(new Solid(std::move(base), h, std::move(meshData)));
+}
+
 void Solid::applyTransform(const std::function<Vector3(const Vector3&)>& fn)
 {
+    touch();
     for (auto& point : baseLoop) {
         point = fn(point);
     }
@@ -184,14 +190,33 @@ std::unique_ptr<GeometryObject> Solid::clone() const
     return copy;
 }
 
+bool Solid::assignContent(const GeometryObject& source)
+{
+    if (source.getType() != ObjectType::Solid)
+        return false;
+    const auto& solid = static_cast<const Solid&>(source);
+    touch();
+    baseLoop = solid.baseLoop;
+    height = solid.height;
+    mesh = solid.mesh;
+    return true;
+}
+
+std::size_t Solid::memoryFootprint() const
+{
+    return sizeof(Solid) + baseLoop.capacity() * sizeof(Vector3) + mesh.memoryFootprint();
+}
+
 void Solid::setMesh(HalfEdgeMesh meshData)
 {
+    touch();
     mesh = std::move(meshData);
     mesh.heal(kDefaultTolerance, kDefaultTolerance);
 }
 
 void Solid::setBaseMetadata(std::vector<Vector3> base, float newHeight)
 {
+    touch();
     baseLoop = std::move(base);
     height = std::max(newHeight, kDefaultTolerance);
 }
@@ -18,11 +18,16 @@ public:
     static std::unique_ptr<Solid> createFromCurveWithVector(const Curve& curve, const Vector3& direction,
         bool capStart = true, bool capEnd = true);
     static std::unique_ptr<Solid> createFromMesh(HalfEdgeMesh mesh);
+    /// Recreate a solid from previously serialized state. The mesh is taken as-is
+    /// (no healing), so callers must pass data that came from an existing solid.
+    static std::unique_ptr<Solid> restore(std::vector<Vector3> baseLoop, float height, HalfEdgeMesh mesh);
 
     ObjectType getType() const override { return ObjectType::Solid; }
     const HalfEdgeMesh& getMesh() const override { return mesh; }
-    HalfEdgeMesh& getMesh() override { return mesh; }
+    HalfEdgeMesh& getMesh() override { touch(); return mesh; }
     std::unique_ptr<GeometryObject> clone() const override;
+    bool assignContent(const GeometryObject& source) override;
+    std::size_t memoryFootprint() const override;
 
     const std::vector<Vector3>& getBaseLoop() const { return baseLoop; }
     float getHeight() const { return height; }
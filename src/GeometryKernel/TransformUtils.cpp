@@ -1,7 +1,14 @@
 #include "TransformUtils.h"
 
+#include <algorithm>
 #include <cmath>
 
+namespace {
+
+constexpr float kDegreesToRadians = 3.14159265358979323846f / 180.0f;
+
+}
+
 namespace GeometryTransforms {
 
 Vector3 translate(const Vector3& point, const Vector3& delta)
@@ -29,5 +36,140 @@ Vector3 scaleFromPivot(const Vector3& point, const Vector3& pivot, const Vector3
     return pivot + scaled;
 }
 
+Matrix4 identityMatrix()
+{
+    return { 1.0f, 0.0f, 0.0f, 0.0f,
+             0.0f, 1.0f, 0.0f, 0.0f,
+             0.0f, 0.0f, 1.0f, 0.0f,
+             0.0f, 0.0f, 0.0f, 1.0f };
 }
 
+bool isIdentity(const Matrix4& m)
+{
+    static const Matrix4 identity = identityMatrix();
+    return m == identity;
+}
+
+Matrix4 multiply(const Matrix4& a, const Matrix4& b)
+{
+    Matrix4 result{};
+    for (int col = 0; col < 4; ++col) {
+        for (int row = 0; row < 4; ++row) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; ++k)
+                sum += a[k * 4 + row] * b[col * 4 + k];
+            result[col * 4 + row] = sum;
+        }
+    }
+    return result;
+}
+
+Matrix4 composeTransform(const Vector3& translation, const Vector3& rotationDegrees, const Vector3& scale)
+{
+    const float cx = std::cos(rotationDegrees.x * kDegreesToRadians);
+    const float sx = std::sin(rotationDegrees.x * kDegreesToRadians);
+    const float cy = std::cos(rotationDegrees.y * kDegreesToRadians);
+    const float sy = std::sin(rotationDegrees.y * kDegreesToRadians);
+    const float cz = std::cos(rotationDegrees.z * kDegreesToRadians);
+    const float sz = std::sin(rotationDegrees.z * kDegreesToRadians);
+
+    // Columns of Rz * Ry * Rx, each scaled by its axis factor.
+    Matrix4 m{};
+    m[0] = cy * cz * scale.x;
+    m[1] = cy * sz * scale.x;
+    m[2] = -sy * scale.x;
+    m[4] = (cz * sy * sx - sz * cx) * scale.y;
+    m[5] = (sz * sy * sx + cz * cx) * scale.y;
+    m[6] = cy * sx * scale.y;
+    m[8] = (cz * sy * cx + sz * sx) * scale.z;
+    m[9] = (sz * sy * cx - cz * sx) * scale.z;
+    m[10] = cy * cx * scale.z;
+    m[12] = translation.x;
+    m[13] = translation.y;
+    m[14] = translation.z;
+    m[15] = 1.0f;
+    return m;
+}
+
+void decomposeTransform(const Matrix4& m, Vector3& translation, Vector3& rotationDegrees, Vector3& scale)
+{
+    translation = Vector3(m[12], m[13], m[14]);
+    scale = Vector3(Vector3(m[0], m[1], m[2]).length(), Vector3(m[4], m[5], m[6]).length(),
+                    Vector3(m[8], m[9], m[10]).length());
+    const float det = m[0] * (m[5] * m[10] - m[9] * m[6]) - m[4] * (m[1] * m[10] - m[9] * m[2])
+        + m[8] * (m[1] * m[6] - m[5] * m[2]);
+    if (det < 0.0f)
+        scale.x = -scale.x;
+
+    auto r = [&](int row, int col) {
+        const float axisScale = col == 0 ? scale.x : (col == 1 ? scale.y : scale.z);
+        return std::fabs(axisScale) > 1e-12f ? m[col * 4 + row] / axisScale : (row == col ? 1.0f : 0.0f);
+    };
+    const float sy = std::clamp(-r(2, 0), -1.0f, 1.0f);
+    float x = 0.0f;
+    float z = 0.0f;
+    const float y = std::asin(sy);
+    if (std::fabs(sy) < 0.99999f) {
+        x = std::atan2(r(2, 1), r(2, 2));
+        z = std::atan2(r(1, 0), r(0, 0));
+    } else {
+        // Gimbal lock: only x + z (or x - z) is defined, so put it all on x.
+        x = std::atan2(-r(1, 2), r(1, 1));
+    }
+    rotationDegrees = Vector3(x / kDegreesToRadians, y / kDegreesToRadians, z / kDegreesToRadians);
+}
+
+Matrix4 inverseAffine(const Matrix4& m)
+{
+    const float a = m[0], b = m[4], c = m[8];
+    const float d = m[1], e = m[5], f = m[9];
+    const float g = m[2], h = m[6], i = m[10];
+    const float det = a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+    if (std::fabs(det) < 1e-12f)
+        return identityMatrix();
+    const float inv = 1.0f / det;
+
+    Matrix4 result{};
+    result[0] = (e * i - f * h) * inv;
+    result[4] = (c * h - b * i) * inv;
+    result[8] = (b * f - c * e) * inv;
+    result[1] = (f * g - d * i) * inv;
+    result[5] = (a * i - c * g) * inv;
+    result[9] = (c * d - a * f) * inv;
+    result[2] = (d * h - e * g) * inv;
+    result[6] = (b * g - a * h) * inv;
+    result[10] = (a * e - b * d) * inv;
+    const Vector3 t = transformDirection(result, Vector3(m[12], m[13], m[14]));
+    result[12] = -t.x;
+    result[13] = -t.y;
+    result[14] = -t.z;
+    result[15] = 1.0f;
+    return result;
+}
+
+Vector3 transformPoint(const Matrix4& m, const Vector3& point)
+{
+    return Vector3(m[0] * point.x + m[4] * point.y + m[8] * point.z + m[12],
+                   m[1] * point.x + m[5] * point.y + m[9] * point.z + m[13],
+                   m[2] * point.x + m[6] * point.y + m[10] * point.z + m[14]);
+}
+
+Vector3 transformDirection(const Matrix4& m, const Vector3& direction)
+{
+    return Vector3(m[0] * direction.x + m[4] * direction.y + m[8] * direction.z,
+                   m[1] * direction.x + m[5] * direction.y + m[9] * direction.z,
+                   m[2] * direction.x + m[6] * direction.y + m[10] * direction.z);
+}
+
+Matrix4 normalMatrix(const Matrix4& m)
+{
+    const Matrix4 inverse = inverseAffine(m);
+    Matrix4 result = identityMatrix();
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col)
+            result[col * 4 + row] = inverse[row * 4 + col];
+    }
+    return result;
+}
+
+}
@@ -2,11 +2,32 @@
 
 #include "Vector3.h"
 
+#include <array>
+
 namespace GeometryTransforms {
 
+// Column-major 4x4 matrix, the layout OpenGL, glTF and the exporters use.
+using Matrix4 = std::array<float, 16>;
+
 Vector3 translate(const Vector3& point, const Vector3& delta);
 Vector3 rotateAroundAxis(const Vector3& point, const Vector3& pivot, const Vector3& axis, float angleRadians);
 Vector3 scaleFromPivot(const Vector3& point, const Vector3& pivot, const Vector3& factors);
 
-}
+Matrix4 identityMatrix();
+bool isIdentity(const Matrix4& m);
+// a * b: b is applied first.
+Matrix4 multiply(const Matrix4& a, const Matrix4& b);
+// T * R * S, with the rotation given as degrees about X, then Y, then Z.
+Matrix4 composeTransform(const Vector3& translation, const Vector3& rotationDegrees, const Vector3& scale);
+// Splits an affine matrix without shear back into the terms of composeTransform().
+void decomposeTransform(const Matrix4& m, Vector3& translation, Vector3& rotationDegrees, Vector3& scale);
+// Inverse of an affine matrix; the identity if it is singular.
+Matrix4 inverseAffine(const Matrix4& m);
+Vector3 transformPoint(const Matrix4& m, const Vector3& point);
+// Applies the linear part only, for directions and offsets.
+Vector3 transformDirection(const Matrix4& m, const Vector3& direction);
+// Inverse transpose of the linear part: transformDirection() with it keeps
+// normals perpendicular to their surface under non-uniform scale.
+Matrix4 normalMatrix(const Matrix4& m);
 
+}
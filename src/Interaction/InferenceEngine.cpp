@@ -5,6 +5,7 @@
 #include "../GeometryKernel/HalfEdgeMesh.h"
 #include "../GeometryKernel/Curve.h"
 #include "../GeometryKernel/Solid.h"
+#include "../GeometryKernel/TransformUtils.h"
 
 #include <algorithm>
 #include <array>
@@ -312,10 +313,11 @@ std::size_t InferenceEngine::computeStamp(const GeometryKernel& geometry) const
     std::size_t stamp = 1469598103934665603ull;
     const auto& objects = geometry.getObjects();
     for (const auto& obj : objects) {
-        const HalfEdgeMesh& mesh = obj->getMesh();
+        const HalfEdgeMesh& mesh = static_cast<const GeometryObject&>(*obj).getMesh();
         stamp ^= mesh.getVertices().size() + 0x9e3779b97f4a7c15ull + (stamp << 6) + (stamp >> 2);
         stamp ^= mesh.getHalfEdges().size() + 0x517cc1b727220a95ull + (stamp << 6) + (stamp >> 2);
         stamp ^= mesh.getFaces().size() + 0x27d4eb2f165667c5ull + (stamp << 6) + (stamp >> 2);
+        stamp ^= obj->placementRevision() + 0x165667b19e3779f9ull + (stamp << 6) + (stamp >> 2);
     }
     stamp ^= objects.size();
     return stamp;
@@ -342,8 +344,9 @@ void InferenceEngine::rebuild(const GeometryKernel& geometry)
     faceCenterPositions.clear();
 
     const auto& objects = geometry.getObjects();
+    std::vector<Vector3> placedPositions;
     for (const auto& obj : objects) {
-        const HalfEdgeMesh& mesh = obj->getMesh();
+        const HalfEdgeMesh& mesh = static_cast<const GeometryObject&>(*obj).getMesh();
         const auto& vertices = mesh.getVertices();
         const auto& halfEdges = mesh.getHalfEdges();
         const auto& faces = mesh.getFaces();
@@ -352,6 +355,19 @@ void InferenceEngine::rebuild(const GeometryKernel& geometry)
             continue;
         }
 
+        // Features are indexed in world space.
+        const bool placed = obj->isPlaced();
+        placedPositions.clear();
+        if (placed) {
+            placedPositions.reserve(vertices.size());
+            for (const auto& v : vertices)
+                placedPositions.push_back(GeometryTransforms::transformPoint(obj->placement(), v.position));
+        }
+        const GeometryTransforms::Matrix4 normals = GeometryTransforms::normalMatrix(obj->placement());
+        auto position = [&](std::size_t index) -> const Vector3& {
+            return placed ? placedPositions[index] : vertices[index].position;
+        };
+
         std::unordered_set<long long> edgeSeen;
         std::vector<int> valence(vertices.size(), 0);
         for (const auto& he : halfEdges) {
@@ -360,13 +376,13 @@ void InferenceEngine::rebuild(const GeometryKernel& geometry)
             }
         }
 
-        for (const auto& v : vertices) {
-            endpointPositions.push_back(v.position);
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            endpointPositions.push_back(position(i));
         }
 
         for (size_t i = 0; i < vertices.size(); ++i) {
             if (valence[i] >= 3) {
-                intersectionPositions.push_back(vertices[i].position);
+                intersectionPositions.push_back(position(i));
             }
         }
 
@@ -374,8 +390,8 @@ void InferenceEngine::rebuild(const GeometryKernel& geometry)
             if (he.origin < 0 || he.destination < 0) continue;
             long long key = makeUndirectedKey(he.origin, he.destination);
             if (!edgeSeen.insert(key).second) continue;
-            const Vector3& a = vertices[static_cast<size_t>(he.origin)].position;
-            const Vector3& b = vertices[static_cast<size_t>(he.destination)].position;
+            const Vector3& a = position(static_cast<size_t>(he.origin));
+            const Vector3& b = position(static_cast<size_t>(he.destination));
             Vector3 midpoint = (a + b) * 0.5f;
             midpointPositions.push_back(midpoint);
             EdgeFeature feature;
@@ -400,7 +416,7 @@ void InferenceEngine::rebuild(const GeometryKernel& geometry)
                 if (he.origin < 0 || he.origin >= static_cast<int>(vertices.size())) {
                     break;
                 }
-                const Vector3& pos = vertices[static_cast<size_t>(he.origin)].position;
+                const Vector3& pos = position(static_cast<size_t>(he.origin));
                 centroid += pos;
                 ++count;
                 heIndex = he.next;
@@ -422,7 +438,7 @@ void InferenceEngine::rebuild(const GeometryKernel& geometry)
                 if (he.origin < 0 || he.origin >= static_cast<int>(vertices.size())) {
                     break;
                 }
-                const Vector3& pos = vertices[static_cast<size_t>(he.origin)].position;
+                const Vector3& pos = position(static_cast<size_t>(he.origin));
                 float dSq = (pos - centroid).lengthSquared();
                 if (dSq > maxRadiusSq) maxRadiusSq = dSq;
                 heIndex = he.next;
@@ -435,7 +451,7 @@ void InferenceEngine::rebuild(const GeometryKernel& geometry)
             }
             FaceFeature feature;
             feature.center = centroid;
-            feature.normal = face.normal;
+            feature.normal = placed ? GeometryTransforms::transformDirection(normals, face.normal).normalized() : face.normal;
             feature.radiusSquared = maxRadiusSq;
             faceCenterPositions.push_back(centroid);
             faceFeatures.push_back(feature);
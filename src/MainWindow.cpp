@@ -17,6 +17,7 @@
 #include "Tools/LoftTool.h"
 #include "Tools/ToolManager.h"
 #include "app/AutosaveManager.h"
+#include "app/ImportManager.h"
 #include "ui/ExternalReferenceDialog.h"
 #include "ui/GuideManagerDialog.h"
 #include "ui/ImageImportDialog.h"
@@ -587,6 +588,9 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent)
             if (rightTray_)
                 rightTray_->refreshPanels();
         };
+        context.historyInvalidated = [this]() {
+            statusBar()->showMessage(tr("Undo history could not be restored and has been cleared"), 8000);
+        };
         commandStack->setContext(context);
     }
 
@@ -599,6 +603,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent)
 
     viewport->setNavigationPreferences(navigationPrefs.get());
     initializeAutosave();
+    initializeImportManager();
 
     connect(viewport, &GLViewport::cursorPositionChanged, this, &MainWindow::updateCursor);
 
@@ -786,6 +791,9 @@ MainWindow::~MainWindow()
 
 {
 
+    if (importManager)
+        importManager->shutdown();
+
     if (autosaveManager)
         autosaveManager->shutdown();
 
@@ -799,6 +807,9 @@ void MainWindow::closeEvent(QCloseEvent* event)
 
     persistWindowState();
 
+    if (importManager)
+        importManager->shutdown();
+
     if (autosaveManager)
         autosaveManager->shutdown();
 
@@ -835,6 +846,54 @@ void MainWindow::initializeAutosave()
 
     autosaveManager->setDocument(document_.get());
 
+    connect(autosaveManager.get(), &AutosaveManager::autosaveFailed, this, [this](const QString& message) {
+        statusBar()->showMessage(tr("Autosave failed: %1").arg(message), 5000);
+    });
+
+}
+
+void MainWindow::initializeImportManager()
+{
+    importManager = std::make_unique<ImportManager>(this);
+
+    connect(importManager.get(), &ImportManager::importStarted, this, [this](const QString& filePath) {
+        if (actionImport)
+            actionImport->setEnabled(false);
+        if (actionCancelImport)
+            actionCancelImport->setEnabled(true);
+        statusBar()->showMessage(tr("Importing %1...").arg(QFileInfo(filePath).fileName()));
+    });
+    connect(importManager.get(), &ImportManager::importProgress, this,
+            [this](qint64 bytesRead, qint64 totalBytes, qint64 trianglesBuilt) {
+                const int percent = totalBytes > 0 ? static_cast<int>(bytesRead * 100 / totalBytes) : 0;
+                statusBar()->showMessage(tr("Importing: %1% read, %2 triangles").arg(percent).arg(trianglesBuilt));
+            });
+
+    auto finishUi = [this]() {
+        if (actionImport)
+            actionImport->setEnabled(true);
+        if (actionCancelImport)
+            actionCancelImport->setEnabled(false);
+        if (viewport)
+            viewport->update();
+    };
+    connect(importManager.get(), &ImportManager::importFinished, this, [this, finishUi](const QString& filePath) {
+        if (viewport)
+            viewport->frameSceneToGeometry();
+        applyFreshDocumentState();
+        finishUi();
+        statusBar()->showMessage(tr("Imported %1").arg(QFileInfo(filePath).fileName()), 1500);
+    });
+    connect(importManager.get(), &ImportManager::importFailed, this,
+            [this, finishUi](const QString& filePath, const QString& message) {
+                finishUi();
+                const QString reason = message.isEmpty() ? tr("Unknown import error") : message;
+                statusBar()->showMessage(tr("Failed to import %1: %2").arg(QFileInfo(filePath).fileName(), reason), 4000);
+            });
+    connect(importManager.get(), &ImportManager::importCancelled, this, [this, finishUi](const QString& filePath) {
+        finishUi();
+        statusBar()->showMessage(tr("Import of %1 cancelled").arg(QFileInfo(filePath).fileName()), 2000);
+    });
 }
 
 void MainWindow::maybeRestoreAutosave()
@@ -1111,7 +1170,13 @@ bool MainWindow::saveDocumentToPath(const QString& path, bool purgePreviousPrefi
 
         return false;
 
-    const bool ok = document->saveToFile(path.toStdString());
+    Scene::SceneSerializer::SaveOptions saveOptions;
+    {
+        QSettings settings("FreeCrafter", "FreeCrafter");
+        saveOptions.compress = settings.value(QStringLiteral("Files/compressScenes"), false).toBool();
+    }
+    saveOptions.incremental = true;
+    const bool ok = document->saveToFile(path.toStdString(), saveOptions);
 
     if (!ok)
 
@@ -1298,6 +1363,13 @@ void MainWindow::createMenus()
     actionImport->setIcon(QIcon(QStringLiteral(":/icons/import.svg")));
     actionImport->setStatusTip(tr("Import external geometry into the active document"));
 
+    actionCancelImport = fileMenu->addAction(tr("Cancel Import"), this, [this]() {
+        if (importManager)
+            importManager->cancel();
+    });
+    actionCancelImport->setStatusTip(tr("Stop the import running in the background"));
+    actionCancelImport->setEnabled(false);
+
     actionSave = fileMenu->addAction(tr("Save"), this, &MainWindow::saveFile);
     actionSave->setIcon(QIcon(QStringLiteral(":/icons/save.svg")));
     actionSave->setStatusTip(tr("Save the active document"));
@@ -1735,6 +1807,8 @@ void MainWindow::importExternalModel()
                 ext.remove(0, 1);
             if (!ext.isEmpty())
                 wildcardFilters << QStringLiteral("*.%1").arg(ext);
+            if (format == FileIO::SceneFormat::GLTF)
+                wildcardFilters << QStringLiteral("*.glb");
         }
         const std::string filterString = FileIO::formatFilterString(format);
         if (!filterString.empty())
@@ -1780,7 +1854,9 @@ void MainWindow::importExternalModel()
         }
 
         if (format == Scene::Document::FileFormat::Auto) {
-            if (suffix == QLatin1String("dxf")) {
+            if (suffix == QLatin1String("glb")) {
+                format = Scene::Document::FileFormat::Gltf;
+            } else if (suffix == QLatin1String("dxf")) {
                 format = Scene::Document::FileFormat::Dxf;
             } else if (suffix == QLatin1String("dwg")) {
                 format = Scene::Document::FileFormat::Dwg;
@@ -1794,28 +1870,14 @@ void MainWindow::importExternalModel()
         return;
     }
 
-    if (viewport)
-        viewport->requestAutoFrameOnGeometryChange();
-
-    const bool ok = doc->importExternalModel(fileName.toStdString(), format);
-    if (ok) {
-        if (viewport)
-            viewport->frameSceneToGeometry();
-
-        applyFreshDocumentState();
-
-        if (statusBar())
-            statusBar()->showMessage(tr("Imported %1").arg(QFileInfo(fileName).fileName()), 1500);
-    } else {
-        QString reason = QString::fromStdString(doc->lastImportError());
-        if (reason.isEmpty())
-            reason = tr("Unknown import error");
-        if (statusBar())
-            statusBar()->showMessage(tr("Failed to import %1: %2").arg(QFileInfo(fileName).fileName(), reason), 4000);
+    // The file is read on a worker thread and merged when complete; the
+    // handlers set up in initializeImportManager() finish the UI work.
+    if (!importManager || !importManager->startImport(doc, fileName, format)) {
+        statusBar()->showMessage(tr("Another import is still running"), 2000);
+        return;
     }
-
     if (viewport)
-        viewport->update();
+        viewport->requestAutoFrameOnGeometryChange();
 }
 
 void MainWindow::exportFile()
@@ -1879,8 +1941,12 @@ void MainWindow::exportFile()
 
     document->synchronizeWithGeometry();
 
+    FileIO::Exporters::ExportOptions exportOptions;
+    exportOptions.optimizeMeshes = true;
+    FileIO::Exporters::ExportSummary summary;
     std::string errorMessage;
-    if (!FileIO::Exporters::exportScene(*document, filePath.toStdString(), chosenFormat, &errorMessage)) {
+    if (!FileIO::Exporters::exportScene(*document, filePath.toStdString(), chosenFormat, exportOptions, &summary,
+                                        &errorMessage)) {
         QString message = QString::fromStdString(errorMessage);
         if (message.isEmpty())
             message = tr("Unknown export error");
@@ -1890,7 +1956,13 @@ void MainWindow::exportFile()
         return;
     }
 
-    statusBar()->showMessage(tr("Exported \"%1\"").arg(QFileInfo(filePath).fileName()), 4000);
+    statusBar()->showMessage(tr("Exported \"%1\" (%2 triangles, %3 KiB geometry, ACMR %4 -> %5)")
+                                 .arg(QFileInfo(filePath).fileName())
+                                 .arg(static_cast<qulonglong>(summary.triangles))
+                                 .arg(static_cast<qulonglong>((summary.geometryBytes + 1023) / 1024))
+                                 .arg(summary.acmrBefore, 0, 'f', 2)
+                                 .arg(summary.acmrAfter, 0, 'f', 2),
+                             6000);
 }
 
 void MainWindow::showInsertShapesDialog()
@@ -3925,6 +3997,9 @@ void MainWindow::newFile()
 
 {
 
+    if (importManager)
+        importManager->shutdown();
+
     if (viewport) {
 
         if (auto* doc = viewport->getDocument()) {
@@ -3979,6 +4054,9 @@ bool MainWindow::openFileFromPath(const QString& path)
     if (normalizedPath.isEmpty())
         return false;
 
+    if (importManager)
+        importManager->shutdown();
+
     viewport->setAutoFrameOnGeometryChange(true);
     viewport->resetCameraToHome();
 
@@ -4865,20 +4943,9 @@ void MainWindow::updateSelectionStatus()
             inspectorPanel->updateSelection(nullptr, nullptr, {});
         return;
     }
-    const auto& objects = doc->geometry().getObjects();
-    int selectedCount = 0;
-    int totalCount = 0;
-    std::vector<GeometryObject*> selectedObjects;
-    selectedObjects.reserve(objects.size());
-    for (const auto& object : objects) {
-        if (!object)
-            continue;
-        ++totalCount;
-        if (object->isSelected()) {
-            ++selectedCount;
-            selectedObjects.push_back(object.get());
-        }
-    }
+    const int totalCount = static_cast<int>(doc->geometry().getObjects().size());
+    const std::vector<GeometryObject*> selectedObjects = doc->selectedGeometry();
+    const int selectedCount = static_cast<int>(selectedObjects.size());
     if (inspectorPanel)
         inspectorPanel->updateSelection(doc, &doc->geometry(), selectedObjects);
     QString textValue;
@@ -32,6 +32,7 @@ class QSize;
 class QCloseEvent;
 class QResizeEvent;
 class AutosaveManager;
+class ImportManager;
 class CommandPaletteDialog;
 class ViewportContainer;
 
@@ -184,6 +185,7 @@ private:
     void resizeEvent(QResizeEvent* event) override;
     void initializeAutosave();
     void maybeRestoreAutosave();
+    void initializeImportManager();
     void updateAutosaveSource(const QString& path, bool purgePreviousPrefix);
     void recordPaletteCommand(const QString& commandId);
     void attachViewport(GLViewport* viewportInstance);
@@ -208,6 +210,7 @@ private:
     std::unique_ptr<NavigationPreferences> navigationPrefs;
     std::unique_ptr<PalettePreferences> palettePrefs;
     std::unique_ptr<AutosaveManager> autosaveManager;
+    std::unique_ptr<ImportManager> importManager;
     MeasurementWidget* measurementWidget = nullptr;
     InspectorPanel* inspectorPanel = nullptr;
     QLabel* hintLabel = nullptr;
@@ -232,6 +235,7 @@ private:
     QAction* actionNew = nullptr;
     QAction* actionOpen = nullptr;
     QAction* actionImport = nullptr;
+    QAction* actionCancelImport = nullptr;
     QAction* actionSave = nullptr;
     QAction* actionSaveAs = nullptr;
     QAction* actionExport = nullptr;
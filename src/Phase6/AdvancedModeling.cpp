@@ -16,6 +16,23 @@ namespace {
 
 constexpr float kEpsilon = 1e-5f;
 
+// Operations that build new objects read their inputs in world space, so the
+// results, which have no placement of their own, land where the inputs are.
+HalfEdgeMesh worldMesh(const Solid& solid)
+{
+    HalfEdgeMesh mesh = solid.getMesh();
+    if (solid.isPlaced())
+        mesh.transformVertices([&solid](const Vector3& p) { return solid.toWorld(p); });
+    return mesh;
+}
+
+// copy is a fresh clone of source and so has lost its placement.
+void bakePlacement(Solid& copy, const GeometryObject& source)
+{
+    if (source.isPlaced())
+        copy.applyTransform([&source](const Vector3& p) { return source.toWorld(p); });
+}
+
 long long makeUndirectedEdge(int a, int b)
 {
     if (a > b)
@@ -799,8 +816,8 @@ CurveIt::CurveIt(GeometryKernel& kernel)
 
 Solid* CurveIt::loft(const Curve& start, const Curve& end, const LoftOptions& options) const
 {
-    auto baseLoop = start.getBoundaryLoop();
-    auto topLoop = end.getBoundaryLoop();
+    auto baseLoop = start.toWorld(start.getBoundaryLoop());
+    auto topLoop = end.toWorld(end.getBoundaryLoop());
     if (baseLoop.size() < 3 || topLoop.size() < 3)
         return nullptr;
     int sectionCount = std::max(2, options.sections);
@@ -1020,7 +1037,7 @@ Curve* Surface::drawPolylineOnSolid(const Solid& solid, const std::vector<Vector
 {
     if (path.size() < 2)
         return nullptr;
-    const auto& mesh = solid.getMesh();
+    const HalfEdgeMesh mesh = worldMesh(solid);
     const auto& verts = mesh.getVertices();
     if (verts.empty())
         return nullptr;
@@ -1084,6 +1101,12 @@ Curve* BezierKnife::cut(const Solid& solid, const std::vector<Vector3>& controlP
     std::vector<Vector3> sampled = sampleBezierPath(controlPoints, options.samplesPerSegment);
     if (sampled.size() < 2)
         return nullptr;
+    // The solid is cut in its own space; the imprint is returned in world space.
+    if (solid.isPlaced()) {
+        const GeometryTransforms::Matrix4 toObject = GeometryTransforms::inverseAffine(solid.placement());
+        for (auto& point : sampled)
+            point = GeometryTransforms::transformPoint(toObject, point);
+    }
 
     const auto& triangles = mesh.getTriangles();
     const auto& vertsRef = mesh.getVertices();
@@ -1220,7 +1243,7 @@ Curve* BezierKnife::cut(const Solid& solid, const std::vector<Vector3>& controlP
     if (!imprint.empty() && (imprint.front() - imprint.back()).length() > kEpsilon)
         imprint.push_back(imprint.front());
 
-    GeometryObject* object = geometry.addCurve(imprint);
+    GeometryObject* object = geometry.addCurve(solid.toWorld(imprint));
     if (!object || object->getType() != ObjectType::Curve)
         return nullptr;
     updateSolidMetadata(writableSolid);
@@ -1785,7 +1808,7 @@ CADDesigner::CADDesigner(GeometryKernel& kernel)
 
 Solid* CADDesigner::revolve(const Curve& profile, const RevolveOptions& options) const
 {
-    auto loop = profile.getBoundaryLoop();
+    auto loop = profile.toWorld(profile.getBoundaryLoop());
     if (loop.size() < 3)
         return nullptr;
     int segments = std::max(3, options.segments);
@@ -1836,7 +1859,7 @@ Solid* CADDesigner::sweep(const Curve& profile, const std::vector<Vector3>& path
 {
     if (path.size() < 2)
         return nullptr;
-    auto loop = profile.getBoundaryLoop();
+    auto loop = profile.toWorld(profile.getBoundaryLoop());
     if (loop.size() < 3)
         return nullptr;
     float spacing = std::max(0.05f, 1.0f / std::max(1, options.samples));
@@ -1876,7 +1899,7 @@ Solid* CADDesigner::mirror(const Solid& solid, const Vector3& planePoint, const
     Vector3 normal = planeNormal.normalized();
     if (normal.lengthSquared() <= kEpsilon)
         return nullptr;
-    HalfEdgeMesh mesh = solid.getMesh();
+    HalfEdgeMesh mesh = worldMesh(solid);
     for (auto& vertex : mesh.getVertices()) {
         Vector3 relative = vertex.position - planePoint;
         float distance = relative.dot(normal);
@@ -1901,6 +1924,7 @@ Solid* CADDesigner::shell(const Solid& solid, const ShellOptions& options) const
     if (!copy || copy->getType() != ObjectType::Solid)
         return nullptr;
     Solid* shellSolid = static_cast<Solid*>(copy);
+    bakePlacement(*shellSolid, solid);
     PushAndPull thickener;
     PushPullOptions opts;
     opts.distance = options.thickness;
@@ -1923,6 +1947,7 @@ std::vector<Solid*> CADDesigner::pattern(const Solid& solid, const PatternOption
         if (!copy || copy->getType() != ObjectType::Solid)
             continue;
         Solid* inst = static_cast<Solid*>(copy);
+        bakePlacement(*inst, solid);
         Vector3 offset = options.translationStep * static_cast<float>(i);
         inst->translate(offset);
         if (std::fabs(options.rotationStepDegrees) > kEpsilon) {
@@ -1940,6 +1965,7 @@ Solid* CADDesigner::split(const Solid& solid, const SplitOptions& options) const
     if (!copy || copy->getType() != ObjectType::Solid)
         return nullptr;
     Solid* splitSolid = static_cast<Solid*>(copy);
+    bakePlacement(*splitSolid, solid);
     auto& mesh = splitSolid->getMesh();
     auto loops = extractFaceLoops(mesh);
     const auto& verts = mesh.getVertices();
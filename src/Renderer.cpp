@@ -31,6 +31,7 @@ layout(location = 0) in vec3 a_position;
 layout(location = 1) in vec4 a_color;
 
 uniform mat4 u_mvp;
+uniform mat4 u_model;
 uniform int u_clipPlaneCount;
 uniform vec4 u_clipPlanes[4];
 
@@ -38,10 +39,11 @@ out vec4 v_color;
 
 void main() {
     v_color = a_color;
-    gl_Position = u_mvp * vec4(a_position, 1.0);
+    vec4 worldPosition = u_model * vec4(a_position, 1.0);
+    gl_Position = u_mvp * worldPosition;
     for (int i = 0; i < 4; ++i) {
         if (i < u_clipPlaneCount) {
-            gl_ClipDistance[i] = dot(vec4(a_position, 1.0), u_clipPlanes[i]);
+            gl_ClipDistance[i] = dot(worldPosition, u_clipPlanes[i]);
         } else {
             gl_ClipDistance[i] = 1.0;
         }
@@ -244,6 +246,7 @@ void Renderer::beginFrame(const QMatrix4x4& projection, const QMatrix4x4& view,
         lightDir = QVector3D(0.0f, 1.0f, 0.0f);
 
     clipPlaneCount = 0;
+    modelTransform.setToIdentity();
     boundsValid = false;
     triangleBufferDirty = true;
     shadowMapReady = false;
@@ -258,6 +261,16 @@ void Renderer::setClipPlanes(const std::vector<QVector4D>& planes)
         clipPlanes[static_cast<size_t>(i)] = QVector4D();
 }
 
+void Renderer::setModelTransform(const QMatrix4x4& model)
+{
+    modelTransform = model;
+}
+
+void Renderer::resetModelTransform()
+{
+    modelTransform.setToIdentity();
+}
+
 void Renderer::expandBounds(const QVector3D& point)
 {
     if (!boundsValid) {
@@ -287,7 +300,8 @@ Renderer::LineBatch& Renderer::fetchBatch(float width,
             && batch.config.blend == blend
             && batch.config.category == category
             && batch.config.stippled == stippled
-            && qFuzzyCompare(batch.config.stippleScale, stippleScale)) {
+            && qFuzzyCompare(batch.config.stippleScale, stippleScale)
+            && batch.config.model == modelTransform) {
             return batch;
         }
     }
@@ -298,6 +312,7 @@ Renderer::LineBatch& Renderer::fetchBatch(float width,
     batch.config.category = category;
     batch.config.stippled = stippled;
     batch.config.stippleScale = stippleScale;
+    batch.config.model = modelTransform;
     lineBatches.push_back(std::move(batch));
     return lineBatches.back();
 }
@@ -421,6 +436,7 @@ void Renderer::ensureLineState(const LineBatch& batch)
 
     lineProgram.bind();
     lineProgram.setUniformValue("u_mvp", mvp);
+    lineProgram.setUniformValue("u_model", batch.config.model);
     lineProgram.setUniformValue("u_clipPlaneCount", clipPlaneCount);
     if (clipPlaneCount > 0)
         lineProgram.setUniformValueArray("u_clipPlanes", clipPlanes.data(), clipPlaneCount);
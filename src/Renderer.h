@@ -47,6 +47,11 @@ public:
     void beginFrame(const QMatrix4x4& projection, const QMatrix4x4& view, RenderStyle style);
     void setLightingOptions(const LightingOptions& options);
     void setClipPlanes(const std::vector<QVector4D>& planes);
+    // Lines added until resetModelTransform() are drawn with model applied in
+    // the vertex shader, so a transformed preview can reuse the untransformed
+    // vertices of what it previews. Triangles are not affected.
+    void setModelTransform(const QMatrix4x4& model);
+    void resetModelTransform();
 
     void addLineSegments(const std::vector<QVector3D>& segments,
                          const QVector4D& color,
@@ -94,6 +99,7 @@ private:
         LineCategory category = LineCategory::Generic;
         bool stippled = false;
         float stippleScale = 8.0f;
+        QMatrix4x4 model;
     };
 
     struct LineBatch {
@@ -147,6 +153,7 @@ private:
     int clipPlaneCount = 0;
 
     QMatrix4x4 mvp;
+    QMatrix4x4 modelTransform;
     QMatrix3x3 normalMatrix;
     QVector3D lightDir;
     RenderStyle currentStyle = RenderStyle::ShadedWithEdges;
@@ -55,12 +55,47 @@ Vector3 centroidFromGeometry(const GeometryObject& object)
     return sum * inv;
 }
 
-void translateGeometry(GeometryObject& object, const Vector3& delta)
+GeometryTransforms::Matrix4 localMatrix(const Scene::Document::Transform& transform)
 {
-    if (object.getType() == ObjectType::Curve)
-        static_cast<Curve&>(object).translate(delta);
-    else
-        static_cast<Solid&>(object).translate(delta);
+    return GeometryTransforms::composeTransform(transform.position, transform.rotation, transform.scale);
+}
+
+Scene::Document::Transform transformFromMatrix(const GeometryTransforms::Matrix4& matrix)
+{
+    Scene::Document::Transform transform;
+    GeometryTransforms::decomposeTransform(matrix, transform.position, transform.rotation, transform.scale);
+    return transform;
+}
+
+bool nearlyEqual(const Vector3& a, const Vector3& b)
+{
+    return (a - b).lengthSquared() <= 1e-10f;
+}
+
+bool sameTransform(const Scene::Document::Transform& a, const Scene::Document::Transform& b)
+{
+    return nearlyEqual(a.position, b.position) && nearlyEqual(a.rotation, b.rotation) && nearlyEqual(a.scale, b.scale);
+}
+
+float& component(Vector3& v, std::size_t axis)
+{
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+// Whether node has the shape proto would instantiate, so it can be refreshed
+// in place.
+bool matchesPrototype(const Scene::Document::ObjectNode& node, const Scene::Document::PrototypeNode& proto)
+{
+    if (node.kind != proto.kind || !node.geometry != !proto.geometry
+        || node.children.size() != proto.children.size())
+        return false;
+    if (node.geometry && node.geometry->getType() != proto.geometry->getType())
+        return false;
+    for (std::size_t i = 0; i < proto.children.size(); ++i) {
+        if (!matchesPrototype(*node.children[i], *proto.children[i]))
+            return false;
+    }
+    return true;
 }
 
 } // namespace
@@ -119,39 +154,82 @@ const GeometryObject* Document::geometryForObject(ObjectId id) const
 Document::Transform Document::objectTransform(ObjectId id) const
 {
     Transform transform;
-    const GeometryObject* object = geometryForObject(id);
-    if (object)
-        transform.position = centroidFromGeometry(*object);
-    transform.rotation = Vector3(0.0f, 0.0f, 0.0f);
-    transform.scale = Vector3(1.0f, 1.0f, 1.0f);
+    const ObjectNode* node = findConst(id);
+    if (!node)
+        return transform;
+    transform = node->transform;
+    transform.position = GeometryTransforms::transformPoint(worldMatrix(*node), localCenter(*node));
     return transform;
 }
 
 bool Document::applyTransform(ObjectId id, const Transform& transform, const TransformMask& mask)
 {
-    GeometryObject* object = geometryForObject(id);
-    if (!object)
+    ObjectNode* node = findMutable(id);
+    if (!node || node == rootNode.get())
         return false;
 
-    bool changed = false;
-    if (mask.position[0] || mask.position[1] || mask.position[2]) {
-        Transform current = objectTransform(id);
-        Vector3 target = current.position;
-        if (mask.position[0])
-            target.x = transform.position.x;
-        if (mask.position[1])
-            target.y = transform.position.y;
-        if (mask.position[2])
-            target.z = transform.position.z;
-        Vector3 delta = target - current.position;
-        if (delta.lengthSquared() > 1e-10f) {
-            translateGeometry(*object, delta);
-            changed = true;
-        }
-    }
+    Transform next = node->transform;
+    Vector3 target = objectTransform(id).position;
+    Transform requested = transform;
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        if (mask.position[axis])
+            component(target, axis) = component(requested.position, axis);
+        if (mask.rotation[axis])
+            component(next.rotation, axis) = component(requested.rotation, axis);
+        if (mask.scale[axis])
+            component(next.scale, axis) = component(requested.scale, axis);
+    }
+
+    // Choose the translation that puts the geometry centre on target under
+    // the new rotation and scale.
+    const GeometryTransforms::Matrix4 parentWorld = parentWorldMatrix(*node);
+    const Vector3 targetInParent = GeometryTransforms::transformPoint(GeometryTransforms::inverseAffine(parentWorld), target);
+    const GeometryTransforms::Matrix4 rotateScale = GeometryTransforms::composeTransform(Vector3(), next.rotation, next.scale);
+    next.position = targetInParent - GeometryTransforms::transformPoint(rotateScale, localCenter(*node));
+    if (sameTransform(next, node->transform))
+        return false;
+
+    node->transform = next;
+    updatePlacements(*node, parentWorld);
+    return true;
+}
 
-    // Rotation and scale editing are not yet supported.
-    return changed;
+bool Document::setLocalTransform(ObjectId id, const Transform& transform)
+{
+    ObjectNode* node = findMutable(id);
+    if (!node || node == rootNode.get())
+        return false;
+    node->transform = transform;
+    updatePlacements(*node, parentWorldMatrix(*node));
+    return true;
+}
+
+bool Document::translateObject(ObjectId id, const Vector3& delta)
+{
+    ObjectNode* node = findMutable(id);
+    if (!node || node == rootNode.get())
+        return false;
+    const GeometryTransforms::Matrix4 parentWorld = parentWorldMatrix(*node);
+    node->transform.position += GeometryTransforms::transformDirection(GeometryTransforms::inverseAffine(parentWorld), delta);
+    updatePlacements(*node, parentWorld);
+    return true;
+}
+
+GeometryTransforms::Matrix4 Document::worldTransform(ObjectId id) const
+{
+    const ObjectNode* node = findConst(id);
+    return node ? worldMatrix(*node) : GeometryTransforms::identityMatrix();
+}
+
+bool Document::setWorldTransform(ObjectId id, const GeometryTransforms::Matrix4& world)
+{
+    ObjectNode* node = findMutable(id);
+    if (!node || node == rootNode.get())
+        return false;
+    const GeometryTransforms::Matrix4 parentWorld = parentWorldMatrix(*node);
+    node->transform = transformFromMatrix(GeometryTransforms::multiply(GeometryTransforms::inverseAffine(parentWorld), world));
+    updatePlacements(*node, parentWorld);
+    return true;
 }
 
 Document::ObjectId Document::ensureObjectForGeometry(GeometryObject* object, const std::string& name)
@@ -168,7 +246,7 @@ Document::ObjectId Document::ensureObjectForGeometry(GeometryObject* object, con
     ObjectNode* node = addNode(NodeKind::Geometry, nodeName, rootNode.get());
     node->geometry = object;
     registerGeometry(node, object);
-    updateVisibility();
+    updateVisibility(*node);
     return node->id;
 }
 
@@ -184,17 +262,14 @@ void Document::synchronizeWithGeometry()
             existing.insert(id);
     }
 
-    std::vector<ObjectId> toRemove;
+    std::vector<ObjectNode*> toRemove;
     for (const auto& [geometryId, objectId] : geometryIndex) {
         if (!existing.count(geometryId)) {
-            toRemove.push_back(objectId);
-        }
-    }
-    for (ObjectId id : toRemove) {
-        if (ObjectNode* node = findMutable(id)) {
-            removeNode(node);
+            if (ObjectNode* node = findMutable(objectId))
+                toRemove.push_back(node);
         }
     }
+    removeNodes(toRemove);
 
     for (const auto& uptr : geometryKernel.getObjects()) {
         ensureObjectForGeometry(uptr.get());
@@ -208,10 +283,21 @@ void Document::pruneInvalidObjects()
 
 bool Document::removeObject(ObjectId objectId)
 {
-    ObjectNode* node = findMutable(objectId);
-    if (!node)
+    return removeObjects({ objectId });
+}
+
+bool Document::removeObjects(const std::vector<ObjectId>& objectIds)
+{
+    std::vector<ObjectNode*> nodes;
+    nodes.reserve(objectIds.size());
+    for (ObjectId id : objectIds) {
+        ObjectNode* node = findMutable(id);
+        if (node && node != rootNode.get())
+            nodes.push_back(node);
+    }
+    if (nodes.empty())
         return false;
-    removeNode(node);
+    removeNodes(nodes);
     return true;
 }
 
@@ -260,14 +346,16 @@ Document::ObjectId Document::createGroup(const std::vector<ObjectId>& childIds,
     ObjectNode* group = addNode(NodeKind::Group, name.empty() ? std::string("Group ") + std::to_string(nextObjectId) : name, firstParent);
 
     for (ObjectNode* child : children) {
+        const GeometryTransforms::Matrix4 previousParentWorld = parentWorldMatrix(*child);
         std::unique_ptr<ObjectNode> owned = detachChild(child);
         if (!owned)
             continue;
         owned->parent = group;
         group->children.push_back(std::move(owned));
+        keepWorldPlacement(*child, previousParentWorld);
     }
 
-    updateVisibility();
+    updateVisibility(*group);
     return group->id;
 }
 
@@ -284,6 +372,7 @@ bool Document::moveObject(ObjectId objectId, ObjectId newParentId, std::size_t i
     if (isDescendantOf(*newParent, *node))
         return false;
 
+    const GeometryTransforms::Matrix4 previousParentWorld = parentWorldMatrix(*node);
     std::unique_ptr<ObjectNode> owned = detachChild(node);
     if (!owned)
         return false;
@@ -291,7 +380,8 @@ bool Document::moveObject(ObjectId objectId, ObjectId newParentId, std::size_t i
     auto& children = newParent->children;
     index = std::min<std::size_t>(index, children.size());
     children.insert(children.begin() + static_cast<std::ptrdiff_t>(index), std::move(owned));
-    updateVisibility();
+    keepWorldPlacement(*node, previousParentWorld);
+    updateVisibility(*node);
     return true;
 }
 
@@ -301,7 +391,7 @@ bool Document::setObjectVisible(ObjectId objectId, bool visible)
     if (!node)
         return false;
     node->visible = visible;
-    updateVisibility();
+    updateVisibility(*node);
     return true;
 }
 
@@ -319,6 +409,8 @@ Document::ComponentDefinitionId Document::createComponentDefinition(const std::v
         if (!node)
             continue;
         definition.roots.push_back(buildPrototypeFromNode(*node, definition));
+        // Instances are created at the root, so roots carry their world placement.
+        definition.roots.back()->transform = transformFromMatrix(worldMatrix(*node));
     }
 
     if (definition.roots.empty())
@@ -344,7 +436,7 @@ Document::ObjectId Document::instantiateComponent(ComponentDefinitionId definiti
     for (const auto& proto : definition.roots) {
         instance->children.push_back(instantiatePrototype(*proto, definition, instance));
     }
-    updateVisibility();
+    updateVisibility(*instance);
     return instance->id;
 }
 
@@ -379,6 +471,26 @@ bool Document::makeComponentUnique(ObjectId instanceId)
     return true;
 }
 
+bool Document::updateComponentDefinition(ObjectId instanceId)
+{
+    ObjectNode* instance = findMutable(instanceId);
+    if (!instance || instance->kind != NodeKind::ComponentInstance)
+        return false;
+    auto defIt = componentDefinitions.find(instance->definitionId);
+    if (defIt == componentDefinitions.end())
+        return false;
+
+    // The prototypes share mesh storage with the instance, so this copies no
+    // meshes and the instance itself is left as it is by the refresh.
+    ComponentDefinition& definition = defIt->second;
+    definition.roots.clear();
+    definition.geometry.clear();
+    for (const auto& child : instance->children)
+        definition.roots.push_back(buildPrototypeFromNode(*child, definition));
+    refreshComponentInstances(definition.id);
+    return true;
+}
+
 void Document::refreshComponentInstances(ComponentDefinitionId definitionId)
 {
     auto defIt = componentDefinitions.find(definitionId);
@@ -389,17 +501,26 @@ void Document::refreshComponentInstances(ComponentDefinitionId definitionId)
     if (instIt == componentInstances.end())
         return;
 
+    const auto& roots = defIt->second.roots;
     for (ObjectId id : instIt->second) {
         ObjectNode* instance = findMutable(id);
         if (!instance)
             continue;
-        removeChildGeometry(*instance);
-        instance->children.clear();
-        for (const auto& proto : defIt->second.roots) {
-            instance->children.push_back(instantiatePrototype(*proto, defIt->second, instance));
+        bool matches = instance->children.size() == roots.size();
+        for (std::size_t i = 0; matches && i < roots.size(); ++i)
+            matches = matchesPrototype(*instance->children[i], *roots[i]);
+        if (matches) {
+            for (std::size_t i = 0; i < roots.size(); ++i)
+                refreshFromPrototype(*instance->children[i], *roots[i]);
+        } else {
+            removeChildGeometry(*instance);
+            instance->children.clear();
+            for (const auto& proto : roots)
+                instance->children.push_back(instantiatePrototype(*proto, defIt->second, instance));
         }
+        updatePlacements(*instance, parentWorldMatrix(*instance));
+        updateVisibility(*instance);
     }
-    updateVisibility();
 }
 
 Document::TagId Document::createTag(const std::string& name, const SceneSettings::Color& color)
@@ -436,8 +557,17 @@ bool Document::setTagVisible(TagId id, bool visible)
     auto it = tagMap.find(id);
     if (it == tagMap.end())
         return false;
+    if (it->second.visible == visible)
+        return true;
     it->second.visible = visible;
-    updateVisibility();
+    auto membersIt = tagMembers.find(id);
+    if (membersIt == tagMembers.end())
+        return true;
+    const std::unordered_set<ObjectId> path = isolationPath();
+    for (ObjectId objectId : membersIt->second) {
+        if (ObjectNode* node = findMutable(objectId))
+            updateTaggedVisibility(*node, path);
+    }
     return true;
 }
 
@@ -448,8 +578,9 @@ bool Document::assignTag(ObjectId objectId, TagId tagId)
         return false;
     if (!contains(node->tags, tagId)) {
         node->tags.push_back(tagId);
+        tagMembers[tagId].insert(node->id);
+        updateTaggedVisibility(*node, isolationPath());
     }
-    updateVisibility();
     return true;
 }
 
@@ -462,10 +593,63 @@ bool Document::removeTag(ObjectId objectId, TagId tagId)
     if (it == node->tags.end())
         return false;
     node->tags.erase(it, node->tags.end());
-    updateVisibility();
+    unindexTag(tagId, node->id);
+    updateTaggedVisibility(*node, isolationPath());
+    return true;
+}
+
+bool Document::assignTagToObjects(const std::vector<ObjectId>& objectIds, TagId tagId)
+{
+    if (tagMap.find(tagId) == tagMap.end())
+        return false;
+    const std::unordered_set<ObjectId> path = isolationPath();
+    for (ObjectId objectId : objectIds) {
+        ObjectNode* node = findMutable(objectId);
+        if (!node || node == rootNode.get() || !tagMembers[tagId].insert(objectId).second)
+            continue;
+        node->tags.push_back(tagId);
+        updateTaggedVisibility(*node, path);
+    }
     return true;
 }
 
+bool Document::removeTagFromObjects(const std::vector<ObjectId>& objectIds, TagId tagId)
+{
+    auto membersIt = tagMembers.find(tagId);
+    if (membersIt == tagMembers.end())
+        return false;
+    std::vector<ObjectNode*> changed;
+    for (ObjectId objectId : objectIds) {
+        if (membersIt->second.erase(objectId) == 0)
+            continue;
+        if (ObjectNode* node = findMutable(objectId)) {
+            node->tags.erase(std::remove(node->tags.begin(), node->tags.end(), tagId), node->tags.end());
+            changed.push_back(node);
+        }
+    }
+    if (membersIt->second.empty())
+        tagMembers.erase(membersIt);
+    if (changed.empty())
+        return false;
+    const std::unordered_set<ObjectId> path = isolationPath();
+    for (ObjectNode* node : changed)
+        updateTaggedVisibility(*node, path);
+    return true;
+}
+
+const std::unordered_set<Document::ObjectId>& Document::taggedObjects(TagId tagId) const
+{
+    static const std::unordered_set<ObjectId> none;
+    auto it = tagMembers.find(tagId);
+    return it != tagMembers.end() ? it->second : none;
+}
+
+bool Document::hasTag(ObjectId objectId, TagId tagId) const
+{
+    auto it = tagMembers.find(tagId);
+    return it != tagMembers.end() && it->second.count(objectId) > 0;
+}
+
 bool Document::deleteTag(TagId id, std::vector<ObjectId>* affectedObjects)
 {
     auto it = tagMap.find(id);
@@ -473,17 +657,21 @@ bool Document::deleteTag(TagId id, std::vector<ObjectId>* affectedObjects)
         return false;
     tagMap.erase(it);
 
-    forEachNode([&](ObjectNode& node) {
-        if (node.id == 0)
-            return;
-        auto tagIt = std::remove(node.tags.begin(), node.tags.end(), id);
-        if (tagIt != node.tags.end()) {
-            if (affectedObjects)
-                affectedObjects->push_back(node.id);
-            node.tags.erase(tagIt, node.tags.end());
-        }
-    });
-    updateVisibility();
+    auto membersIt = tagMembers.find(id);
+    if (membersIt == tagMembers.end())
+        return true;
+    const std::unordered_set<ObjectId> members = std::move(membersIt->second);
+    tagMembers.erase(membersIt);
+    const std::unordered_set<ObjectId> path = isolationPath();
+    for (ObjectId objectId : members) {
+        ObjectNode* node = findMutable(objectId);
+        if (!node)
+            continue;
+        node->tags.erase(std::remove(node->tags.begin(), node->tags.end(), id), node->tags.end());
+        if (affectedObjects)
+            affectedObjects->push_back(objectId);
+        updateTaggedVisibility(*node, path);
+    }
     return true;
 }
 
@@ -494,14 +682,17 @@ bool Document::restoreTag(const Tag& tag, const std::vector<ObjectId>& assignmen
     tagMap[tag.id] = tag;
     nextTagId = std::max(nextTagId, tag.id + 1);
 
+    const std::unordered_set<ObjectId> path = isolationPath();
     for (ObjectId objectId : assignments) {
         ObjectNode* node = findMutable(objectId);
         if (!node)
             continue;
-        if (!contains(node->tags, tag.id))
+        if (!contains(node->tags, tag.id)) {
             node->tags.push_back(tag.id);
+            tagMembers[tag.id].insert(node->id);
+        }
+        updateTaggedVisibility(*node, path);
     }
-    updateVisibility();
     return true;
 }
 
@@ -535,6 +726,89 @@ void Document::clearIsolation()
     updateVisibility();
 }
 
+SelectionSet::ListenerId Document::addSelectionListener(SelectionSet::Listener listener)
+{
+    return selectionSet.addListener(std::move(listener));
+}
+
+void Document::removeSelectionListener(SelectionSet::ListenerId id)
+{
+    selectionSet.removeListener(id);
+}
+
+bool Document::setObjectSelected(ObjectId objectId, bool selected)
+{
+    GeometryObject* geometry = geometryForObject(objectId);
+    if (!geometry)
+        return false;
+    // selectionChanged() updates the set.
+    geometry->setSelected(selected);
+    return true;
+}
+
+void Document::setSelection(const std::vector<ObjectId>& objectIds)
+{
+    beginSelectionBatch();
+    const std::unordered_set<ObjectId> wanted(objectIds.begin(), objectIds.end());
+    const std::vector<ObjectId> current = selectionSet.ids();
+    for (ObjectId id : current) {
+        if (wanted.count(id))
+            continue;
+        if (GeometryObject* geometry = geometryForObject(id))
+            geometry->setSelected(false);
+        else
+            selectionSet.erase(id);
+    }
+    for (ObjectId id : objectIds)
+        setObjectSelected(id, true);
+    endSelectionBatch();
+}
+
+void Document::clearSelection()
+{
+    setSelection({});
+}
+
+std::vector<GeometryObject*> Document::selectedGeometry() const
+{
+    std::vector<GeometryObject*> result;
+    result.reserve(selectionSet.size());
+    for (ObjectId id : selectionSet.ids()) {
+        const ObjectNode* node = findConst(id);
+        if (node && node->geometry)
+            result.push_back(node->geometry);
+    }
+    return result;
+}
+
+void Document::selectionChanged(GeometryObject& object, bool selected)
+{
+    auto it = geometryIndex.find(object.getStableId());
+    if (it == geometryIndex.end())
+        return;
+    const bool changed = selected ? selectionSet.insert(it->second) : selectionSet.erase(it->second);
+    if (changed)
+        selectionEdited();
+}
+
+void Document::beginSelectionBatch()
+{
+    if (selectionBatchDepth++ == 0)
+        selectionBatchRevision = selectionSet.revision();
+}
+
+void Document::endSelectionBatch()
+{
+    if (--selectionBatchDepth == 0 && selectionSet.revision() != selectionBatchRevision)
+        selectionSet.notify();
+}
+
+void Document::selectionEdited()
+{
+    if (selectionBatchDepth == 0)
+        selectionSet.notify();
+}
+
 Document::SceneId Document::createScene(const std::string& name, const CameraController& camera)
 {
     SceneState state;
@@ -609,6 +883,8 @@ void Document::resetInternal(bool clearGeometry)
 {
     if (clearGeometry)
         geometryKernel.clear();
+    if (selectionSet.clear())
+        selectionEdited();
     planes.clear();
     sceneSettings.reset();
     rootNode = std::make_unique<ObjectNode>();
@@ -621,6 +897,7 @@ void Document::resetInternal(bool clearGeometry)
     componentInstances.clear();
     sceneMap.clear();
     tagMap.clear();
+    tagMembers.clear();
     colorByTagEnabled = false;
     isolationIds.clear();
     importedProvenance.clear();
@@ -628,6 +905,7 @@ void Document::resetInternal(bool clearGeometry)
     externalReferenceMetadata.clear();
     lastImportErrorMessage.clear();
     lastSceneIoErrorMessage.clear();
+    saveState = SceneSerializer::SaveState();
     nextObjectId = 1;
     nextTagId = 1;
     nextDefinitionId = 1;
@@ -637,7 +915,12 @@ void Document::resetInternal(bool clearGeometry)
 
 bool Document::saveToFile(const std::string& filename) const
 {
-    SceneSerializer::Result result = SceneSerializer::save(*this, filename);
+    return saveToFile(filename, SceneSerializer::SaveOptions());
+}
+
+bool Document::saveToFile(const std::string& filename, const SceneSerializer::SaveOptions& options) const
+{
+    SceneSerializer::Result result = SceneSerializer::save(*this, filename, options);
     if (result.status == SceneSerializer::Result::Status::Success) {
         lastSceneIoErrorMessage.clear();
         return true;
@@ -765,35 +1048,125 @@ bool Document::loadLegacyFromFile(const std::string& filename)
 }
 
 bool Document::importExternalModel(const std::string& path, FileFormat fmt)
+{
+    Document staging;
+    auto importResult = FileIO::Importers::FileImporter::import(QString::fromStdString(path), staging, fmt);
+    return commitImport(staging, importResult, path);
+}
+
+bool Document::commitImport(Document& staging, const FileIO::Importers::ImportResult& result, const std::string& path)
 {
     lastImportErrorMessage.clear();
-    QString qPath = QString::fromStdString(path);
-    auto importResult = FileIO::Importers::FileImporter::import(qPath, *this, fmt);
-    if (!importResult.success) {
-        lastImportErrorMessage = importResult.errorMessage.toStdString();
+    if (!result.success) {
+        lastImportErrorMessage = result.errorMessage.toStdString();
         return false;
     }
 
-    if (importResult.objects.empty()) {
+    if (result.objects.empty()) {
         lastImportErrorMessage = QObject::tr("No importable geometry found").toStdString();
         return false;
     }
 
-    std::string absolutePath = QFileInfo(qPath).absoluteFilePath().toStdString();
+    std::unordered_map<ObjectId, ObjectId> mergedIds;
+    mergeDocument(staging, &mergedIds);
+
+    std::string absolutePath = QFileInfo(QString::fromStdString(path)).absoluteFilePath().toStdString();
     auto timestamp = std::chrono::system_clock::now();
-    for (const auto& summary : importResult.objects) {
-        if (summary.objectId == 0)
+    for (const auto& summary : result.objects) {
+        auto idIt = mergedIds.find(summary.objectId);
+        if (summary.objectId == 0 || idIt == mergedIds.end())
             continue;
         ImportMetadata metadata;
         metadata.sourcePath = absolutePath;
-        metadata.format = importResult.resolvedFormat;
+        metadata.format = result.resolvedFormat;
         metadata.materialSlots = summary.materialSlots;
         metadata.importedAt = timestamp;
-        importedProvenance[summary.objectId] = std::move(metadata);
+        importedProvenance[idIt->second] = std::move(metadata);
+    }
+    return true;
+}
+
+void Document::mergeDocument(Document& staging, std::unordered_map<ObjectId, ObjectId>* idMap)
+{
+    if (&staging == this)
+        return;
+
+    std::unordered_map<TagId, TagId> tagIds;
+    for (const auto& [id, tag] : staging.tagMap) {
+        Tag merged = tag;
+        merged.id = nextTagId++;
+        tagIds.emplace(id, merged.id);
+        tagMap.emplace(merged.id, std::move(merged));
+    }
+    auto remapTags = [&tagIds](std::vector<TagId>& tags) {
+        for (TagId& tag : tags) {
+            auto it = tagIds.find(tag);
+            if (it != tagIds.end())
+                tag = it->second;
+        }
+    };
+
+    std::unordered_map<ComponentDefinitionId, ComponentDefinitionId> definitionIds;
+    for (auto& [id, definition] : staging.componentDefinitions) {
+        const ComponentDefinitionId mergedId = nextDefinitionId++;
+        definitionIds.emplace(id, mergedId);
+        definition.id = mergedId;
+        std::vector<PrototypeNode*> prototypes;
+        for (auto& root : definition.roots)
+            prototypes.push_back(root.get());
+        while (!prototypes.empty()) {
+            PrototypeNode* proto = prototypes.back();
+            prototypes.pop_back();
+            remapTags(proto->tags);
+            for (auto& child : proto->children)
+                prototypes.push_back(child.get());
+        }
+        componentDefinitions.emplace(mergedId, std::move(definition));
+    }
+
+    // Stable ids change here; the nodes' geometry pointers stay valid.
+    geometryKernel.adoptObjects(staging.geometryKernel);
+
+    std::unordered_map<ObjectId, ObjectId> objectIds;
+    for (auto& root : staging.rootNode->children) {
+        root->parent = rootNode.get();
+        std::vector<ObjectNode*> stack{ root.get() };
+        while (!stack.empty()) {
+            ObjectNode* node = stack.back();
+            stack.pop_back();
+            const ObjectId mergedId = nextObjectId++;
+            objectIds.emplace(node->id, mergedId);
+            node->id = mergedId;
+            if (node->definitionId != 0) {
+                auto it = definitionIds.find(node->definitionId);
+                node->definitionId = it != definitionIds.end() ? it->second : 0;
+            }
+            remapTags(node->tags);
+            registerNode(node);
+            if (node->geometry)
+                registerGeometry(node, node->geometry);
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it)
+                stack.push_back(it->get());
+        }
+        rootNode->children.push_back(std::move(root));
     }
+    staging.rootNode->children.clear();
 
+    auto moveMetadata = [&objectIds](auto& from, auto& to) {
+        for (auto& [id, metadata] : from) {
+            auto it = objectIds.find(id);
+            if (it != objectIds.end())
+                to[it->second] = std::move(metadata);
+        }
+    };
+    moveMetadata(staging.importedProvenance, importedProvenance);
+    moveMetadata(staging.imagePlaneMetadata, imagePlaneMetadata);
+    moveMetadata(staging.externalReferenceMetadata, externalReferenceMetadata);
+
+    staging.reset();
+    if (idMap)
+        *idMap = std::move(objectIds);
     updateVisibility();
-    return true;
 }
 
 void Document::setImagePlaneMetadata(ObjectId id, const ImagePlaneMetadata& metadata)
@@ -826,26 +1199,73 @@ void Document::clearExternalReferenceMetadata(ObjectId id)
 
 void Document::removeNode(ObjectNode* node)
 {
-    if (!node || node == rootNode.get())
+    removeNodes({ node });
+}
+
+void Document::removeNodes(const std::vector<ObjectNode*>& nodes)
+{
+    std::unordered_set<ObjectNode*> targets;
+    targets.reserve(nodes.size());
+    for (ObjectNode* node : nodes) {
+        if (node && node != rootNode.get())
+            targets.insert(node);
+    }
+    if (targets.empty())
         return;
-    while (!node->children.empty()) {
-        removeNode(node->children.back().get());
+
+    beginSelectionBatch();
+    // Only the topmost targets are detached; their subtrees go with them.
+    std::unordered_map<ObjectNode*, std::unordered_set<ObjectNode*>> detachByParent;
+    std::vector<GeometryObject*> geometry;
+    std::vector<ObjectNode*> stack;
+    bool removesIsolated = false;
+    for (ObjectNode* node : targets) {
+        bool covered = false;
+        for (ObjectNode* ancestor = node->parent; ancestor && !covered; ancestor = ancestor->parent)
+            covered = targets.count(ancestor) > 0;
+        if (covered)
+            continue;
+        if (node->parent)
+            detachByParent[node->parent].insert(node);
+
+        stack.assign(1, node);
+        while (!stack.empty()) {
+            ObjectNode* current = stack.back();
+            stack.pop_back();
+            if (current->geometry) {
+                unregisterGeometry(current->geometry);
+                geometry.push_back(current->geometry);
+                current->geometry = nullptr;
+            }
+            removesIsolated = removesIsolated || contains(isolationIds, current->id);
+            unregisterNode(current);
+            for (auto& child : current->children)
+                stack.push_back(child.get());
+        }
     }
-    if (node->geometry) {
-        GeometryObject* geom = node->geometry;
-        unregisterGeometry(geom);
-        geometryKernel.deleteObject(geom);
-        node->geometry = nullptr;
+
+    for (auto& [parent, removed] : detachByParent) {
+        auto& children = parent->children;
+        children.erase(std::remove_if(children.begin(), children.end(),
+                                      [&removed](const std::unique_ptr<ObjectNode>& child) {
+                                          return removed.count(child.get()) > 0;
+                                      }),
+                       children.end());
     }
-    unregisterNode(node);
-    detachFromParent(node);
+    geometryKernel.deleteObjects(geometry);
+    // Isolating a removed node no longer hides anything.
+    if (removesIsolated)
+        updateVisibility();
+    endSelectionBatch();
 }
 
 void Document::removeChildGeometry(ObjectNode& node)
 {
-    while (!node.children.empty()) {
-        removeNode(node.children.back().get());
-    }
+    std::vector<ObjectNode*> children;
+    children.reserve(node.children.size());
+    for (auto& child : node.children)
+        children.push_back(child.get());
+    removeNodes(children);
 }
 
 void Document::forEachNode(const std::function<void(ObjectNode&)>& fn)
@@ -878,9 +1298,11 @@ void Document::forEachNode(const std::function<void(const ObjectNode&)>& fn) con
 
 void Document::rebuildIndices()
 {
+    beginSelectionBatch();
     nodeIndex.clear();
     geometryIndex.clear();
     componentInstances.clear();
+    tagMembers.clear();
     forEachNode([&](ObjectNode& node) {
         if (node.id == 0)
             return;
@@ -889,67 +1311,88 @@ void Document::rebuildIndices()
             registerGeometry(&node, node.geometry);
         }
     });
+    const std::vector<ObjectId> selected = selectionSet.ids();
+    for (ObjectId id : selected) {
+        if (!geometryForObject(id))
+            selectionSet.erase(id);
+    }
+    endSelectionBatch();
 }
 
 void Document::updateVisibility()
 {
-    std::unordered_set<TagId> hiddenTags;
-    for (const auto& [id, tag] : tagMap) {
-        if (!tag.visible)
-            hiddenTags.insert(id);
-    }
+    applyVisibilityRecursive(*rootNode, isolationPath(), false, true);
+}
 
-    std::unordered_set<ObjectId> isolationSet;
-    if (!isolationIds.empty()) {
-        for (ObjectId id : isolationIds) {
-            const ObjectNode* node = findConst(id);
-            if (!node)
-                continue;
-            const ObjectNode* current = node;
-            while (current) {
-                isolationSet.insert(current->id);
-                current = current->parent;
-            }
-            collectIsolationIds(*node, isolationSet);
-        }
-    }
+void Document::updateVisibility(ObjectNode& node)
+{
+    const std::unordered_set<ObjectId> path = isolationPath();
+    bool isolated = false;
+    const bool ancestorsShown = ancestorsShowChildren(node, path, isolated);
+    applyVisibilityRecursive(node, path, isolated, ancestorsShown);
+}
 
-    applyVisibilityRecursive(*rootNode, hiddenTags, isolationSet, true);
+void Document::updateTaggedVisibility(ObjectNode& node, const std::unordered_set<ObjectId>& isolationPath)
+{
+    // Tags only hide the geometry they are assigned to, not its descendants.
+    if (node.kind != NodeKind::Geometry || !node.geometry)
+        return;
+    bool isolated = false;
+    const bool shown = ancestorsShowChildren(node, isolationPath, isolated) && showsChildren(node, isolationPath, isolated);
+    applyGeometryVisibility(node, shown);
 }
 
-void Document::applyVisibilityRecursive(ObjectNode& node, const std::unordered_set<TagId>& hiddenTags,
-                                        const std::unordered_set<ObjectId>& isolatedIds, bool ancestorVisible)
+void Document::applyVisibilityRecursive(ObjectNode& node, const std::unordered_set<ObjectId>& isolationPath,
+                                        bool isolated, bool ancestorVisible)
 {
-    bool nodeVisible = ancestorVisible && node.visible;
-    bool isolationActive = !isolatedIds.empty();
-    bool nodeAllowed = !isolationActive || isolatedIds.count(node.id) > 0 || node.kind == NodeKind::Root;
+    const bool shown = ancestorVisible && showsChildren(node, isolationPath, isolated);
+    if (node.kind == NodeKind::Geometry && node.geometry)
+        applyGeometryVisibility(node, shown);
+    for (auto& child : node.children) {
+        applyVisibilityRecursive(*child, isolationPath, isolated, shown);
+    }
+}
 
-    if (node.kind == NodeKind::Geometry && node.geometry) {
-        bool hidden = !(nodeVisible && nodeAllowed);
-        if (!hidden) {
-            for (TagId tagId : node.tags) {
-                if (hiddenTags.count(tagId)) {
-                    hidden = true;
-                    break;
-                }
-            }
-        }
-        node.geometry->setHidden(hidden);
-        node.geometry->setVisible(!hidden);
+void Document::applyGeometryVisibility(ObjectNode& node, bool shown)
+{
+    bool hidden = !shown;
+    for (std::size_t i = 0; i < node.tags.size() && !hidden; ++i) {
+        auto tagIt = tagMap.find(node.tags[i]);
+        hidden = tagIt != tagMap.end() && !tagIt->second.visible;
     }
+    node.geometry->setHidden(hidden);
+    node.geometry->setVisible(!hidden);
+}
 
-    bool passToChildren = nodeVisible && nodeAllowed;
-    for (auto& child : node.children) {
-        applyVisibilityRecursive(*child, hiddenTags, isolatedIds, passToChildren);
+bool Document::showsChildren(const ObjectNode& node, const std::unordered_set<ObjectId>& isolationPath, bool& isolated) const
+{
+    isolated = isolated || contains(isolationIds, node.id);
+    const bool allowed = isolationPath.empty() || isolated || node.kind == NodeKind::Root
+        || isolationPath.count(node.id) > 0;
+    return node.visible && allowed;
+}
+
+bool Document::ancestorsShowChildren(const ObjectNode& node, const std::unordered_set<ObjectId>& isolationPath,
+                                     bool& isolated) const
+{
+    std::vector<const ObjectNode*> ancestors;
+    for (const ObjectNode* parent = node.parent; parent; parent = parent->parent)
+        ancestors.push_back(parent);
+    for (auto it = ancestors.rbegin(); it != ancestors.rend(); ++it) {
+        if (!showsChildren(**it, isolationPath, isolated))
+            return false;
     }
+    return true;
 }
 
-void Document::collectIsolationIds(const ObjectNode& node, std::unordered_set<ObjectId>& ids) const
+std::unordered_set<Document::ObjectId> Document::isolationPath() const
 {
-    ids.insert(node.id);
-    for (const auto& child : node.children) {
-        collectIsolationIds(*child, ids);
+    std::unordered_set<ObjectId> path;
+    for (ObjectId id : isolationIds) {
+        for (const ObjectNode* node = findConst(id); node; node = node->parent)
+            path.insert(node->id);
     }
+    return path;
 }
 
 Document::ObjectNode* Document::findMutable(ObjectId id)
@@ -979,11 +1422,59 @@ bool Document::isDescendantOf(const ObjectNode& node, const ObjectNode& ancestor
     return false;
 }
 
+GeometryTransforms::Matrix4 Document::worldMatrix(const ObjectNode& node) const
+{
+    GeometryTransforms::Matrix4 world = localMatrix(node.transform);
+    for (const ObjectNode* parent = node.parent; parent; parent = parent->parent)
+        world = GeometryTransforms::multiply(localMatrix(parent->transform), world);
+    return world;
+}
+
+GeometryTransforms::Matrix4 Document::parentWorldMatrix(const ObjectNode& node) const
+{
+    return node.parent ? worldMatrix(*node.parent) : GeometryTransforms::identityMatrix();
+}
+
+Vector3 Document::localCenter(const ObjectNode& node) const
+{
+    if (node.geometry)
+        return centroidFromGeometry(*node.geometry);
+    Vector3 sum(0.0f, 0.0f, 0.0f);
+    std::size_t count = 0;
+    for (const auto& child : node.children) {
+        if (!child->geometry && child->children.empty())
+            continue;
+        sum += GeometryTransforms::transformPoint(localMatrix(child->transform), localCenter(*child));
+        ++count;
+    }
+    return count > 0 ? sum * (1.0f / static_cast<float>(count)) : Vector3();
+}
+
+void Document::updatePlacements(ObjectNode& node, const GeometryTransforms::Matrix4& parentWorld)
+{
+    const GeometryTransforms::Matrix4 world = GeometryTransforms::multiply(parentWorld, localMatrix(node.transform));
+    if (node.geometry)
+        node.geometry->setPlacement(world);
+    for (auto& child : node.children)
+        updatePlacements(*child, world);
+}
+
+void Document::keepWorldPlacement(ObjectNode& node, const GeometryTransforms::Matrix4& previousParentWorld)
+{
+    const GeometryTransforms::Matrix4 parentWorld = parentWorldMatrix(node);
+    if (parentWorld == previousParentWorld)
+        return;
+    const GeometryTransforms::Matrix4 world = GeometryTransforms::multiply(previousParentWorld, localMatrix(node.transform));
+    node.transform = transformFromMatrix(GeometryTransforms::multiply(GeometryTransforms::inverseAffine(parentWorld), world));
+    updatePlacements(node, parentWorld);
+}
+
 std::unique_ptr<Document::PrototypeNode> Document::buildPrototypeFromNode(const ObjectNode& node, ComponentDefinition& definition)
 {
     auto prototype = std::make_unique<PrototypeNode>();
     prototype->kind = (node.kind == NodeKind::ComponentInstance) ? NodeKind::Group : node.kind;
     prototype->name = node.name;
+    prototype->transform = node.transform;
     prototype->tags = node.tags;
     if (node.kind == NodeKind::Geometry && node.geometry) {
         std::unique_ptr<GeometryObject> clone = node.geometry->clone();
@@ -1002,6 +1493,7 @@ std::unique_ptr<Document::ObjectNode> Document::instantiatePrototype(const Proto
     node->kind = proto.kind;
     node->name = proto.name;
     node->parent = parent;
+    node->transform = proto.transform;
     node->tags = proto.tags;
     node->visible = true;
     node->expanded = true;
@@ -1021,11 +1513,34 @@ std::unique_ptr<Document::ObjectNode> Document::instantiatePrototype(const Proto
     return node;
 }
 
+void Document::refreshFromPrototype(ObjectNode& node, const PrototypeNode& proto)
+{
+    node.name = proto.name;
+    node.transform = proto.transform;
+    if (node.tags != proto.tags) {
+        for (TagId tagId : node.tags)
+            unindexTag(tagId, node.id);
+        node.tags = proto.tags;
+        for (TagId tagId : node.tags)
+            tagMembers[tagId].insert(node.id);
+    }
+    if (node.geometry && proto.geometry) {
+        const GeometryObject& current = *node.geometry;
+        const GeometryObject& source = *proto.geometry;
+        if (!current.getMesh().sharesStorageWith(source.getMesh()))
+            node.geometry->assignContent(source);
+    }
+    for (std::size_t i = 0; i < proto.children.size(); ++i)
+        refreshFromPrototype(*node.children[i], *proto.children[i]);
+}
+
 void Document::registerNode(ObjectNode* node)
 {
     if (!node)
         return;
     nodeIndex[node->id] = node;
+    for (TagId tagId : node->tags)
+        tagMembers[tagId].insert(node->id);
     if (node->kind == NodeKind::ComponentInstance && node->definitionId != 0) {
         auto& instances = componentInstances[node->definitionId];
         if (!contains(instances, node->id)) {
@@ -1039,6 +1554,8 @@ void Document::unregisterNode(ObjectNode* node)
     if (!node)
         return;
     nodeIndex.erase(node->id);
+    for (TagId tagId : node->tags)
+        unindexTag(tagId, node->id);
     if (node->kind == NodeKind::Geometry) {
         clearImportMetadata(node->id);
     }
@@ -1054,6 +1571,16 @@ void Document::unregisterNode(ObjectNode* node)
     }
 }
 
+void Document::unindexTag(TagId tagId, ObjectId objectId)
+{
+    auto it = tagMembers.find(tagId);
+    if (it == tagMembers.end())
+        return;
+    it->second.erase(objectId);
+    if (it->second.empty())
+        tagMembers.erase(it);
+}
+
 void Document::registerGeometry(ObjectNode* node, GeometryObject* geometry)
 {
     if (!node || !geometry)
@@ -1062,6 +1589,12 @@ void Document::registerGeometry(ObjectNode* node, GeometryObject* geometry)
     if (geometryId == 0)
         return;
     geometryIndex[geometryId] = node->id;
+    geometry->setPlacement(worldMatrix(*node));
+    // The selection set is authoritative: a flag copied by clone() or set
+    // before the object was registered does not select it.
+    geometry->setSelectionObserver(nullptr);
+    geometry->setSelected(selectionSet.contains(node->id));
+    geometry->setSelectionObserver(this);
 }
 
 void Document::unregisterGeometry(GeometryObject* geometry)
@@ -1071,9 +1604,12 @@ void Document::unregisterGeometry(GeometryObject* geometry)
     GeometryObject::StableId geometryId = geometry->getStableId();
     if (geometryId == 0)
         return;
+    geometry->setSelectionObserver(nullptr);
     auto it = geometryIndex.find(geometryId);
     if (it != geometryIndex.end()) {
         clearImportMetadata(it->second);
+        if (selectionSet.erase(it->second))
+            selectionEdited();
         geometryIndex.erase(it);
     }
 }
@@ -1203,6 +1739,9 @@ bool Document::deserializeObjectTree(std::istream& is, int version, const std::v
     rootNode->children.clear();
     nodeIndex.clear();
     geometryIndex.clear();
+    tagMembers.clear();
+    if (selectionSet.clear())
+        selectionEdited();
     registerNode(rootNode.get());
 
     std::string token;
@@ -2,8 +2,11 @@
 
 #include "SectionPlane.h"
 #include "SceneSettings.h"
+#include "SceneSerializer.h"
+#include "SelectionSet.h"
 #include "../CameraController.h"
 #include "../GeometryKernel/GeometryKernel.h"
+#include "../GeometryKernel/TransformUtils.h"
 
 #include <iosfwd>
 #include <cstdint>
@@ -16,11 +19,15 @@
 #include <vector>
 #include <chrono>
 
+namespace FileIO::Importers {
+struct ImportResult;
+}
+
 namespace Scene {
 
 class SceneSerializer;
 
-class Document {
+class Document : private GeometryObject::SelectionObserver {
 public:
     enum class FileFormat {
         Auto,
@@ -44,6 +51,20 @@ public:
     using ComponentDefinitionId = std::uint64_t;
     using SceneId = std::uint64_t;
 
+    // Rotation is in degrees about X, then Y, then Z; see
+    // GeometryTransforms::composeTransform().
+    struct Transform {
+        Vector3 position{ 0.0f, 0.0f, 0.0f };
+        Vector3 rotation{ 0.0f, 0.0f, 0.0f };
+        Vector3 scale{ 1.0f, 1.0f, 1.0f };
+    };
+
+    struct TransformMask {
+        std::array<bool, 3> position{ { false, false, false } };
+        std::array<bool, 3> rotation{ { false, false, false } };
+        std::array<bool, 3> scale{ { false, false, false } };
+    };
+
     struct ObjectNode {
         ObjectId id = 0;
         NodeKind kind = NodeKind::Geometry;
@@ -51,6 +72,9 @@ public:
         GeometryObject* geometry = nullptr;
         ComponentDefinitionId definitionId = 0;
         ObjectNode* parent = nullptr;
+        // Relative to the parent; the geometry's vertices are in the space
+        // this transform defines.
+        Transform transform;
         std::vector<TagId> tags;
         bool visible = true;
         bool expanded = true;
@@ -83,22 +107,11 @@ public:
         std::unordered_map<TagId, bool> tagVisibility;
     };
 
-    struct Transform {
-        Vector3 position{ 0.0f, 0.0f, 0.0f };
-        Vector3 rotation{ 0.0f, 0.0f, 0.0f };
-        Vector3 scale{ 1.0f, 1.0f, 1.0f };
-    };
-
-    struct TransformMask {
-        std::array<bool, 3> position{ { false, false, false } };
-        std::array<bool, 3> rotation{ { false, false, false } };
-        std::array<bool, 3> scale{ { false, false, false } };
-    };
-
     struct PrototypeNode {
         NodeKind kind = NodeKind::Geometry;
         std::string name;
         GeometryObject* geometry = nullptr;
+        Transform transform;
         std::vector<TagId> tags;
         std::vector<std::unique_ptr<PrototypeNode>> children;
     };
@@ -111,6 +124,9 @@ public:
     };
 
     Document();
+    // Geometry objects point back at the document that owns them.
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
 
     GeometryKernel& geometry() { return geometryKernel; }
     const GeometryKernel& geometry() const { return geometryKernel; }
@@ -129,14 +145,29 @@ public:
     GeometryObject* geometryForObject(ObjectId id);
     const GeometryObject* geometryForObject(ObjectId id) const;
 
+    // Position is the centre of the object's geometry in world space;
+    // rotation and scale are the node's own, relative to its parent.
     Transform objectTransform(ObjectId id) const;
+    // Edits the node transform: geometry below the node is moved by updating
+    // placements, not vertices. Rotation and scale keep the centre in place.
     bool applyTransform(ObjectId id, const Transform& transform, const TransformMask& mask);
+    bool setLocalTransform(ObjectId id, const Transform& transform);
+    // Moves the object by delta, given in world space.
+    bool translateObject(ObjectId id, const Vector3& delta);
+    // The node's transform composed with those of its parents.
+    GeometryTransforms::Matrix4 worldTransform(ObjectId id) const;
+    // Sets the node transform that gives the object this world matrix under
+    // its current parent. Shear cannot be represented and is dropped.
+    bool setWorldTransform(ObjectId id, const GeometryTransforms::Matrix4& world);
 
     ObjectId ensureObjectForGeometry(GeometryObject* object, const std::string& name = std::string());
     void synchronizeWithGeometry();
     void pruneInvalidObjects();
 
     bool removeObject(ObjectId objectId);
+    // Removes the objects and their subtrees in one pass over each parent and
+    // one batched geometry deletion. Returns false if none of the ids exist.
+    bool removeObjects(const std::vector<ObjectId>& objectIds);
     bool renameObject(ObjectId objectId, const std::string& name);
     bool setObjectExpanded(ObjectId objectId, bool expanded);
 
@@ -147,14 +178,40 @@ public:
     ComponentDefinitionId createComponentDefinition(const std::vector<ObjectId>& sourceIds, const std::string& name);
     ObjectId instantiateComponent(ComponentDefinitionId definitionId, const std::string& name);
     bool makeComponentUnique(ObjectId instanceId);
+    // Makes the contents of the instance the definition of its component and
+    // refreshes the other instances from it.
+    bool updateComponentDefinition(ObjectId instanceId);
+    // Brings every instance of the definition up to date. Instances whose tree
+    // still matches the definition keep their nodes and geometry objects and
+    // only take over the definition's mesh storage; others are rebuilt.
     void refreshComponentInstances(ComponentDefinitionId definitionId);
 
+    // Only objects with geometry can be selected. Setting the selected flag of
+    // registered geometry directly is equivalent to setObjectSelected().
+    const SelectionSet& selection() const { return selectionSet; }
+    SelectionSet::ListenerId addSelectionListener(SelectionSet::Listener listener);
+    void removeSelectionListener(SelectionSet::ListenerId id);
+    bool setObjectSelected(ObjectId objectId, bool selected);
+    // Replaces the selection; listeners are notified once.
+    void setSelection(const std::vector<ObjectId>& objectIds);
+    void clearSelection();
+    // Geometry of the selected objects, in selection order.
+    std::vector<GeometryObject*> selectedGeometry() const;
+
     TagId createTag(const std::string& name, const SceneSettings::Color& color);
     bool renameTag(TagId id, const std::string& name);
     bool setTagColor(TagId id, const SceneSettings::Color& color);
     bool setTagVisible(TagId id, bool visible);
     bool assignTag(ObjectId objectId, TagId tagId);
     bool removeTag(ObjectId objectId, TagId tagId);
+    // Bulk forms that only touch the objects whose tags change. Assigning
+    // fails if the tag does not exist; removing fails if no object had it.
+    bool assignTagToObjects(const std::vector<ObjectId>& objectIds, TagId tagId);
+    bool removeTagFromObjects(const std::vector<ObjectId>& objectIds, TagId tagId);
+    // Objects carrying the tag, in no particular order. Kept in step with
+    // ObjectNode::tags, so lookups cost the number of members.
+    const std::unordered_set<ObjectId>& taggedObjects(TagId tagId) const;
+    bool hasTag(ObjectId objectId, TagId tagId) const;
     bool deleteTag(TagId id, std::vector<ObjectId>* affectedObjects = nullptr);
     bool restoreTag(const Tag& tag, const std::vector<ObjectId>& assignments);
     const std::unordered_map<TagId, Tag>& tags() const { return tagMap; }
@@ -177,6 +234,7 @@ public:
     void reset();
 
     bool saveToFile(const std::string& filename) const;
+    bool saveToFile(const std::string& filename, const SceneSerializer::SaveOptions& options) const;
     bool loadFromFile(const std::string& filename);
 
     struct ImportMetadata {
@@ -187,6 +245,16 @@ public:
     };
 
     bool importExternalModel(const std::string& path, FileFormat fmt = FileFormat::Auto);
+    // Merges an import that FileImporter built in the detached document
+    // staging, possibly on another thread, and records its provenance. The
+    // merge is a single step on the calling thread, so the document never
+    // shows a partial import; on failure it is untouched and lastImportError()
+    // says why.
+    bool commitImport(Document& staging, const FileIO::Importers::ImportResult& result, const std::string& path);
+    // Moves the object tree, geometry, component definitions and tags of
+    // staging into this document under fresh ids and leaves staging empty.
+    // idMap receives staging object id -> merged id.
+    void mergeDocument(Document& staging, std::unordered_map<ObjectId, ObjectId>* idMap = nullptr);
     const std::string& lastImportError() const { return lastImportErrorMessage; }
     const std::unordered_map<ObjectId, ImportMetadata>& importedObjectMetadata() const { return importedProvenance; }
 
@@ -217,20 +285,43 @@ private:
 
     ObjectNode* addNode(NodeKind kind, const std::string& name, ObjectNode* parent);
     void removeNode(ObjectNode* node);
+    void removeNodes(const std::vector<ObjectNode*>& nodes);
     void removeChildGeometry(ObjectNode& node);
     void removeChildNode(ObjectNode& node, ObjectNode* child);
     void forEachNode(const std::function<void(ObjectNode&)>& fn);
     void forEachNode(const std::function<void(const ObjectNode&)>& fn) const;
     void rebuildIndices();
+    // Recomputes the hidden flags of all geometry. Needed when isolation
+    // changes or many tags change at once; other edits update only the nodes
+    // they can affect.
     void updateVisibility();
-    void applyVisibilityRecursive(ObjectNode& node, const std::unordered_set<TagId>& hiddenTags,
-                                  const std::unordered_set<ObjectId>& isolatedIds, bool ancestorVisible);
-    void collectIsolationIds(const ObjectNode& node, std::unordered_set<ObjectId>& ids) const;
+    void updateVisibility(ObjectNode& node);
+    // For changes to the tags of node or to the visibility of one of them.
+    void updateTaggedVisibility(ObjectNode& node, const std::unordered_set<ObjectId>& isolationPath);
+    void applyVisibilityRecursive(ObjectNode& node, const std::unordered_set<ObjectId>& isolationPath,
+                                  bool isolated, bool ancestorVisible);
+    void applyGeometryVisibility(ObjectNode& node, bool shown);
+    // Whether node lets its children show, given that its ancestors do.
+    // isolated becomes true once node or an ancestor is isolated.
+    bool showsChildren(const ObjectNode& node, const std::unordered_set<ObjectId>& isolationPath, bool& isolated) const;
+    bool ancestorsShowChildren(const ObjectNode& node, const std::unordered_set<ObjectId>& isolationPath,
+                               bool& isolated) const;
+    // The isolated nodes and their ancestors.
+    std::unordered_set<ObjectId> isolationPath() const;
+    void unindexTag(TagId tagId, ObjectId objectId);
     ObjectNode* findMutable(ObjectId id);
     const ObjectNode* findConst(ObjectId id) const;
     bool isDescendantOf(const ObjectNode& node, const ObjectNode& ancestor) const;
+    GeometryTransforms::Matrix4 worldMatrix(const ObjectNode& node) const;
+    GeometryTransforms::Matrix4 parentWorldMatrix(const ObjectNode& node) const;
+    Vector3 localCenter(const ObjectNode& node) const;
+    void updatePlacements(ObjectNode& node, const GeometryTransforms::Matrix4& parentWorld);
+    // After node moved from a parent placed at previousParentWorld, adjusts its
+    // transform so it stays where it was in the world.
+    void keepWorldPlacement(ObjectNode& node, const GeometryTransforms::Matrix4& previousParentWorld);
     std::unique_ptr<PrototypeNode> buildPrototypeFromNode(const ObjectNode& node, ComponentDefinition& definition);
     std::unique_ptr<ObjectNode> instantiatePrototype(const PrototypeNode& proto, ComponentDefinition& definition, ObjectNode* parent);
+    void refreshFromPrototype(ObjectNode& node, const PrototypeNode& proto);
     void registerNode(ObjectNode* node);
     void unregisterNode(ObjectNode* node);
     void registerGeometry(ObjectNode* node, GeometryObject* geometry);
@@ -252,6 +343,10 @@ private:
     bool deserializeScenes(std::istream& is, int version);
     bool parsePrototype(std::istream& is, const std::vector<GeometryObject*>& geometryObjects, PrototypeNode& proto);
     void resetInternal(bool clearGeometry);
+    void selectionChanged(GeometryObject& object, bool selected) override;
+    void beginSelectionBatch();
+    void endSelectionBatch();
+    void selectionEdited();
     bool loadLegacyFromFile(const std::string& filename);
 
     void clearImportMetadata(ObjectId id);
@@ -269,6 +364,7 @@ private:
     std::unordered_map<ObjectId, ObjectNode*> nodeIndex;
     std::unordered_map<GeometryObject::StableId, ObjectId> geometryIndex;
     std::unordered_map<TagId, Tag> tagMap;
+    std::unordered_map<TagId, std::unordered_set<ObjectId>> tagMembers;
     std::unordered_map<ComponentDefinitionId, ComponentDefinition> componentDefinitions;
     std::unordered_map<ComponentDefinitionId, std::vector<ObjectId>> componentInstances;
     std::unordered_map<SceneId, SceneState> sceneMap;
@@ -276,11 +372,16 @@ private:
     bool colorByTagEnabled = false;
     std::vector<ObjectId> isolationIds;
 
+    SelectionSet selectionSet;
+    int selectionBatchDepth = 0;
+    std::uint64_t selectionBatchRevision = 0;
+
     std::unordered_map<ObjectId, ImportMetadata> importedProvenance;
     std::unordered_map<ObjectId, ImagePlaneMetadata> imagePlaneMetadata;
     std::unordered_map<ObjectId, ExternalReferenceMetadata> externalReferenceMetadata;
     std::string lastImportErrorMessage;
     mutable std::string lastSceneIoErrorMessage;
+    mutable SceneSerializer::SaveState saveState;
 };
 
 using ObjectId = Document::ObjectId;
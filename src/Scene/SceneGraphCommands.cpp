@@ -231,6 +231,23 @@ void SetObjectTransformCommand::performUndo()
         document()->applyTransform(change.id, change.before, change.mask);
 }
 
+bool SetObjectTransformCommand::mergeCommand(const Core::Command& other)
+{
+    const auto& next = static_cast<const SetObjectTransformCommand&>(other);
+    if (next.changes.size() != changes.size())
+        return false;
+    for (std::size_t i = 0; i < changes.size(); ++i) {
+        const TransformChange& a = changes[i];
+        const TransformChange& b = next.changes[i];
+        if (a.id != b.id || a.mask.position != b.mask.position || a.mask.rotation != b.mask.rotation
+            || a.mask.scale != b.mask.scale)
+            return false;
+    }
+    for (std::size_t i = 0; i < changes.size(); ++i)
+        changes[i].after = next.changes[i].after;
+    return true;
+}
+
 CreateTagCommand::CreateTagCommand(const QString& tagName, const SceneSettings::Color& tagColor)
     : Core::Command(QObject::tr("Create Tag"))
     , name(tagName)
@@ -453,14 +470,8 @@ void SetTagAssignmentsCommand::initialize()
         return;
     previouslyHad.clear();
     previouslyHad.reserve(objectIds.size());
-    for (Document::ObjectId id : objectIds) {
-        const Document::ObjectNode* node = document()->findObject(id);
-        bool had = false;
-        if (node) {
-            had = std::find(node->tags.begin(), node->tags.end(), tagId) != node->tags.end();
-        }
-        previouslyHad.push_back(had);
-    }
+    for (Document::ObjectId id : objectIds)
+        previouslyHad.push_back(document()->hasTag(id, tagId));
     captured = true;
 }
 
@@ -468,26 +479,22 @@ void SetTagAssignmentsCommand::performRedo()
 {
     if (!document())
         return;
-    for (Document::ObjectId id : objectIds) {
-        if (assign)
-            document()->assignTag(id, tagId);
-        else
-            document()->removeTag(id, tagId);
-    }
+    if (assign)
+        document()->assignTagToObjects(objectIds, tagId);
+    else
+        document()->removeTagFromObjects(objectIds, tagId);
 }
 
 void SetTagAssignmentsCommand::performUndo()
 {
     if (!document())
         return;
-    for (std::size_t index = 0; index < objectIds.size(); ++index) {
-        Document::ObjectId id = objectIds[index];
-        bool had = previouslyHad[index];
-        if (had)
-            document()->assignTag(id, tagId);
-        else
-            document()->removeTag(id, tagId);
-    }
+    std::vector<Document::ObjectId> had;
+    std::vector<Document::ObjectId> hadNot;
+    for (std::size_t index = 0; index < objectIds.size(); ++index)
+        (previouslyHad[index] ? had : hadNot).push_back(objectIds[index]);
+    document()->assignTagToObjects(had, tagId);
+    document()->removeTagFromObjects(hadNot, tagId);
 }
 
 RebuildCurveFromMetadataCommand::RebuildCurveFromMetadataCommand(Document::ObjectId id,
@@ -103,6 +103,7 @@ protected:
     void initialize() override;
     void performRedo() override;
     void performUndo() override;
+    bool mergeCommand(const Core::Command& other) override;
 
 private:
     std::vector<TransformChange> changes;
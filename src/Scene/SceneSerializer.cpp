@@ -7,8 +7,12 @@
 #include "../CameraController.h"
 #include "../GeometryKernel/GeometryKernel.h"
 #include "../GeometryKernel/GeometryObject.h"
+#include "../GeometryKernel/Serialization.h"
 #include "../GeometryKernel/Vector3.h"
+#include "../Core/Parallel.h"
 
+#include <QByteArray>
+#include <QFile>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -19,7 +23,9 @@
 #include <chrono>
 #include <cmath>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <functional>
 #include <memory>
 #include <limits>
 #include <sstream>
@@ -33,6 +39,7 @@ namespace Scene {
 namespace {
 
 constexpr char kMagic[4] = {'F', 'C', 'S', 'N'};
+constexpr const char* kChunkEncoding = "application/vnd.freecrafter.geometry-chunks";
 
 QString nodeKindToString(Document::NodeKind kind)
 {
@@ -342,6 +349,39 @@ Document::SceneState::CameraState cameraStateFromJson(const QJsonObject& obj)
     return camera;
 }
 
+bool isDefaultTransform(const Document::Transform& transform)
+{
+    const Document::Transform identity;
+    auto same = [](const Vector3& a, const Vector3& b) { return a.x == b.x && a.y == b.y && a.z == b.z; };
+    return same(transform.position, identity.position) && same(transform.rotation, identity.rotation)
+        && same(transform.scale, identity.scale);
+}
+
+QJsonObject nodeTransformToJson(const Document::Transform& transform)
+{
+    QJsonObject obj;
+    obj.insert(QStringLiteral("position"), vectorToJson(transform.position));
+    obj.insert(QStringLiteral("rotation"), vectorToJson(transform.rotation));
+    obj.insert(QStringLiteral("scale"), vectorToJson(transform.scale));
+    return obj;
+}
+
+// Nodes saved before node transforms existed have none and get the identity.
+Document::Transform nodeTransformFromJson(const QJsonObject& obj)
+{
+    Document::Transform transform;
+    const QJsonArray position = obj.value(QStringLiteral("position")).toArray();
+    if (position.size() >= 3)
+        transform.position = vectorFromJson(position);
+    const QJsonArray rotation = obj.value(QStringLiteral("rotation")).toArray();
+    if (rotation.size() >= 3)
+        transform.rotation = vectorFromJson(rotation);
+    const QJsonArray scale = obj.value(QStringLiteral("scale")).toArray();
+    if (scale.size() >= 3)
+        transform.scale = vectorFromJson(scale);
+    return transform;
+}
+
 QJsonObject prototypeToJson(const Document::PrototypeNode& proto,
                             const std::unordered_map<const GeometryObject*, std::size_t>& lookup)
 {
@@ -353,6 +393,8 @@ QJsonObject prototypeToJson(const Document::PrototypeNode& proto,
         if (it != lookup.end())
             obj.insert(QStringLiteral("geometry"), static_cast<double>(it->second));
     }
+    if (!isDefaultTransform(proto.transform))
+        obj.insert(QStringLiteral("transform"), nodeTransformToJson(proto.transform));
     QJsonArray tags;
     for (Document::TagId id : proto.tags)
         tags.append(static_cast<double>(id));
@@ -381,6 +423,7 @@ std::unique_ptr<Document::PrototypeNode> prototypeFromJson(
                 proto->geometry = geometryObjects[idx];
         }
     }
+    proto->transform = nodeTransformFromJson(obj.value(QStringLiteral("transform")).toObject());
     const QJsonArray tagArray = obj.value(QStringLiteral("tags")).toArray();
     proto->tags.reserve(tagArray.size());
     for (const auto& entry : tagArray) {
@@ -412,6 +455,8 @@ QJsonObject objectNodeToJson(const Document::ObjectNode& node,
         if (it != geometryLookup.end())
             obj.insert(QStringLiteral("geometry"), static_cast<double>(it->second));
     }
+    if (!isDefaultTransform(node.transform))
+        obj.insert(QStringLiteral("transform"), nodeTransformToJson(node.transform));
     QJsonArray tags;
     for (Document::TagId tagId : node.tags)
         tags.append(static_cast<double>(tagId));
@@ -446,6 +491,7 @@ std::unique_ptr<Document::ObjectNode> objectNodeFromJson(
                 node->geometry = geometryObjects[idx];
         }
     }
+    node->transform = nodeTransformFromJson(obj.value(QStringLiteral("transform")).toObject());
     const QJsonArray tagArray = obj.value(QStringLiteral("tags")).toArray();
     node->tags.reserve(tagArray.size());
     for (const auto& entry : tagArray) {
@@ -546,8 +592,165 @@ Document::ExternalReferenceMetadata externalReferenceFromJson(const QJsonObject&
     return meta;
 }
 
+constexpr std::size_t kEncodeBatchSize = 256;
+
+using SavedChunk = SceneSerializer::SaveState::Chunk;
+using SavedChunkTable = std::unordered_map<std::uint64_t, SavedChunk>;
+
+QJsonArray chunkEntry(const SavedChunk& chunk)
+{
+    QJsonArray entry;
+    entry.append(static_cast<double>(chunk.offset));
+    entry.append(static_cast<double>(chunk.length));
+    entry.append(static_cast<double>(chunk.rawLength));
+    entry.append(QString::number(static_cast<qulonglong>(chunk.hash), 16));
+    return entry;
+}
+
+bool inflateChunk(const char* data, std::size_t size, std::size_t rawLength, std::string& out)
+{
+    const QByteArray inflated = qUncompress(reinterpret_cast<const uchar*>(data), static_cast<qsizetype>(size));
+    if (static_cast<std::size_t>(inflated.size()) != rawLength)
+        return false;
+    out.assign(inflated.constData(), static_cast<std::size_t>(inflated.size()));
+    return true;
+}
+
+struct EncodedChunk {
+    SavedChunk chunk;
+    std::string stored;
+};
+
+// Serialises objects [begin, end) on Core::WorkerPool, skipping those with a
+// reusable chunk. Each chunk is hashed and, when compression is on, deflated;
+// chunks that do not shrink are kept raw.
+void encodeChunks(const std::vector<const GeometryObject*>& objects, std::size_t begin, std::size_t end,
+                  const SceneSerializer::SaveOptions& options, const std::vector<const SavedChunk*>& reuse,
+                  std::vector<EncodedChunk>& encoded)
+{
+    encoded.clear();
+    encoded.resize(end - begin);
+    Core::parallelFor(end - begin, [&](std::size_t index) {
+        if (reuse[index])
+            return;
+        EncodedChunk& chunk = encoded[index];
+        std::string raw;
+        GeometryIO::appendObjectChunk(raw, *objects[begin + index]);
+        chunk.chunk.hash = GeometryIO::chunkHash(raw.data(), raw.size());
+        chunk.chunk.compressionTried = options.compress;
+        if (options.compress) {
+            const QByteArray deflated = qCompress(reinterpret_cast<const uchar*>(raw.data()),
+                                                  static_cast<qsizetype>(raw.size()), options.compressionLevel);
+            if (!deflated.isEmpty() && static_cast<std::size_t>(deflated.size()) < raw.size()) {
+                chunk.stored.assign(deflated.constData(), static_cast<std::size_t>(deflated.size()));
+                chunk.chunk.rawLength = raw.size();
+                chunk.chunk.length = chunk.stored.size();
+                return;
+            }
+        }
+        chunk.chunk.length = raw.size();
+        chunk.stored = std::move(raw);
+    });
+}
+
+// Decodes every chunk listed in the table straight out of the mapped file on a
+// worker pool, then appends the objects to the kernel in table order. Each
+// chunk's location is recorded in saved so later saves can reuse it while the
+// object stays unchanged.
+bool decodeChunkTable(const QJsonArray& table, const char* data, std::size_t size, GeometryKernel& kernel,
+                      SavedChunkTable& saved, std::uint64_t& liveBytes)
+{
+    std::vector<GeometryIO::ChunkRange> ranges;
+    ranges.reserve(table.size());
+    for (const auto& value : table) {
+        const QJsonArray entry = value.toArray();
+        if (entry.size() != 2 && entry.size() != 4)
+            return false;
+        const double offset = entry.at(0).toDouble(-1.0);
+        const double length = entry.at(1).toDouble(-1.0);
+        if (offset < 0.0 || length < 0.0 || !std::isfinite(offset) || !std::isfinite(length))
+            return false;
+        GeometryIO::ChunkRange range;
+        range.offset = static_cast<std::uint64_t>(offset);
+        range.length = static_cast<std::uint64_t>(length);
+        if (entry.size() == 4) {
+            const double rawLength = entry.at(2).toDouble(-1.0);
+            if (rawLength < 0.0 || !std::isfinite(rawLength))
+                return false;
+            bool hashOk = false;
+            range.rawLength = static_cast<std::uint64_t>(rawLength);
+            range.hash = entry.at(3).toString().toULongLong(&hashOk, 16);
+            if (!hashOk)
+                return false;
+        }
+        ranges.push_back(range);
+    }
+
+    std::vector<std::unique_ptr<GeometryObject>> objects;
+    if (!GeometryIO::decodeObjectChunks(data, size, ranges, objects, 0, inflateChunk))
+        return false;
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        GeometryObject* object = kernel.addObject(std::move(objects[i]));
+        if (!object)
+            continue;
+        SavedChunk& chunk = saved[object->getStableId()];
+        chunk.revision = object->contentRevision();
+        chunk.offset = ranges[i].offset;
+        chunk.length = ranges[i].length;
+        chunk.rawLength = ranges[i].rawLength;
+        chunk.hash = ranges[i].hash;
+        // The file does not say how raw chunks were written; assume without
+        // compression, so the first compressed save tries them once.
+        chunk.compressionTried = chunk.rawLength != 0;
+        liveBytes += ranges[i].length;
+    }
+    return true;
+}
+
+// Runs write against a temporary file next to path and renames it over the
+// target, so an interrupted save never leaves a half-written scene behind.
+// beforeRename releases anything still holding the old file open.
+template <typename WriteFn>
+SceneSerializer::Result writeReplacing(const std::string& path, WriteFn&& write, const std::function<void()>& beforeRename)
+{
+    const std::string tempPath = path + ".tmp";
+    SceneSerializer::Result result;
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return SceneSerializer::Result::failure("Unable to open scene file for writing");
+        result = write(file);
+    }
+    if (beforeRename)
+        beforeRename();
+    std::error_code error;
+    if (result.status == SceneSerializer::Result::Status::Success) {
+        std::filesystem::rename(tempPath, path, error);
+        if (error)
+            result = SceneSerializer::Result::failure("Unable to replace scene file: " + error.message());
+    }
+    if (result.status != SceneSerializer::Result::Status::Success)
+        std::filesystem::remove(tempPath, error);
+    return result;
+}
+
 } // namespace
 
+struct SceneSerializer::Snapshot {
+    struct Table {
+        std::uint64_t id = 0;
+        std::vector<const GeometryObject*> objects;
+    };
+
+    // Index JSON without the geometry chunk tables, which are only known once
+    // the chunks have been written.
+    QJsonObject root;
+    // Document kernel first, then one table per component definition in the
+    // order the definitions appear in root.
+    std::vector<Table> tables;
+    std::vector<std::unique_ptr<GeometryObject>> ownedGeometry;
+};
+
 SceneSerializer::Result SceneSerializer::Result::success()
 {
     Result result;
@@ -572,25 +775,128 @@ SceneSerializer::Result SceneSerializer::Result::failure(const std::string& mess
 
 SceneSerializer::Result SceneSerializer::save(const Document& document, const std::string& path)
 {
-    std::ofstream file(path, std::ios::binary | std::ios::trunc);
-    if (!file)
-        return Result::failure("Unable to open scene file for writing");
-    return saveToStream(document, file);
+    return save(document, path, SaveOptions());
+}
+
+SceneSerializer::Result SceneSerializer::save(const Document& document, const std::string& path, const SaveOptions& options)
+{
+    const SaveState& state = document.saveState;
+
+    // Map the file the save state describes so unchanged chunks can be reused.
+    // It is only trusted while it still looks exactly as the last save or load
+    // left it.
+    QFile previousFile;
+    PreviousFile previous;
+    if (!state.path.empty() && state.indexOffset != 0) {
+        previousFile.setFileName(QString::fromStdString(state.path));
+        if (previousFile.open(QIODevice::ReadOnly) && static_cast<std::uint64_t>(previousFile.size()) == state.fileSize
+            && state.fileSize >= sizeof(ChunkedHeader)) {
+            if (uchar* mapped = previousFile.map(0, previousFile.size())) {
+                ChunkedHeader header{};
+                std::memcpy(&header, mapped, sizeof(header));
+                if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.indexOffset == state.indexOffset) {
+                    previous.data = reinterpret_cast<const char*>(mapped);
+                    previous.size = static_cast<std::size_t>(state.fileSize);
+                    previous.state = &state;
+                }
+            }
+        }
+    }
+
+    const std::uint64_t garbage = state.fileSize > state.liveBytes ? state.fileSize - state.liveBytes : 0;
+    const bool needsCompaction
+        = static_cast<double>(garbage) > options.maxGarbageRatio * static_cast<double>(state.fileSize);
+    const std::shared_ptr<Snapshot> snapshot = capture(document, false);
+    SaveState next;
+    Result result;
+
+    if (options.incremental && previous.data && state.path == path && !needsCompaction) {
+        // Reused chunks are referenced by offset, so the mapping is not needed
+        // while appending.
+        previous.data = nullptr;
+        previous.size = 0;
+        previous.append = true;
+        previousFile.close();
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file)
+            return Result::failure("Unable to open scene file for writing");
+        result = saveToStream(*snapshot, file, options, previous, next);
+    } else {
+        // Chunks can be copied out of the file being replaced because the new
+        // one is written beside it.
+        result = writeReplacing(
+            path, [&](std::ostream& stream) { return saveToStream(*snapshot, stream, options, previous, next); },
+            [&]() { previousFile.close(); });
+    }
+
+    if (result.status == Result::Status::Success) {
+        next.path = path;
+        document.saveState = std::move(next);
+    }
+    return result;
+}
+
+SceneSerializer::Result SceneSerializer::write(const Snapshot& snapshot, const std::string& path, const SaveOptions& options)
+{
+    PreviousFile previous;
+    SaveState next;
+    return writeReplacing(
+        path, [&](std::ostream& stream) { return saveToStream(snapshot, stream, options, previous, next); }, {});
 }
 
 SceneSerializer::Result SceneSerializer::load(Document& document, const std::string& path)
 {
-    std::ifstream file(path, std::ios::binary);
-    if (!file)
+    QFile file(QString::fromStdString(path));
+    if (!file.open(QIODevice::ReadOnly))
         return Result::failure("Unable to open scene file for reading");
-    return loadFromStream(document, file);
+
+    const qint64 size = file.size();
+    const char* data = nullptr;
+    QByteArray fallback;
+    if (size > 0) {
+        // Map the file so geometry chunks decode in place; fall back to a single
+        // read when the filesystem does not support mapping.
+        if (uchar* mapped = file.map(0, size)) {
+            data = reinterpret_cast<const char*>(mapped);
+        } else {
+            fallback = file.readAll();
+            if (fallback.size() != size)
+                return Result::failure("Unable to read scene file");
+            data = fallback.constData();
+        }
+    }
+
+    Result result = loadFromBuffer(document, data, static_cast<std::size_t>(std::max<qint64>(size, 0)));
+    file.close();
+    if (result.status == Result::Status::Success) {
+        document.saveState.path = path;
+        document.saveState.fileSize = static_cast<std::uint64_t>(std::max<qint64>(size, 0));
+    } else {
+        document.saveState = SaveState();
+    }
+    return result;
 }
 
-SceneSerializer::Result SceneSerializer::saveToStream(const Document& document, std::ostream& stream)
+std::shared_ptr<SceneSerializer::Snapshot> SceneSerializer::capture(const Document& document, bool detachGeometry)
 {
-    std::ostringstream geometryStream(std::ios::binary);
-    document.geometryKernel.saveToStream(geometryStream);
-    const std::string geometryPayload = geometryStream.str();
+    auto snapshot = std::make_shared<Snapshot>();
+    auto addTable = [&](std::uint64_t id, const GeometryKernel& kernel) {
+        Snapshot::Table table;
+        table.id = id;
+        table.objects.reserve(kernel.getObjects().size());
+        for (const auto& object : kernel.getObjects()) {
+            if (!detachGeometry) {
+                table.objects.push_back(object.get());
+                continue;
+            }
+            std::unique_ptr<GeometryObject> copy = object->clone();
+            copy->setStableId(object->getStableId());
+            table.objects.push_back(copy.get());
+            snapshot->ownedGeometry.push_back(std::move(copy));
+        }
+        snapshot->tables.push_back(std::move(table));
+    };
+    addTable(0, document.geometryKernel);
 
     std::unordered_map<const GeometryObject*, std::size_t> geometryLookup;
     std::unordered_map<GeometryObject::StableId, std::size_t> stableLookup;
@@ -656,9 +962,7 @@ SceneSerializer::Result SceneSerializer::saveToStream(const Document& document,
         defObj.insert(QStringLiteral("id"), static_cast<double>(id));
         defObj.insert(QStringLiteral("name"), QString::fromStdString(definition.name));
 
-        std::ostringstream defGeometryStream(std::ios::binary);
-        definition.geometry.saveToStream(defGeometryStream);
-        defObj.insert(QStringLiteral("geometry"), QString::fromStdString(defGeometryStream.str()));
+        addTable(id, definition.geometry);
 
         std::unordered_map<const GeometryObject*, std::size_t> defLookup;
         const auto& defObjects = definition.geometry.getObjects();
@@ -712,78 +1016,210 @@ SceneSerializer::Result SceneSerializer::saveToStream(const Document& document,
 
     root.insert(QStringLiteral("document"), docObj);
 
-    QJsonObject geometryDescriptor;
-    geometryDescriptor.insert(QStringLiteral("encoding"), QStringLiteral("text/vnd.freecrafter.geometry"));
-    geometryDescriptor.insert(QStringLiteral("byteLength"), static_cast<double>(geometryPayload.size()));
-    root.insert(QStringLiteral("geometry"), geometryDescriptor);
+    snapshot->root = root;
+    return snapshot;
+}
 
-    const QByteArray jsonData = QJsonDocument(root).toJson(QJsonDocument::Compact);
+SceneSerializer::Result SceneSerializer::saveToStream(const Snapshot& snapshot, std::ostream& stream,
+                                                      const SaveOptions& options, const PreviousFile& previous,
+                                                      SaveState& next)
+{
+    static_assert(sizeof(ChunkedHeader) == 16, "SceneSerializer header must remain packed");
 
-    Header header{};
+    ChunkedHeader header{};
     std::memcpy(header.magic, kMagic, sizeof(kMagic));
     header.majorVersion = kSupportedMajorVersion;
     header.minorVersion = kSupportedMinorVersion;
-    header.jsonByteLength = static_cast<std::uint32_t>(jsonData.size());
-    header.geometryByteLength = static_cast<std::uint32_t>(geometryPayload.size());
-
-    static_assert(sizeof(Header) == 16, "SceneSerializer header must remain packed");
-
-    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    header.indexOffset = 0;
+
+    std::streampos start;
+    std::uint64_t cursor = 0;
+    if (previous.append) {
+        // The existing header stays valid until it is rewritten at the end.
+        start = 0;
+        stream.seekp(0, std::ios::end);
+        cursor = previous.state->fileSize;
+    } else {
+        start = stream.tellp();
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        cursor = sizeof(ChunkedHeader);
+    }
     if (!stream)
         return Result::failure("Failed writing scene header");
-    if (!jsonData.isEmpty()) {
-        stream.write(jsonData.constData(), jsonData.size());
-        if (!stream)
-            return Result::failure("Failed writing scene metadata");
-    }
-    if (!geometryPayload.empty()) {
-        stream.write(geometryPayload.data(), static_cast<std::streamsize>(geometryPayload.size()));
-        if (!stream)
-            return Result::failure("Failed writing scene geometry payload");
+    std::uint64_t liveBytes = sizeof(ChunkedHeader);
+
+    std::vector<const SavedChunk*> reuse;
+    std::vector<EncodedChunk> encoded;
+    std::size_t totalObjects = 0;
+    for (const auto& table : snapshot.tables)
+        totalObjects += table.objects.size();
+    std::size_t writtenObjects = 0;
+    auto writeChunks = [&](const Snapshot::Table& source, QJsonArray& table) {
+        const auto& objects = source.objects;
+        const SavedChunkTable* previousTable = nullptr;
+        if (previous.state) {
+            auto it = previous.state->tables.find(source.id);
+            if (it != previous.state->tables.end())
+                previousTable = &it->second;
+        }
+        SavedChunkTable& nextTable = next.tables[source.id];
+        for (std::size_t begin = 0; begin < objects.size(); begin += kEncodeBatchSize) {
+            const std::size_t end = std::min(objects.size(), begin + kEncodeBatchSize);
+            reuse.assign(end - begin, nullptr);
+            if (previousTable) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    auto it = previousTable->find(objects[i]->getStableId());
+                    if (it == previousTable->end() || it->second.revision != objects[i]->contentRevision())
+                        continue;
+                    // Chunks stored with a different compression setting are
+                    // re-encoded so the saved file honours the options. Raw
+                    // chunks that already failed to shrink are kept as they are.
+                    const SavedChunk& saved = it->second;
+                    if (options.compress ? !saved.compressionTried : saved.rawLength != 0)
+                        continue;
+                    if (previous.append || (saved.offset <= previous.size && saved.length <= previous.size - saved.offset))
+                        reuse[i - begin] = &saved;
+                }
+            }
+            encodeChunks(objects, begin, end, options, reuse, encoded);
+            for (std::size_t i = 0; i < encoded.size(); ++i) {
+                const GeometryObject& object = *objects[begin + i];
+                SavedChunk chunk;
+                if (reuse[i]) {
+                    chunk = *reuse[i];
+                    if (!previous.append) {
+                        stream.write(previous.data + chunk.offset, static_cast<std::streamsize>(chunk.length));
+                        chunk.offset = cursor;
+                        cursor += chunk.length;
+                    }
+                } else {
+                    chunk = encoded[i].chunk;
+                    stream.write(encoded[i].stored.data(), static_cast<std::streamsize>(encoded[i].stored.size()));
+                    chunk.offset = cursor;
+                    cursor += chunk.length;
+                }
+                if (!stream)
+                    return false;
+                chunk.revision = object.contentRevision();
+                table.append(chunkEntry(chunk));
+                liveBytes += chunk.length;
+                nextTable[object.getStableId()] = chunk;
+                ++writtenObjects;
+                if (options.progress)
+                    options.progress(writtenObjects, totalObjects);
+            }
+        }
+        return true;
+    };
+
+    QJsonObject root = snapshot.root;
+    QJsonArray geometryChunks;
+    if (!snapshot.tables.empty() && !writeChunks(snapshot.tables.front(), geometryChunks))
+        return Result::failure("Failed writing scene geometry payload");
+
+    // Component tables follow the document kernel in the order the
+    // definitions appear in the index.
+    QJsonObject docObj = root.value(QStringLiteral("document")).toObject();
+    QJsonArray componentArray = docObj.value(QStringLiteral("components")).toArray();
+    for (std::size_t i = 1; i < snapshot.tables.size(); ++i) {
+        const auto index = static_cast<qsizetype>(i - 1);
+        if (index >= componentArray.size())
+            break;
+        QJsonArray defChunks;
+        if (!writeChunks(snapshot.tables[i], defChunks))
+            return Result::failure("Failed writing component geometry payload");
+        QJsonObject defObj = componentArray.at(index).toObject();
+        defObj.insert(QStringLiteral("geometryChunks"), defChunks);
+        componentArray.replace(index, defObj);
     }
+    docObj.insert(QStringLiteral("components"), componentArray);
+    root.insert(QStringLiteral("document"), docObj);
+
+    QJsonObject geometryDescriptor;
+    geometryDescriptor.insert(QStringLiteral("encoding"), QString::fromLatin1(kChunkEncoding));
+    geometryDescriptor.insert(QStringLiteral("chunks"), geometryChunks);
+    root.insert(QStringLiteral("geometry"), geometryDescriptor);
+
+    const QByteArray jsonData = QJsonDocument(root).toJson(QJsonDocument::Compact);
+
+    header.indexOffset = cursor;
+    const std::uint64_t indexLength = static_cast<std::uint64_t>(jsonData.size());
+    stream.write(reinterpret_cast<const char*>(&indexLength), sizeof(indexLength));
+    if (!jsonData.isEmpty())
+        stream.write(jsonData.constData(), jsonData.size());
+    stream.flush();
+    if (!stream)
+        return Result::failure("Failed writing scene metadata");
+    cursor += sizeof(indexLength) + indexLength;
+    liveBytes += sizeof(indexLength) + indexLength;
+
+    // The header is rewritten last so a truncated write never points at a
+    // missing index; when appending, the previous index stays in effect until
+    // this point.
+    const std::streampos end = stream.tellp();
+    stream.seekp(start);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.seekp(end);
     stream.flush();
     if (!stream)
         return Result::failure("Failed finalising scene file");
+    next.fileSize = cursor;
+    next.indexOffset = header.indexOffset;
+    next.liveBytes = liveBytes;
     return Result::success();
 }
 
-SceneSerializer::Result SceneSerializer::loadFromStream(Document& document, std::istream& stream)
+SceneSerializer::Result SceneSerializer::loadFromBuffer(Document& document, const char* data, std::size_t size)
 {
-    char magic[4];
-    stream.read(magic, sizeof(magic));
-    if (stream.gcount() != sizeof(magic))
-        return Result::formatMismatch();
-    if (std::memcmp(magic, kMagic, sizeof(magic)) != 0)
+    if (!data || size < sizeof(kMagic) || std::memcmp(data, kMagic, sizeof(kMagic)) != 0)
         return Result::formatMismatch();
-
-    Header header{};
-    std::memcpy(header.magic, magic, sizeof(magic));
-    stream.read(reinterpret_cast<char*>(&header.majorVersion), sizeof(Header) - sizeof(magic));
-    if (!stream)
+    if (size < sizeof(Header))
         return Result::failure("Scene file header truncated");
 
-    if (header.majorVersion > kSupportedMajorVersion) {
+    std::uint16_t fileMajorVersion = 0;
+    std::memcpy(&fileMajorVersion, data + sizeof(kMagic), sizeof(fileMajorVersion));
+    if (fileMajorVersion > kSupportedMajorVersion) {
         return Result::failure("Scene file was written by a newer version of FreeCrafter");
     }
 
-    std::string jsonBuffer;
-    jsonBuffer.resize(header.jsonByteLength);
-    if (header.jsonByteLength > 0) {
-        stream.read(jsonBuffer.data(), header.jsonByteLength);
-        if (!stream)
+    const bool chunked = fileMajorVersion >= kChunkedMajorVersion;
+    const char* jsonData = nullptr;
+    std::size_t jsonSize = 0;
+    const char* legacyGeometry = nullptr;
+    std::size_t legacyGeometrySize = 0;
+    std::uint64_t indexOffset = 0;
+    std::uint64_t indexBlockSize = 0;
+    if (chunked) {
+        ChunkedHeader header{};
+        std::memcpy(&header, data, sizeof(header));
+        std::uint64_t indexLength = 0;
+        if (header.indexOffset < sizeof(ChunkedHeader) || header.indexOffset > size - sizeof(indexLength))
+            return Result::failure("Scene index offset is out of range");
+        std::memcpy(&indexLength, data + header.indexOffset, sizeof(indexLength));
+        const std::size_t indexStart = static_cast<std::size_t>(header.indexOffset) + sizeof(indexLength);
+        if (indexLength > size - indexStart)
             return Result::failure("Scene metadata truncated");
-    }
-
-    std::string geometryBuffer;
-    geometryBuffer.resize(header.geometryByteLength);
-    if (header.geometryByteLength > 0) {
-        stream.read(geometryBuffer.data(), header.geometryByteLength);
-        if (!stream)
+        jsonData = data + indexStart;
+        jsonSize = static_cast<std::size_t>(indexLength);
+        indexOffset = header.indexOffset;
+        indexBlockSize = sizeof(indexLength) + indexLength;
+    } else {
+        Header header{};
+        std::memcpy(&header, data, sizeof(header));
+        const std::size_t available = size - sizeof(Header);
+        if (header.jsonByteLength > available)
+            return Result::failure("Scene metadata truncated");
+        if (header.geometryByteLength > available - header.jsonByteLength)
             return Result::failure("Scene geometry payload truncated");
+        jsonData = data + sizeof(Header);
+        jsonSize = header.jsonByteLength;
+        legacyGeometry = jsonData + jsonSize;
+        legacyGeometrySize = header.geometryByteLength;
     }
 
     QJsonParseError parseError{};
-    QJsonDocument docJson = QJsonDocument::fromJson(QByteArray::fromRawData(jsonBuffer.data(), jsonBuffer.size()), &parseError);
+    QJsonDocument docJson = QJsonDocument::fromJson(
+        QByteArray::fromRawData(jsonData, static_cast<qsizetype>(jsonSize)), &parseError);
     if (parseError.error != QJsonParseError::NoError || docJson.isNull())
         return Result::failure("Scene metadata could not be parsed as JSON");
 
@@ -799,9 +1235,17 @@ SceneSerializer::Result SceneSerializer::loadFromStream(Document& document, std:
     const QJsonObject docObj = root.value(QStringLiteral("document")).toObject();
 
     document.resetInternal(true);
-
-    if (!geometryBuffer.empty()) {
-        std::istringstream geoStream(geometryBuffer);
+    document.saveState = SaveState();
+    document.saveState.indexOffset = indexOffset;
+    document.saveState.liveBytes = sizeof(ChunkedHeader) + indexBlockSize;
+
+    if (chunked) {
+        const QJsonArray chunkTable = root.value(QStringLiteral("geometry")).toObject().value(QStringLiteral("chunks")).toArray();
+        if (!decodeChunkTable(chunkTable, data, size, document.geometryKernel,
+                              document.saveState.tables[0], document.saveState.liveBytes))
+            return Result::failure("Scene geometry chunk is corrupt");
+    } else if (legacyGeometrySize > 0) {
+        std::istringstream geoStream(std::string(legacyGeometry, legacyGeometrySize));
         document.geometryKernel.loadFromStream(geoStream, std::string());
     }
 
@@ -883,10 +1327,17 @@ SceneSerializer::Result SceneSerializer::loadFromStream(Document& document, std:
         definition.id = static_cast<Document::ComponentDefinitionId>(
             defObj.value(QStringLiteral("id")).toDouble(0.0));
         definition.name = defObj.value(QStringLiteral("name")).toString().toStdString();
-        const std::string geometryText = defObj.value(QStringLiteral("geometry")).toString().toStdString();
-        if (!geometryText.empty()) {
-            std::istringstream defStream(geometryText);
-            definition.geometry.loadFromStream(defStream, std::string());
+        if (chunked) {
+            if (!decodeChunkTable(defObj.value(QStringLiteral("geometryChunks")).toArray(), data, size,
+                                  definition.geometry, document.saveState.tables[definition.id],
+                                  document.saveState.liveBytes))
+                return Result::failure("Component geometry chunk is corrupt");
+        } else {
+            const std::string geometryText = defObj.value(QStringLiteral("geometry")).toString().toStdString();
+            if (!geometryText.empty()) {
+                std::istringstream defStream(geometryText);
+                definition.geometry.loadFromStream(defStream, std::string());
+            }
         }
         std::vector<GeometryObject*> defGeometry;
         const auto& defObjects = definition.geometry.getObjects();
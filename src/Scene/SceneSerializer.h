@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iosfwd>
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace Scene {
 
@@ -23,13 +27,70 @@ public:
         static Result failure(const std::string& message);
     };
 
+    struct SaveOptions {
+        // Store geometry chunks zlib-compressed when that makes them smaller.
+        bool compress = false;
+        int compressionLevel = -1;
+        // Append changed chunks and a new index to the file last saved or
+        // loaded at the same path instead of rewriting it. A full, compacting
+        // rewrite happens instead when the file changed on disk or when dead
+        // bytes exceed maxGarbageRatio of its size.
+        bool incremental = false;
+        double maxGarbageRatio = 0.5;
+        // Called on the saving thread after each geometry chunk is written.
+        std::function<void(std::size_t written, std::size_t total)> progress;
+    };
+
+    // Document state captured for saving; see capture().
+    struct Snapshot;
+
+    // Where the document's geometry chunks live in the file it was last saved
+    // to or loaded from, and which object revision each chunk holds. Chunks
+    // whose revision still matches are reused instead of being encoded again.
+    struct SaveState {
+        struct Chunk {
+            std::uint64_t revision = 0;
+            std::uint64_t offset = 0;
+            std::uint64_t length = 0;
+            std::uint64_t rawLength = 0;
+            std::uint64_t hash = 0;
+            // Encoded with compression on. Such a chunk may still be stored
+            // raw (rawLength 0) if deflating did not make it smaller.
+            bool compressionTried = false;
+        };
+        std::string path;
+        std::uint64_t fileSize = 0;
+        std::uint64_t indexOffset = 0;
+        // Bytes still referenced by the current index, including header and index.
+        std::uint64_t liveBytes = 0;
+        // Keyed by geometry table (0 = document kernel, otherwise the component
+        // definition id), then by stable id.
+        std::unordered_map<std::uint64_t, std::unordered_map<std::uint64_t, Chunk>> tables;
+    };
+
     static Result save(const Document& document, const std::string& path);
+    static Result save(const Document& document, const std::string& path, const SaveOptions& options);
     static Result load(Document& document, const std::string& path);
 
-    static constexpr std::uint16_t kSupportedMajorVersion = 1;
+    // Captures everything a save needs. With detachGeometry the geometry is
+    // cloned, so the snapshot stays valid while the document keeps changing;
+    // otherwise it borrows the document's objects and must be written first.
+    static std::shared_ptr<Snapshot> capture(const Document& document, bool detachGeometry);
+    // Writes a snapshot through a temporary file renamed over path. Touches no
+    // Document, so it may run on a worker thread.
+    static Result write(const Snapshot& snapshot, const std::string& path, const SaveOptions& options);
+
+    static constexpr std::uint16_t kSupportedMajorVersion = 3;
     static constexpr std::uint16_t kSupportedMinorVersion = 0;
+    // Files before this major version store a single JSON blob followed by the
+    // text geometry payload; newer files use the chunked container.
+    static constexpr std::uint16_t kChunkedMajorVersion = 2;
+    // From this version chunk table entries may carry a decoded length and a
+    // content hash, and chunks may be compressed.
+    static constexpr std::uint16_t kCompressedMajorVersion = 3;
 
 private:
+    // Version 1 layout: header, JSON metadata, text geometry payload.
     struct Header {
         char magic[4];
         std::uint16_t majorVersion;
@@ -38,8 +99,27 @@ private:
         std::uint32_t geometryByteLength;
     };
 
-    static Result saveToStream(const Document& document, std::ostream& stream);
-    static Result loadFromStream(Document& document, std::istream& stream);
+    // Version 2+ layout: header, one binary chunk per geometry object, then an
+    // index block (u64 length + JSON) holding the document and the chunk table.
+    struct ChunkedHeader {
+        char magic[4];
+        std::uint16_t majorVersion;
+        std::uint16_t minorVersion;
+        std::uint64_t indexOffset;
+    };
+
+    // Previous file contents that unchanged chunks can be copied or referenced from.
+    struct PreviousFile {
+        const char* data = nullptr;
+        std::size_t size = 0;
+        const SaveState* state = nullptr;
+        // Write after the existing contents and reference reused chunks in place.
+        bool append = false;
+    };
+
+    static Result saveToStream(const Snapshot& snapshot, std::ostream& stream, const SaveOptions& options,
+                               const PreviousFile& previous, SaveState& next);
+    static Result loadFromBuffer(Document& document, const char* data, std::size_t size);
 };
 
 } // namespace Scene
@@ -0,0 +1,83 @@
+#include "SelectionSet.h"
+
+#include <algorithm>
+
+namespace Scene {
+
+const std::vector<SelectionSet::ObjectId>& SelectionSet::ids() const
+{
+    if (holes > 0)
+        compact();
+    return members;
+}
+
+SelectionSet::ListenerId SelectionSet::addListener(Listener listener)
+{
+    const ListenerId id = nextListenerId++;
+    listeners.emplace_back(id, std::move(listener));
+    return id;
+}
+
+void SelectionSet::removeListener(ListenerId id)
+{
+    listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+                                   [id](const auto& entry) { return entry.first == id; }),
+                    listeners.end());
+}
+
+bool SelectionSet::insert(ObjectId id)
+{
+    if (id == 0 || !positions.emplace(id, members.size()).second)
+        return false;
+    members.push_back(id);
+    ++changeCount;
+    return true;
+}
+
+bool SelectionSet::erase(ObjectId id)
+{
+    auto it = positions.find(id);
+    if (it == positions.end())
+        return false;
+    members[it->second] = 0;
+    positions.erase(it);
+    ++holes;
+    ++changeCount;
+    if (holes > 64 && holes * 2 > members.size())
+        compact();
+    return true;
+}
+
+bool SelectionSet::clear()
+{
+    if (positions.empty())
+        return false;
+    members.clear();
+    positions.clear();
+    holes = 0;
+    ++changeCount;
+    return true;
+}
+
+void SelectionSet::notify() const
+{
+    // A listener may remove itself, so run over a copy.
+    const auto current = listeners;
+    for (const auto& entry : current)
+        entry.second();
+}
+
+void SelectionSet::compact() const
+{
+    std::size_t write = 0;
+    for (ObjectId id : members) {
+        if (id == 0)
+            continue;
+        positions[id] = write;
+        members[write++] = id;
+    }
+    members.resize(write);
+    holes = 0;
+}
+
+} // namespace Scene
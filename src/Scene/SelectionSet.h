@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Scene {
+
+class Document;
+
+// The selected object ids of a Document, in the order they were selected.
+// Membership tests, insertion and removal are constant time, so readers pay
+// for the selection rather than for the scene. Only Document changes it; it
+// keeps GeometryObject::isSelected() in step for per-object checks.
+class SelectionSet {
+public:
+    using ObjectId = std::uint64_t;
+    using Listener = std::function<void()>;
+    using ListenerId = std::size_t;
+
+    bool contains(ObjectId id) const { return positions.count(id) > 0; }
+    const std::vector<ObjectId>& ids() const;
+    std::size_t size() const { return positions.size(); }
+    bool empty() const { return positions.empty(); }
+    // Increases with every change, so callers can cache derived data.
+    std::uint64_t revision() const { return changeCount; }
+
+    // Listeners run after each change, once per batch of changes.
+    ListenerId addListener(Listener listener);
+    void removeListener(ListenerId id);
+
+private:
+    friend class Document;
+
+    bool insert(ObjectId id);
+    bool erase(ObjectId id);
+    bool clear();
+    void notify() const;
+    void compact() const;
+
+    // Erased entries are left as 0 (never an object id) until ids() or a
+    // large enough number of them compacts the list.
+    mutable std::vector<ObjectId> members;
+    mutable std::unordered_map<ObjectId, std::size_t> positions;
+    mutable std::size_t holes = 0;
+    std::vector<std::pair<ListenerId, Listener>> listeners;
+    ListenerId nextListenerId = 1;
+    std::uint64_t changeCount = 0;
+};
+
+} // namespace Scene
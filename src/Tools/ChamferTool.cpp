@@ -46,14 +46,12 @@ bool ChamferTool::selectTarget()
     targetId = 0;
     if (!geometry)
         return false;
-    for (const auto& object : geometry->getObjects()) {
-        if (!object || !object->isSelected())
+    for (GeometryObject* object : selectedObjects()) {
+        if (!object || object->getType() != ObjectType::Curve)
             continue;
-        if (object->getType() != ObjectType::Curve)
-            continue;
-        targetCurve = static_cast<Curve*>(object.get());
+        targetCurve = static_cast<Curve*>(object);
         if (Scene::Document* doc = getDocument())
-            targetId = doc->objectIdForGeometry(object.get());
+            targetId = doc->objectIdForGeometry(object);
         break;
     }
     if (!targetCurve)
@@ -135,7 +133,7 @@ bool ChamferTool::rebuildPreview()
     std::unique_ptr<Curve> preview = round.createFilleted(*targetCurve, options);
     if (!preview)
         return false;
-    previewLoop = preview->getBoundaryLoop();
+    previewLoop = targetCurve->toWorld(preview->getBoundaryLoop());
     previewHardness = preview->getEdgeHardness();
     previewValid = previewLoop.size() >= 3;
     return previewValid;
@@ -124,7 +124,7 @@ bool ExtrudeTool::computeExtrusionFrame()
     if (!profileCurve)
         return false;
 
-    const auto& loop = profileCurve->getBoundaryLoop();
+    const auto loop = profileCurve->toWorld(profileCurve->getBoundaryLoop());
     if (loop.size() < 3)
         return false;
 
@@ -136,7 +136,7 @@ bool ExtrudeTool::computeExtrusionFrame()
     pathClosed = false;
 
     if (mode == Mode::Path) {
-        const auto& pathLoop = pathCurve->getBoundaryLoop();
+        const auto pathLoop = pathCurve->toWorld(pathCurve->getBoundaryLoop());
         if (pathLoop.size() < 2)
             return false;
 
@@ -244,7 +244,8 @@ bool ExtrudeTool::pickCurveAtPointer(const PointerInput& input, Curve*& outCurve
         if (object->getType() != ObjectType::Curve)
             continue;
         auto* curve = static_cast<Curve*>(object.get());
-        bool hasFace = !curve->getMesh().getFaces().empty();
+        const HalfEdgeMesh& mesh = static_cast<const Curve*>(curve)->getMesh();
+        bool hasFace = !mesh.getFaces().empty();
         if (requireFace && !hasFace)
             continue;
         if (requireNoFace && hasFace)
@@ -253,7 +254,6 @@ bool ExtrudeTool::pickCurveAtPointer(const PointerInput& input, Curve*& outCurve
         bool curveHasIntersection = false;
         float curveRayT = std::numeric_limits<float>::max();
 
-        const auto& mesh = curve->getMesh();
         const auto& vertices = mesh.getVertices();
         const auto& triangles = mesh.getTriangles();
         if (!triangles.empty()) {
@@ -265,8 +265,8 @@ bool ExtrudeTool::pickCurveAtPointer(const PointerInput& input, Curve*& outCurve
                     || tri.v2 >= static_cast<int>(vertices.size()))
                     continue;
                 float t = 0.0f;
-                if (intersectRayTriangle(rayOrigin, rayDirection,
-                        vertices[tri.v0].position, vertices[tri.v1].position, vertices[tri.v2].position, t)) {
+                if (intersectRayTriangle(rayOrigin, rayDirection, curve->toWorld(vertices[tri.v0].position),
+                        curve->toWorld(vertices[tri.v1].position), curve->toWorld(vertices[tri.v2].position), t)) {
                     if (t < curveRayT) {
                         curveRayT = t;
                         curveHasIntersection = true;
@@ -277,7 +277,7 @@ bool ExtrudeTool::pickCurveAtPointer(const PointerInput& input, Curve*& outCurve
 
         float curveDistance = std::numeric_limits<float>::max();
         float curveDistanceRayT = std::numeric_limits<float>::max();
-        const auto& loop = curve->getBoundaryLoop();
+        const auto loop = curve->toWorld(curve->getBoundaryLoop());
         if (!loop.empty()) {
             if (loop.size() == 1) {
                 float segmentRayT = 0.0f;
@@ -528,7 +528,7 @@ Tool::PreviewState ExtrudeTool::buildPreview() const
         return state;
 
     PreviewPolyline polyline;
-    const auto& loop = profileCurve->getBoundaryLoop();
+    const auto loop = profileCurve->toWorld(profileCurve->getBoundaryLoop());
     polyline.closed = loop.size() > 2;
     Vector3 offset = baseDirection * previewDistance;
     for (const auto& point : loop) {
@@ -57,19 +57,17 @@ bool LoftTool::collectSelection()
     if (!geometry)
         return false;
 
-    for (const auto& object : geometry->getObjects()) {
-        if (!object || !object->isSelected())
-            continue;
-        if (object->getType() != ObjectType::Curve)
+    for (GeometryObject* object : selectedObjects()) {
+        if (!object || object->getType() != ObjectType::Curve)
             continue;
         if (!startCurve) {
-            startCurve = static_cast<Curve*>(object.get());
+            startCurve = static_cast<Curve*>(object);
             if (Scene::Document* doc = getDocument())
-                startId = doc->objectIdForGeometry(object.get());
+                startId = doc->objectIdForGeometry(object);
         } else if (!endCurve) {
-            endCurve = static_cast<Curve*>(object.get());
+            endCurve = static_cast<Curve*>(object);
             if (Scene::Document* doc = getDocument())
-                endId = doc->objectIdForGeometry(object.get());
+                endId = doc->objectIdForGeometry(object);
             break;
         }
     }
@@ -146,8 +144,8 @@ bool LoftTool::rebuildPreview()
     if (!startCurve || !endCurve)
         return false;
 
-    const auto& startLoop = startCurve->getBoundaryLoop();
-    const auto& endLoop = endCurve->getBoundaryLoop();
+    const auto startLoop = startCurve->toWorld(startCurve->getBoundaryLoop());
+    const auto endLoop = endCurve->toWorld(endCurve->getBoundaryLoop());
     if (startLoop.size() < 3 || endLoop.size() < 3)
         return false;
 
@@ -15,26 +15,12 @@ namespace {
 using ToolHelpers::axisSnap;
 using ToolHelpers::screenToGround;
 
-GeometryObject* findSelectedCurve(GeometryKernel* geometry)
-{
-    if (!geometry)
-        return nullptr;
-    for (const auto& obj : geometry->getObjects()) {
-        if (obj->getType() == ObjectType::Curve && obj->isSelected()) {
-            return obj.get();
-        }
-    }
-    return nullptr;
-}
-
-std::vector<GeometryObject*> findSelectedCurves(GeometryKernel* geometry)
+std::vector<GeometryObject*> selectedCurves(const std::vector<GeometryObject*>& selection)
 {
     std::vector<GeometryObject*> curves;
-    if (!geometry)
-        return curves;
-    for (const auto& obj : geometry->getObjects()) {
-        if (obj->getType() == ObjectType::Curve && obj->isSelected()) {
-            curves.push_back(obj.get());
+    for (GeometryObject* obj : selection) {
+        if (obj->getType() == ObjectType::Curve) {
+            curves.push_back(obj);
         }
     }
     return curves;
@@ -70,7 +56,7 @@ void OffsetTool::onPointerDown(const PointerInput&)
         return;
 
     std::vector<Scene::Document::ObjectId> ids;
-    for (GeometryObject* obj : findSelectedCurves(geometry)) {
+    for (GeometryObject* obj : selectedCurves(selectedObjects())) {
         Scene::Document::ObjectId id = doc->objectIdForGeometry(obj);
         if (id != 0)
             ids.push_back(id);
@@ -95,7 +81,7 @@ void PushPullTool::onPointerDown(const PointerInput&)
         return;
 
     std::vector<Scene::Document::ObjectId> ids;
-    for (GeometryObject* obj : findSelectedCurves(geometry)) {
+    for (GeometryObject* obj : selectedCurves(selectedObjects())) {
         Scene::Document::ObjectId id = doc->objectIdForGeometry(obj);
         if (id != 0)
             ids.push_back(id);
@@ -119,7 +105,11 @@ void FollowMeTool::onPointerDown(const PointerInput&)
     if (!geometry || !stack || !doc)
         return;
 
-    GeometryObject* profileCurve = profile ? profile : findSelectedCurve(geometry);
+    GeometryObject* profileCurve = profile;
+    if (!profileCurve) {
+        const std::vector<GeometryObject*> curves = selectedCurves(selectedObjects());
+        profileCurve = curves.empty() ? nullptr : curves.front();
+    }
     if (!profileCurve || profileCurve->getType() != ObjectType::Curve)
         return;
     GeometryObject* pathCurve = path;
@@ -150,7 +140,7 @@ void PaintBucketTool::onPointerDown(const PointerInput&)
         return;
 
     std::vector<Scene::Document::ObjectId> ids;
-    for (GeometryObject* obj : findSelectedCurves(geometry)) {
+    for (GeometryObject* obj : selectedCurves(selectedObjects())) {
         Scene::Document::ObjectId id = doc->objectIdForGeometry(obj);
         if (id != 0)
             ids.push_back(id);
@@ -18,7 +18,7 @@ MoveTool::MoveTool(GeometryKernel* g, CameraController* c)
 
 void MoveTool::onPointerDown(const PointerInput& input)
 {
-    selection = gatherSelection();
+    selection = selectedObjects();
     if (selection.empty()) {
         dragging = false;
         return;
@@ -185,19 +185,6 @@ Tool::OverrideResult MoveTool::applyMeasurementOverride(double value)
     return Tool::OverrideResult::Commit;
 }
 
-std::vector<GeometryObject*> MoveTool::gatherSelection() const
-{
-    std::vector<GeometryObject*> result;
-    if (!geometry)
-        return result;
-    for (const auto& object : geometry->getObjects()) {
-        if (object->isSelected()) {
-            result.push_back(object.get());
-        }
-    }
-    return result;
-}
-
 void MoveTool::applyTranslation(const Vector3& delta)
 {
     if (!geometry)
@@ -26,7 +26,6 @@ protected:
 private:
     bool pointerToWorld(const PointerInput& input, Vector3& out) const;
     Vector3 applyAxisConstraint(const Vector3& delta) const;
-    std::vector<GeometryObject*> gatherSelection() const;
     void applyTranslation(const Vector3& delta);
     std::vector<Scene::ObjectId> selectionIds() const;
 
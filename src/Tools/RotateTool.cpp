@@ -61,7 +61,7 @@ RotateTool::RotateTool(GeometryKernel* g, CameraController* c)
 
 void RotateTool::onPointerDown(const PointerInput& input)
 {
-    selection = gatherSelection();
+    selection = selectedObjects();
     if (selection.empty()) {
         dragging = false;
         return;
@@ -207,18 +207,6 @@ bool RotateTool::pointerToWorld(const PointerInput& input, Vector3& out) const
     return pointerToGround(camera, input.x, input.y, viewportWidth, viewportHeight, out);
 }
 
-std::vector<GeometryObject*> RotateTool::gatherSelection() const
-{
-    std::vector<GeometryObject*> result;
-    if (!geometry)
-        return result;
-    for (const auto& object : geometry->getObjects()) {
-        if (object->isSelected())
-            result.push_back(object.get());
-    }
-    return result;
-}
-
 Vector3 RotateTool::determineAxis() const
 {
     const auto& snap = getInferenceResult();
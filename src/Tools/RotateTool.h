@@ -25,7 +25,6 @@ protected:
 
 private:
     bool pointerToWorld(const PointerInput& input, Vector3& out) const;
-    std::vector<GeometryObject*> gatherSelection() const;
     Vector3 determineAxis() const;
     void applyRotation(float angleRadians);
     std::vector<Scene::ObjectId> selectionIds() const;
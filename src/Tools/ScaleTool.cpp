@@ -69,7 +69,7 @@ ScaleTool::ScaleTool(GeometryKernel* g, CameraController* c)
 
 void ScaleTool::onPointerDown(const PointerInput& input)
 {
-    selection = gatherSelection();
+    selection = selectedObjects();
     if (selection.empty()) {
         dragging = false;
         return;
@@ -235,18 +235,6 @@ bool ScaleTool::pointerToWorld(const PointerInput& input, Vector3& out) const
     return pointerToGround(camera, input.x, input.y, viewportWidth, viewportHeight, out);
 }
 
-std::vector<GeometryObject*> ScaleTool::gatherSelection() const
-{
-    std::vector<GeometryObject*> result;
-    if (!geometry)
-        return result;
-    for (const auto& object : geometry->getObjects()) {
-        if (object->isSelected())
-            result.push_back(object.get());
-    }
-    return result;
-}
-
 Vector3 ScaleTool::determineAxis() const
 {
     const auto& snap = getInferenceResult();
@@ -25,7 +25,6 @@ protected:
 
 private:
     bool pointerToWorld(const PointerInput& input, Vector3& out) const;
-    std::vector<GeometryObject*> gatherSelection() const;
     void applyScale(const Vector3& factors);
     Vector3 determineAxis() const;
     std::vector<Scene::ObjectId> selectionIds() const;
@@ -2,9 +2,11 @@
 
 #include <QtCore/Qt>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <memory>
+#include <unordered_set>
 #include <QString>
 
 #include "ToolCommands.h"
@@ -12,6 +14,8 @@
 #include "../GeometryKernel/Curve.h"
 #include "../GeometryKernel/HalfEdgeMesh.h"
 #include "../GeometryKernel/Solid.h"
+#include "../GeometryKernel/TransformUtils.h"
+#include "../Scene/Document.h"
 
 namespace {
 constexpr float kPi = 3.14159265358979323846f;
@@ -168,21 +172,24 @@ GeometryObject* SmartSelectTool::pickObjectAt(const Vector3& worldPoint)
     const float solidBias = 0.85f;
 
     for (const auto& object : geometry->getObjects()) {
+        auto toWorld = [&object](const Vector3& p) {
+            return object->isPlaced() ? GeometryTransforms::transformPoint(object->placement(), p) : p;
+        };
         if (object->getType() == ObjectType::Curve) {
             const Curve* curve = static_cast<const Curve*>(object.get());
             const auto& loop = curve->getBoundaryLoop();
             for (const auto& vertex : loop) {
-                float dist = (vertex - worldPoint).lengthSquared();
+                float dist = (toWorld(vertex) - worldPoint).lengthSquared();
                 if (dist < bestDistance) {
                     bestDistance = dist;
                     best = object.get();
                 }
             }
         } else {
-            const HalfEdgeMesh& mesh = object->getMesh();
+            const HalfEdgeMesh& mesh = static_cast<const GeometryObject&>(*object).getMesh();
             float localBest = std::numeric_limits<float>::max();
             for (const auto& vertex : mesh.getVertices()) {
-                float dist = (vertex.position - worldPoint).lengthSquared();
+                float dist = (toWorld(vertex.position) - worldPoint).lengthSquared();
                 localBest = std::min(localBest, dist);
             }
             if (localBest < std::numeric_limits<float>::max()) {
@@ -215,18 +222,42 @@ void SmartSelectTool::applySelection(const std::vector<GeometryObject*>& hits, b
     if (!geometry)
         return;
 
-    if (!additive && !toggle)
-        clearSelection();
+    Scene::Document* doc = getDocument();
+    if (!doc || geometry != &doc->geometry()) {
+        if (!additive && !toggle)
+            clearSelection();
+        for (GeometryObject* obj : hits) {
+            if (!obj)
+                continue;
+            obj->setSelected(toggle ? !obj->isSelected() : true);
+        }
+        return;
+    }
 
+    // Build the new selection and hand it to the document in one change.
+    std::vector<Scene::ObjectId> ids;
+    if (additive || toggle)
+        ids = doc->selection().ids();
+    std::unordered_set<Scene::ObjectId> selected(ids.begin(), ids.end());
+    std::unordered_set<Scene::ObjectId> deselected;
     for (GeometryObject* obj : hits) {
-        if (!obj)
+        const Scene::ObjectId id = obj ? doc->objectIdForGeometry(obj) : 0;
+        if (id == 0)
             continue;
-        if (toggle) {
-            obj->setSelected(!obj->isSelected());
-        } else {
-            obj->setSelected(true);
+        if (toggle && selected.count(id)) {
+            selected.erase(id);
+            deselected.insert(id);
+        } else if (selected.insert(id).second) {
+            deselected.erase(id);
+            ids.push_back(id);
         }
     }
+    if (!deselected.empty()) {
+        ids.erase(std::remove_if(ids.begin(), ids.end(),
+                                 [&selected](Scene::ObjectId id) { return !selected.count(id); }),
+                  ids.end());
+    }
+    doc->setSelection(ids);
 }
 
 void SmartSelectTool::selectSingle(const PointerInput& input)
@@ -285,18 +316,11 @@ void SmartSelectTool::clearSelection()
     if (!geometry)
         return;
 
+    Scene::Document* doc = getDocument();
+    if (doc && geometry == &doc->geometry()) {
+        doc->clearSelection();
+        return;
+    }
     for (const auto& object : geometry->getObjects())
         object->setSelected(false);
 }
-
-}
-
-void SmartSelectTool::clearSelection()
-{
-    if (!geometry)
-        return;
-    for (const auto& object : geometry->getObjects()) {
-        object->setSelected(false);
-    }
-}
-
@@ -1,5 +1,7 @@
 #include "Tool.h"
 
+#include "../Scene/Document.h"
+
 #include <algorithm>
 #include <QString>
 
@@ -78,6 +80,20 @@ void Tool::setState(State newState)
     onStateChanged(previous, state);
 }
 
+std::vector<GeometryObject*> Tool::selectedObjects() const
+{
+    if (document && geometry == &document->geometry())
+        return document->selectedGeometry();
+    std::vector<GeometryObject*> result;
+    if (!geometry)
+        return result;
+    for (const auto& object : geometry->getObjects()) {
+        if (object->isSelected())
+            result.push_back(object.get());
+    }
+    return result;
+}
+
 void Tool::updateModifiers(const ModifierState& nextModifiers)
 {
     if (modifiers != nextModifiers) {
@@ -163,6 +163,9 @@ protected:
     const ModifierState& getModifiers() const { return modifiers; }
     Scene::Document* getDocument() const { return document; }
     Core::CommandStack* getCommandStack() const { return commandStack; }
+    // Selected objects in selection order. Reads the document's selection set
+    // when the tool edits the document's geometry, otherwise scans the kernel.
+    std::vector<GeometryObject*> selectedObjects() const;
 
     int viewportWidth = 1;
     int viewportHeight = 1;
@@ -3,12 +3,16 @@
 #include "GeometryKernel/GeometryKernel.h"
 #include "GeometryKernel/GeometryObject.h"
 #include "GeometryKernel/Curve.h"
+#include "GeometryKernel/Serialization.h"
 #include "GeometryKernel/Solid.h"
+#include "GeometryKernel/TransformUtils.h"
 #include "ToolGeometryUtils.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <limits>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
@@ -120,6 +124,11 @@ void CreateCurveCommand::performUndo()
     createdId_ = 0;
 }
 
+std::size_t CreateCurveCommand::memoryFootprint() const
+{
+    return Command::memoryFootprint() + points_.capacity() * sizeof(Vector3) + name_.capacity();
+}
+
 ExtrudeProfileCommand::ExtrudeProfileCommand(Scene::Document::ObjectId profileId,
     std::optional<Scene::Document::ObjectId> pathId, Vector3 direction, bool capStart, bool capEnd,
     const QString& description, std::string name)
@@ -152,11 +161,15 @@ void ExtrudeProfileCommand::performRedo()
     options.capStart = capStart_;
     options.capEnd = capEnd_;
 
-    GeometryObject* created = geometry()->extrudeCurveAlongVector(profile, direction_, options);
+    // The profile's vertices are in its object space, and so is the result.
+    const Vector3 direction = GeometryTransforms::transformDirection(GeometryTransforms::inverseAffine(profile->placement()), direction_);
+    GeometryObject* created = geometry()->extrudeCurveAlongVector(profile, direction, options);
     if (!created)
         return;
 
     createdId_ = document()->ensureObjectForGeometry(created, name_);
+    if (createdId_ != 0)
+        document()->setWorldTransform(createdId_, profile->placement());
     if (createdId_ != 0)
         setFinalSelection({ createdId_ });
     else
@@ -185,10 +198,8 @@ void TranslateObjectsCommand::performRedo()
 {
     if (!geometry() || !document())
         return;
-    for (Scene::Document::ObjectId id : ids_) {
-        if (GeometryObject* object = document()->geometryForObject(id))
-            translateObject(*object, delta_);
-    }
+    for (Scene::Document::ObjectId id : ids_)
+        document()->translateObject(id, delta_);
     setFinalSelection(ids_);
 }
 
@@ -196,10 +207,17 @@ void TranslateObjectsCommand::performUndo()
 {
     if (!geometry() || !document())
         return;
-    for (Scene::Document::ObjectId id : ids_) {
-        if (GeometryObject* object = document()->geometryForObject(id))
-            translateObject(*object, Vector3(-delta_.x, -delta_.y, -delta_.z));
-    }
+    for (Scene::Document::ObjectId id : ids_)
+        document()->translateObject(id, Vector3(-delta_.x, -delta_.y, -delta_.z));
+}
+
+bool TranslateObjectsCommand::mergeCommand(const Core::Command& other)
+{
+    const auto& next = static_cast<const TranslateObjectsCommand&>(other);
+    if (next.ids_ != ids_)
+        return false;
+    delta_ += next.delta_;
+    return true;
 }
 
 RotateObjectsCommand::RotateObjectsCommand(std::vector<Scene::Document::ObjectId> ids, Vector3 pivot, Vector3 axis,
@@ -234,6 +252,15 @@ void RotateObjectsCommand::performUndo()
     }
 }
 
+bool RotateObjectsCommand::mergeCommand(const Core::Command& other)
+{
+    const auto& next = static_cast<const RotateObjectsCommand&>(other);
+    if (next.ids_ != ids_ || (next.pivot_ - pivot_).lengthSquared() > 1e-10f || (next.axis_ - axis_).lengthSquared() > 1e-10f)
+        return false;
+    angleRadians_ += next.angleRadians_;
+    return true;
+}
+
 ScaleObjectsCommand::ScaleObjectsCommand(std::vector<Scene::Document::ObjectId> ids, Vector3 pivot, Vector3 factors,
                                          const QString& description)
     : Core::Command(description)
@@ -270,6 +297,20 @@ void ScaleObjectsCommand::performUndo()
     }
 }
 
+bool ScaleObjectsCommand::mergeCommand(const Core::Command& other)
+{
+    const auto& next = static_cast<const ScaleObjectsCommand&>(other);
+    if (next.ids_ != ids_ || (next.pivot_ - pivot_).lengthSquared() > 1e-10f)
+        return false;
+    // Undo divides by the combined factor, so a degenerate step stays separate.
+    const Vector3 combined(factors_.x * next.factors_.x, factors_.y * next.factors_.y, factors_.z * next.factors_.z);
+    const float epsilon = 1e-5f;
+    if (std::fabs(combined.x) <= epsilon || std::fabs(combined.y) <= epsilon || std::fabs(combined.z) <= epsilon)
+        return false;
+    factors_ = combined;
+    return true;
+}
+
 DeleteObjectsCommand::DeleteObjectsCommand(std::vector<Scene::Document::ObjectId> ids, const QString& description)
     : Core::Command(description)
     , requestedIds_(std::move(ids))
@@ -283,6 +324,9 @@ void DeleteObjectsCommand::initialize()
         return;
 
     std::unordered_set<Scene::Document::ObjectId> seen;
+    // Sibling positions, filled once per parent so large selections under one
+    // parent stay linear.
+    std::unordered_map<const Scene::Document::ObjectNode*, std::size_t> childIndices;
     for (Scene::Document::ObjectId id : requestedIds_) {
         if (id == 0)
             continue;
@@ -307,16 +351,16 @@ void DeleteObjectsCommand::initialize()
 
         if (const auto* node = document()->findObject(id)) {
             entry.name = node->name;
+            entry.transform = node->transform;
             entry.tags = node->tags;
             entry.parentId = node->parent ? node->parent->id : 0;
             if (node->parent) {
-                const auto& siblings = node->parent->children;
-                for (std::size_t idx = 0; idx < siblings.size(); ++idx) {
-                    if (siblings[idx].get() == node) {
-                        entry.childIndex = idx;
-                        break;
-                    }
+                if (childIndices.find(node) == childIndices.end()) {
+                    const auto& siblings = node->parent->children;
+                    for (std::size_t idx = 0; idx < siblings.size(); ++idx)
+                        childIndices[siblings[idx].get()] = idx;
                 }
+                entry.childIndex = childIndices[node];
             }
         }
 
@@ -328,11 +372,14 @@ void DeleteObjectsCommand::performRedo()
 {
     if (!document())
         return;
+    std::vector<Scene::Document::ObjectId> ids;
+    ids.reserve(entries_.size());
     for (auto& entry : entries_) {
         if (entry.currentId != 0)
-            document()->removeObject(entry.currentId);
+            ids.push_back(entry.currentId);
         entry.currentId = 0;
     }
+    document()->removeObjects(ids);
     setFinalSelection({});
 }
 
@@ -367,12 +414,67 @@ void DeleteObjectsCommand::performUndo()
 
         if (entry.parentId != 0 || entry.childIndex != 0)
             document()->moveObject(newId, entry.parentId, entry.childIndex);
+        document()->setLocalTransform(newId, entry.transform);
 
         entry.currentId = newId;
     }
     setFinalSelection({});
 }
 
+// Only the prototypes are packed; each is stored as its byte length followed
+// by its object chunk, with a zero length for entries that have none.
+bool DeleteObjectsCommand::packState(std::string& out)
+{
+    bool packed = false;
+    for (Entry& entry : entries_) {
+        std::string chunk;
+        if (entry.prototype) {
+            GeometryIO::appendObjectChunk(chunk, *entry.prototype);
+            entry.prototype.reset();
+            packed = true;
+        }
+        const std::uint64_t length = chunk.size();
+        out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        out += chunk;
+    }
+    return packed;
+}
+
+bool DeleteObjectsCommand::unpackState(const std::string& in)
+{
+    std::size_t offset = 0;
+    bool complete = true;
+    for (Entry& entry : entries_) {
+        std::uint64_t length = 0;
+        if (in.size() - offset < sizeof(length))
+            return false;
+        std::memcpy(&length, in.data() + offset, sizeof(length));
+        offset += sizeof(length);
+        if (in.size() - offset < length)
+            return false;
+        if (length > 0) {
+            entry.prototype = GeometryIO::decodeObjectChunk(in.data() + offset, static_cast<std::size_t>(length));
+            complete = complete && entry.prototype != nullptr;
+        }
+        offset += static_cast<std::size_t>(length);
+    }
+    return complete && offset == in.size();
+}
+
+std::size_t DeleteObjectsCommand::memoryFootprint() const
+{
+    std::size_t bytes = Command::memoryFootprint() + requestedIds_.capacity() * sizeof(Scene::Document::ObjectId)
+        + entries_.capacity() * sizeof(Entry);
+    for (const Entry& entry : entries_) {
+        // The prototypes share mesh storage with the objects restored from
+        // them, so an undone delete costs little beyond the live scene.
+        if (entry.prototype)
+            bytes += entry.prototype->memoryFootprint();
+        bytes += entry.name.capacity() + entry.tags.capacity() * sizeof(Scene::Document::TagId);
+    }
+    return bytes;
+}
+
 ApplyChamferCommand::ApplyChamferCommand(Scene::Document::ObjectId curveId, Phase6::RoundCornerOptions options,
                                          const QString& description)
     : Core::Command(description)
@@ -422,6 +524,11 @@ void ApplyChamferCommand::performUndo()
         curve->rebuildFromPoints(originalLoop_, originalHardness_);
 }
 
+std::size_t ApplyChamferCommand::memoryFootprint() const
+{
+    return Command::memoryFootprint() + originalLoop_.capacity() * sizeof(Vector3) + originalHardness_.capacity() / 8;
+}
+
 CreateLoftCommand::CreateLoftCommand(Scene::Document::ObjectId startId, Scene::Document::ObjectId endId,
                                      Phase6::LoftOptions options, const QString& description, std::string name)
     : Core::Command(description)
@@ -446,7 +553,15 @@ void CreateLoftCommand::performRedo()
     Solid* solid = op.loft(*static_cast<Curve*>(start), *static_cast<Curve*>(end), options_);
     if (!solid)
         return;
+    // The loft is built in world space; carry the start profile's placement
+    // like the other commands that derive an object from a curve.
+    if (start->isPlaced()) {
+        const GeometryTransforms::Matrix4 toStart = GeometryTransforms::inverseAffine(start->placement());
+        solid->applyTransform([&toStart](const Vector3& p) { return GeometryTransforms::transformPoint(toStart, p); });
+    }
     createdId_ = document()->ensureObjectForGeometry(solid, name_);
+    if (createdId_ != 0)
+        document()->setWorldTransform(createdId_, start->placement());
     if (createdId_ != 0)
         setFinalSelection({ createdId_ });
     else
@@ -527,6 +642,8 @@ void OffsetCurveCommand::performRedo()
 
         const std::string& name = entry.name.empty() ? (fallbackName_.empty() ? "Offset Curve" : fallbackName_) : entry.name;
         entry.createdId = document()->ensureObjectForGeometry(created, name);
+        if (entry.createdId != 0)
+            document()->setWorldTransform(entry.createdId, object->placement());
         if (entry.createdId != 0)
             selection.push_back(entry.createdId);
     }
@@ -550,6 +667,14 @@ void OffsetCurveCommand::performUndo()
     }
 }
 
+std::size_t OffsetCurveCommand::memoryFootprint() const
+{
+    std::size_t bytes = Command::memoryFootprint() + entries_.capacity() * sizeof(Entry);
+    for (const Entry& entry : entries_)
+        bytes += entry.offsetPoints.capacity() * sizeof(Vector3) + entry.name.capacity();
+    return bytes;
+}
+
 PushPullCommand::PushPullCommand(std::vector<Scene::Document::ObjectId> sourceIds, float distance,
                                  const QString& description, std::string name)
     : Core::Command(description)
@@ -606,6 +731,8 @@ void PushPullCommand::performRedo()
 
         const std::string& name = entry.name.empty() ? (fallbackName_.empty() ? "Push/Pull" : fallbackName_) : entry.name;
         entry.createdId = document()->ensureObjectForGeometry(created, name);
+        if (entry.createdId != 0)
+            document()->setWorldTransform(entry.createdId, object->placement());
         if (entry.createdId != 0)
             selection.push_back(entry.createdId);
     }
@@ -663,14 +790,19 @@ void FollowMeCommand::performRedo()
         return;
 
     if (sections_.empty()) {
-        sections_.reserve(pathLoop.size());
-        Vector3 start = pathLoop.front();
-        for (const auto& point : pathLoop) {
+        // Sections live in the profile's space; the path is walked in world
+        // space and each step mapped back through the profile's placement.
+        const GeometryTransforms::Matrix4 toProfile = GeometryTransforms::inverseAffine(profile->placement());
+        const std::vector<Vector3> worldPath = pathCurve->toWorld(pathLoop);
+        sections_.reserve(worldPath.size());
+        Vector3 start = worldPath.front();
+        for (const auto& point : worldPath) {
             Vector3 offset = point - start;
+            Vector3 step = GeometryTransforms::transformDirection(toProfile, Vector3(offset.x, 0.0f, offset.z));
             std::vector<Vector3> section;
             section.reserve(profileLoop.size());
             for (const auto& p : profileLoop)
-                section.push_back(p + Vector3(offset.x, 0.0f, offset.z));
+                section.push_back(p + step);
             sections_.push_back(std::move(section));
         }
         createdIds_.assign(sections_.size(), 0);
@@ -705,6 +837,7 @@ void FollowMeCommand::performRedo()
             names_[i] = name;
         if (createdId == 0)
             continue;
+        document()->setWorldTransform(createdId, profile->placement());
 
         if (createdIds_.size() > i)
             createdIds_[i] = createdId;
@@ -732,6 +865,14 @@ void FollowMeCommand::performUndo()
     }
 }
 
+std::size_t FollowMeCommand::memoryFootprint() const
+{
+    std::size_t bytes = Command::memoryFootprint() + sections_.capacity() * sizeof(std::vector<Vector3>);
+    for (const auto& section : sections_)
+        bytes += section.capacity() * sizeof(Vector3);
+    return bytes;
+}
+
 CreateTextAnnotationCommand::CreateTextAnnotationCommand(Vector3 position, std::string text, float height,
                                                          const QString& description)
     : Core::Command(description)
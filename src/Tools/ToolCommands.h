@@ -22,6 +22,8 @@ public:
                        std::optional<GeometryKernel::ShapeMetadata> metadata = std::nullopt,
                        std::string name = {});
 
+    std::size_t memoryFootprint() const override;
+
 protected:
     void performRedo() override;
     void performUndo() override;
@@ -61,6 +63,7 @@ public:
 protected:
     void performRedo() override;
     void performUndo() override;
+    bool mergeCommand(const Core::Command& other) override;
 
 private:
     std::vector<Scene::Document::ObjectId> ids_;
@@ -75,6 +78,7 @@ public:
 protected:
     void performRedo() override;
     void performUndo() override;
+    bool mergeCommand(const Core::Command& other) override;
 
 private:
     std::vector<Scene::Document::ObjectId> ids_;
@@ -91,6 +95,7 @@ public:
 protected:
     void performRedo() override;
     void performUndo() override;
+    bool mergeCommand(const Core::Command& other) override;
 
 private:
     std::vector<Scene::Document::ObjectId> ids_;
@@ -102,10 +107,14 @@ class DeleteObjectsCommand : public Core::Command {
 public:
     DeleteObjectsCommand(std::vector<Scene::Document::ObjectId> ids, const QString& description);
 
+    std::size_t memoryFootprint() const override;
+
 protected:
     void initialize() override;
     void performRedo() override;
     void performUndo() override;
+    bool packState(std::string& out) override;
+    bool unpackState(const std::string& in) override;
 
 private:
     struct Entry {
@@ -115,6 +124,7 @@ private:
         std::optional<std::string> material;
         std::optional<GeometryKernel::ShapeMetadata> metadata;
         std::string name;
+        Scene::Document::Transform transform;
         std::vector<Scene::Document::TagId> tags;
         Scene::Document::ObjectId parentId = 0;
         std::size_t childIndex = 0;
@@ -128,6 +138,8 @@ class ApplyChamferCommand : public Core::Command {
 public:
     ApplyChamferCommand(Scene::Document::ObjectId curveId, Phase6::RoundCornerOptions options, const QString& description);
 
+    std::size_t memoryFootprint() const override;
+
 protected:
     void initialize() override;
     void performRedo() override;
@@ -163,6 +175,8 @@ public:
     OffsetCurveCommand(std::vector<Scene::Document::ObjectId> sourceIds, float distance, const QString& description,
                        std::string name = {});
 
+    std::size_t memoryFootprint() const override;
+
 protected:
     void initialize() override;
     void performRedo() override;
@@ -208,6 +222,8 @@ public:
     FollowMeCommand(Scene::Document::ObjectId profileId, Scene::Document::ObjectId pathId, const QString& description,
                     std::string name = {});
 
+    std::size_t memoryFootprint() const override;
+
 protected:
     void initialize() override;
     void performRedo() override;
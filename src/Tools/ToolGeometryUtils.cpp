@@ -6,6 +6,7 @@
 #include "../GeometryKernel/HalfEdgeMesh.h"
 
 #include <algorithm>
+#include <functional>
 
 namespace {
 
@@ -37,6 +38,25 @@ std::vector<Vector3> meshVertices(const HalfEdgeMesh& mesh)
     return verts;
 }
 
+void transformVertices(GeometryObject& object, const std::function<Vector3(const Vector3&)>& fn)
+{
+    if (object.getType() == ObjectType::Curve) {
+        static_cast<Curve&>(object).applyTransform(fn);
+    } else {
+        static_cast<Solid&>(object).applyTransform(fn);
+    }
+}
+
+// Applies a world-space edit to the object-space vertices of a placed object.
+void transformPlacedVertices(GeometryObject& object, const std::function<Vector3(const Vector3&)>& worldFn)
+{
+    const GeometryTransforms::Matrix4& placement = object.placement();
+    const GeometryTransforms::Matrix4 inverse = GeometryTransforms::inverseAffine(placement);
+    transformVertices(object, [&](const Vector3& p) {
+        return GeometryTransforms::transformPoint(inverse, worldFn(GeometryTransforms::transformPoint(placement, p)));
+    });
+}
+
 }
 
 BoundingBox computeBoundingBox(const GeometryObject& object)
@@ -49,6 +69,16 @@ BoundingBox computeBoundingBox(const GeometryObject& object)
         const HalfEdgeMesh& mesh = object.getMesh();
         box = boxFromVertices(meshVertices(mesh));
     }
+    if (box.valid && object.isPlaced()) {
+        const Vector3 corners[] = { box.min, box.max };
+        std::vector<Vector3> placed;
+        placed.reserve(8);
+        for (int i = 0; i < 8; ++i) {
+            const Vector3 corner(corners[i & 1].x, corners[(i >> 1) & 1].y, corners[(i >> 2) & 1].z);
+            placed.push_back(GeometryTransforms::transformPoint(object.placement(), corner));
+        }
+        box = boxFromVertices(placed);
+    }
     return box;
 }
 
@@ -63,6 +93,11 @@ Vector3 computeCentroid(const GeometryObject& object)
 
 void translateObject(GeometryObject& object, const Vector3& delta)
 {
+    if (object.isPlaced()) {
+        const Vector3 localDelta = GeometryTransforms::transformDirection(GeometryTransforms::inverseAffine(object.placement()), delta);
+        transformVertices(object, [&](const Vector3& p) { return p + localDelta; });
+        return;
+    }
     if (object.getType() == ObjectType::Curve) {
         static_cast<Curve&>(object).translate(delta);
     } else {
@@ -72,6 +107,12 @@ void translateObject(GeometryObject& object, const Vector3& delta)
 
 void rotateObject(GeometryObject& object, const Vector3& pivot, const Vector3& axis, float angleRadians)
 {
+    if (object.isPlaced()) {
+        transformPlacedVertices(object, [&](const Vector3& p) {
+            return GeometryTransforms::rotateAroundAxis(p, pivot, axis, angleRadians);
+        });
+        return;
+    }
     if (object.getType() == ObjectType::Curve) {
         static_cast<Curve&>(object).rotate(pivot, axis, angleRadians);
     } else {
@@ -81,6 +122,10 @@ void rotateObject(GeometryObject& object, const Vector3& pivot, const Vector3& a
 
 void scaleObject(GeometryObject& object, const Vector3& pivot, const Vector3& factors)
 {
+    if (object.isPlaced()) {
+        transformPlacedVertices(object, [&](const Vector3& p) { return GeometryTransforms::scaleFromPivot(p, pivot, factors); });
+        return;
+    }
     if (object.getType() == ObjectType::Curve) {
         static_cast<Curve&>(object).scale(pivot, factors);
     } else {
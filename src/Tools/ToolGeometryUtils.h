@@ -11,6 +11,7 @@ struct BoundingBox {
     bool valid = false;
 };
 
+// These work in world space, so they account for the object's placement.
 BoundingBox computeBoundingBox(const GeometryObject& object);
 Vector3 computeCentroid(const GeometryObject& object);
 void translateObject(GeometryObject& object, const Vector3& delta);
@@ -86,9 +86,16 @@ bool ZoomTool::zoomToBounds(bool selectedOnly)
     Vector3 maxBounds;
     bool hasBounds = false;
 
-    for (const auto& object : geometry->getObjects()) {
-        if (selectedOnly && !object->isSelected())
-            continue;
+    std::vector<GeometryObject*> targets;
+    if (selectedOnly) {
+        targets = selectedObjects();
+    } else {
+        targets.reserve(geometry->getObjects().size());
+        for (const auto& object : geometry->getObjects())
+            targets.push_back(object.get());
+    }
+
+    for (GeometryObject* object : targets) {
         BoundingBox box = computeBoundingBox(*object);
         if (!box.valid)
             continue;
@@ -1,12 +1,14 @@
 #include "app/AutosaveManager.h"
 
 #include "Scene/Document.h"
+#include "Scene/SceneSerializer.h"
 
 #include <QCryptographicHash>
 #include <QDir>
 #include <QFile>
 #include <QRegularExpression>
 #include <QStandardPaths>
+#include <QThread>
 
 #include <algorithm>
 
@@ -15,6 +17,12 @@ constexpr int kDefaultIntervalMinutes = 5;
 constexpr int kDefaultRetentionCount = 5;
 }
 
+struct AutosaveManager::PendingAutosave {
+    QString filePath;
+    Scene::SceneSerializer::Result result;
+    std::atomic<int> lastPercent{ -1 };
+};
+
 AutosaveManager::AutosaveManager(QObject* parent)
     : QObject(parent)
 {
@@ -37,6 +45,14 @@ AutosaveManager::AutosaveManager(const QString& storageRoot, QObject* parent)
     prefixCache_ = makePrefix(sourcePath_);
 }
 
+AutosaveManager::~AutosaveManager()
+{
+    if (worker_) {
+        worker_->wait();
+        delete worker_;
+    }
+}
+
 void AutosaveManager::initializeStorageDirectory(const QString& rootOverride)
 {
     QString base = rootOverride;
@@ -107,7 +123,7 @@ QString AutosaveManager::timestampedFilename() const
 
 void AutosaveManager::performAutosave()
 {
-    if (!document_ || autosaveDir_.isEmpty())
+    if (!document_ || autosaveDir_.isEmpty() || worker_)
         return;
 
     QDir dir(autosaveDir_);
@@ -118,13 +134,59 @@ void AutosaveManager::performAutosave()
     const QString filename = timestampedFilename();
     const QString filePath = dir.filePath(filename);
 
-    if (!document_->saveToFile(filePath.toStdString())) {
-        QFile::remove(filePath);
+    // Cloning the geometry is the only work left on the GUI thread; encoding
+    // and disk I/O happen on the worker, which writes to a temporary file and
+    // renames it into place once complete.
+    std::shared_ptr<Scene::SceneSerializer::Snapshot> snapshot = Scene::SceneSerializer::capture(*document_, true);
+    auto pending = std::make_shared<PendingAutosave>();
+    pending->filePath = filePath;
+
+    Scene::SceneSerializer::SaveOptions options;
+    options.progress = [this, pending](std::size_t written, std::size_t total) {
+        const int percent = total == 0 ? 100 : static_cast<int>(written * 100 / total);
+        if (pending->lastPercent.exchange(percent) == percent)
+            return;
+        QMetaObject::invokeMethod(this, [this, percent]() { emit autosaveProgress(percent); }, Qt::QueuedConnection);
+    };
+
+    const std::string target = filePath.toStdString();
+    worker_ = QThread::create([pending, snapshot, options, target]() {
+        pending->result = Scene::SceneSerializer::write(*snapshot, target, options);
+    });
+    // waitForPendingAutosave() may already have finished this job by the time
+    // the queued signal arrives, possibly with a newer one in flight.
+    std::weak_ptr<PendingAutosave> job = pending;
+    connect(worker_, &QThread::finished, this, [this, job]() {
+        if (!job.expired() && job.lock() == pending_)
+            finishAutosave();
+    }, Qt::QueuedConnection);
+    pending_ = pending;
+    emit autosaveStarted(filePath);
+    worker_->start();
+}
+
+void AutosaveManager::waitForPendingAutosave()
+{
+    if (worker_)
+        finishAutosave();
+}
+
+void AutosaveManager::finishAutosave()
+{
+    if (!worker_)
+        return;
+    worker_->wait();
+    delete worker_;
+    worker_ = nullptr;
+    const std::shared_ptr<PendingAutosave> pending = std::move(pending_);
+    if (pending->result.status != Scene::SceneSerializer::Result::Status::Success) {
+        emit autosaveFailed(QString::fromStdString(pending->result.message));
         return;
     }
 
     const auto files = autosaveFileInfos(prefixCache_);
     enforceRetention(files);
+    emit autosaveFinished(pending->filePath);
 }
 
 QVector<QFileInfo> AutosaveManager::autosaveFileInfos(const QString& prefix) const
@@ -219,6 +281,7 @@ void AutosaveManager::clearAutosavesForPrefix(const QString& prefix)
 void AutosaveManager::shutdown()
 {
     timer_.stop();
+    waitForPendingAutosave();
 }
 
 QString AutosaveManager::makePrefix(const QString& path) const
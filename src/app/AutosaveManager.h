@@ -6,8 +6,12 @@
 #include <QTimer>
 #include <QVector>
 
+#include <atomic>
+#include <memory>
 #include <optional>
 
+class QThread;
+
 namespace Scene {
 class Document;
 }
@@ -23,6 +27,7 @@ public:
 
     explicit AutosaveManager(QObject* parent = nullptr);
     explicit AutosaveManager(const QString& storageRoot, QObject* parent = nullptr);
+    ~AutosaveManager() override;
 
     void setDocument(Scene::Document* document);
     Scene::Document* document() const { return document_; }
@@ -36,7 +41,13 @@ public:
     void setRetentionCount(int count);
     int retentionCount() const { return retentionCount_; }
 
+    // Captures a snapshot of the document and writes it on a worker thread.
+    // Skipped while a previous autosave is still being written.
     void performAutosave();
+    bool isAutosaveInProgress() const { return worker_ != nullptr; }
+    // Blocks until the autosave in flight (if any) has finished and its
+    // signals have been emitted.
+    void waitForPendingAutosave();
     QVector<AutosaveInfo> autosaves() const;
     std::optional<AutosaveInfo> latestAutosave() const;
     bool restoreLatest(Scene::Document* document = nullptr);
@@ -49,7 +60,16 @@ public:
 
     void shutdown();
 
+signals:
+    void autosaveStarted(const QString& filePath);
+    void autosaveProgress(int percent);
+    void autosaveFinished(const QString& filePath);
+    void autosaveFailed(const QString& message);
+
 private:
+    struct PendingAutosave;
+
+    void finishAutosave();
     void initializeStorageDirectory(const QString& rootOverride = QString());
     void updateTimer();
     QString makePrefix(const QString& path) const;
@@ -65,5 +85,7 @@ private:
     int intervalMinutes_ = 5;
     int retentionCount_ = 5;
     QTimer timer_;
+    QThread* worker_ = nullptr;
+    std::shared_ptr<PendingAutosave> pending_;
 };
 
@@ -0,0 +1,123 @@
+#include "app/ImportManager.h"
+
+#include "FileIO/Importers/FileImporter.h"
+
+#include <QThread>
+
+#include <atomic>
+
+struct ImportManager::PendingImport {
+    Scene::Document* target = nullptr;
+    QString filePath;
+    Scene::Document::FileFormat format = Scene::Document::FileFormat::Auto;
+    Scene::Document staging;
+    FileIO::Importers::ImportResult result;
+    std::atomic<bool> cancelRequested{ false };
+    // Latest progress, published by the worker. Only one progress signal is
+    // queued at a time; it reads whatever is current when it is delivered.
+    std::atomic<std::uint64_t> bytesRead{ 0 };
+    std::atomic<std::uint64_t> totalBytes{ 0 };
+    std::atomic<std::uint64_t> trianglesBuilt{ 0 };
+    std::atomic<bool> progressQueued{ false };
+};
+
+ImportManager::ImportManager(QObject* parent)
+    : QObject(parent)
+{
+}
+
+ImportManager::~ImportManager()
+{
+    if (worker_) {
+        pending_->cancelRequested = true;
+        worker_->wait();
+        delete worker_;
+    }
+}
+
+bool ImportManager::startImport(Scene::Document* document, const QString& filePath, Scene::Document::FileFormat format)
+{
+    if (!document || worker_)
+        return false;
+
+    auto pending = std::make_shared<PendingImport>();
+    pending->target = document;
+    pending->filePath = filePath;
+    pending->format = format;
+
+    std::weak_ptr<PendingImport> job = pending;
+    auto control = std::make_shared<FileIO::Importers::ImportControl>();
+    control->cancelRequested = &pending->cancelRequested;
+    control->onProgress = [this, job](const FileIO::Importers::ImportProgress& progress) {
+        std::shared_ptr<PendingImport> current = job.lock();
+        if (!current)
+            return;
+        current->bytesRead = progress.bytesRead;
+        current->totalBytes = progress.totalBytes;
+        current->trianglesBuilt = progress.trianglesBuilt;
+        if (current->progressQueued.exchange(true))
+            return;
+        QMetaObject::invokeMethod(this, [this, job]() {
+            std::shared_ptr<PendingImport> queued = job.lock();
+            if (!queued)
+                return;
+            queued->progressQueued = false;
+            emit importProgress(static_cast<qint64>(queued->bytesRead.load()),
+                                static_cast<qint64>(queued->totalBytes.load()),
+                                static_cast<qint64>(queued->trianglesBuilt.load()));
+        }, Qt::QueuedConnection);
+    };
+
+    // The worker only touches the staging document; the target is modified
+    // by finishImport() on this thread.
+    worker_ = QThread::create([pending, control]() {
+        pending->result = FileIO::Importers::FileImporter::import(pending->filePath, pending->staging, pending->format,
+                                                                  control.get());
+    });
+    connect(worker_, &QThread::finished, this, [this, job]() {
+        if (!job.expired() && job.lock() == pending_)
+            finishImport();
+    }, Qt::QueuedConnection);
+    pending_ = pending;
+    emit importStarted(filePath);
+    worker_->start();
+    return true;
+}
+
+void ImportManager::cancel()
+{
+    if (pending_)
+        pending_->cancelRequested = true;
+}
+
+void ImportManager::waitForPendingImport()
+{
+    if (worker_)
+        finishImport();
+}
+
+void ImportManager::shutdown()
+{
+    cancel();
+    waitForPendingImport();
+}
+
+void ImportManager::finishImport()
+{
+    if (!worker_)
+        return;
+    worker_->wait();
+    delete worker_;
+    worker_ = nullptr;
+    const std::shared_ptr<PendingImport> pending = std::move(pending_);
+
+    if (pending->result.cancelled || pending->cancelRequested) {
+        emit importCancelled(pending->filePath);
+        return;
+    }
+    if (!pending->target->commitImport(pending->staging, pending->result, pending->filePath.toStdString())) {
+        emit importFailed(pending->filePath, QString::fromStdString(pending->target->lastImportError()));
+        return;
+    }
+    emit importFinished(pending->filePath);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+#include <memory>
+
+#include "Scene/Document.h"
+
+class QThread;
+
+// Runs FileImporter on a worker thread into a detached document and merges
+// the result into the target document on the GUI thread once it is complete.
+// One import runs at a time.
+class ImportManager : public QObject {
+    Q_OBJECT
+public:
+    explicit ImportManager(QObject* parent = nullptr);
+    ~ImportManager() override;
+
+    // Starts importing filePath for document. Returns false if an import is
+    // already running. The document must outlive the import.
+    bool startImport(Scene::Document* document, const QString& filePath,
+                     Scene::Document::FileFormat format = Scene::Document::FileFormat::Auto);
+    bool isImportInProgress() const { return worker_ != nullptr; }
+    // Asks the running import to stop; importCancelled() follows once the
+    // worker has noticed. The target document is not modified.
+    void cancel();
+    // Blocks until the import in flight (if any) has finished and its signals
+    // have been emitted.
+    void waitForPendingImport();
+    // Cancels and waits for the import in flight.
+    void shutdown();
+
+signals:
+    void importStarted(const QString& filePath);
+    void importProgress(qint64 bytesRead, qint64 totalBytes, qint64 trianglesBuilt);
+    void importFinished(const QString& filePath);
+    void importFailed(const QString& filePath, const QString& message);
+    void importCancelled(const QString& filePath);
+
+private:
+    struct PendingImport;
+
+    void finishImport();
+
+    QThread* worker_ = nullptr;
+    std::shared_ptr<PendingImport> pending_;
+};
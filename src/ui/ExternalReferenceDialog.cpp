@@ -87,7 +87,7 @@ Scene::ExternalReferenceOptions ExternalReferenceDialog::options() const
 
 void ExternalReferenceDialog::browseForReference()
 {
-    const QString file = QFileDialog::getOpenFileName(this, tr("Select External Reference"), QString(), tr("Scene Files (*.obj *.stl *.gltf *.fbx *.dxf *.dwg);;All Files (*)"));
+    const QString file = QFileDialog::getOpenFileName(this, tr("Select External Reference"), QString(), tr("Scene Files (*.obj *.stl *.gltf *.glb *.fbx *.dxf *.dwg);;All Files (*)"));
     if (!file.isEmpty()) {
         pathEdit->setText(file);
         if (nameEdit->text().trimmed().isEmpty()) {
@@ -1,11 +1,35 @@
 #include "HistoryPanel.h"
 
+#include "Core/Command.h"
+
+#include <QEvent>
+#include <QHelpEvent>
 #include <QLabel>
+#include <QLocale>
+#include <QToolTip>
 #include <QVBoxLayout>
 #include <QUndoStack>
 #include <QUndoView>
 #include <Qt>
 
+#include <cstddef>
+
+namespace {
+
+std::size_t commandFootprint(const QUndoCommand* command)
+{
+    if (!command)
+        return 0;
+    std::size_t bytes = 0;
+    if (const auto* tracked = dynamic_cast<const Core::Command*>(command))
+        bytes = tracked->memoryFootprint();
+    for (int i = 0; i < command->childCount(); ++i)
+        bytes += commandFootprint(command->child(i));
+    return bytes;
+}
+
+} // namespace
+
 HistoryPanel::HistoryPanel(QUndoStack* stack, QWidget* parent)
     : QWidget(parent)
 {
@@ -21,18 +45,28 @@ HistoryPanel::HistoryPanel(QUndoStack* stack, QWidget* parent)
     placeholder_->setAlignment(Qt::AlignCenter);
     placeholder_->setWordWrap(true);
 
+    memoryLabel_ = new QLabel(this);
+    memoryLabel_->setWordWrap(true);
+
+    view_->viewport()->installEventFilter(this);
+
     layout->addWidget(view_);
     layout->addWidget(placeholder_);
+    layout->addWidget(memoryLabel_);
 
     setUndoStack(stack);
 }
 
 void HistoryPanel::setUndoStack(QUndoStack* stack)
 {
+    disconnect(indexConnection_);
     undoStack_ = stack;
     if (view_)
         view_->setStack(stack);
+    if (stack)
+        indexConnection_ = connect(stack, &QUndoStack::indexChanged, this, &HistoryPanel::updateMemoryUsage);
     updateVisibility();
+    updateMemoryUsage();
 }
 
 void HistoryPanel::updateVisibility()
@@ -42,6 +76,38 @@ void HistoryPanel::updateVisibility()
         view_->setVisible(hasStack);
     if (placeholder_)
         placeholder_->setVisible(!hasStack);
+    if (memoryLabel_)
+        memoryLabel_->setVisible(hasStack);
+}
+
+void HistoryPanel::updateMemoryUsage()
+{
+    if (!memoryLabel_ || !undoStack_)
+        return;
+    std::size_t total = 0;
+    for (int i = 0; i < undoStack_->count(); ++i)
+        total += commandFootprint(undoStack_->command(i));
+    memoryLabel_->setText(tr("Undo memory: %1").arg(locale().formattedDataSize(static_cast<qint64>(total))));
+}
+
+bool HistoryPanel::eventFilter(QObject* watched, QEvent* event)
+{
+    if (view_ && undoStack_ && watched == view_->viewport() && event->type() == QEvent::ToolTip) {
+        auto* help = static_cast<QHelpEvent*>(event);
+        // Row 0 is the empty state; row n is command n - 1.
+        const int row = view_->indexAt(help->pos()).row();
+        if (row > 0 && row <= undoStack_->count()) {
+            const QUndoCommand* command = undoStack_->command(row - 1);
+            const qint64 bytes = static_cast<qint64>(commandFootprint(command));
+            QToolTip::showText(help->globalPos(),
+                               tr("%1\nKeeps %2 for undo").arg(command->text(), locale().formattedDataSize(bytes)),
+                               view_);
+        } else {
+            QToolTip::hideText();
+        }
+        return true;
+    }
+    return QWidget::eventFilter(watched, event);
 }
 
 void HistoryPanel::refresh()
@@ -49,4 +115,5 @@ void HistoryPanel::refresh()
     if (view_)
         view_->setStack(undoStack_);
     updateVisibility();
+    updateMemoryUsage();
 }
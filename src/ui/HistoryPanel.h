@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QMetaObject>
 #include <QWidget>
 
 class QLabel;
@@ -14,10 +15,18 @@ public:
     void setUndoStack(QUndoStack* stack);
     void refresh();
 
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
 private:
     void updateVisibility();
+    // Total of Core::Command::memoryFootprint() over the stack; each entry's
+    // share is shown in its tooltip.
+    void updateMemoryUsage();
 
     QUndoStack* undoStack_ = nullptr;
     QUndoView* view_ = nullptr;
     QLabel* placeholder_ = nullptr;
+    QLabel* memoryLabel_ = nullptr;
+    QMetaObject::Connection indexConnection_;
 };
@@ -1244,10 +1244,7 @@ void InspectorPanel::rebuildTagList()
         Scene::Document::TagId tagId = pair.second;
         int assignedCount = 0;
         for (Scene::Document::ObjectId objectId : currentSelectionIds) {
-            const Scene::Document::ObjectNode* node = currentDocument->findObject(objectId);
-            if (!node)
-                continue;
-            if (std::find(node->tags.begin(), node->tags.end(), tagId) != node->tags.end())
+            if (currentDocument->hasTag(objectId, tagId))
                 ++assignedCount;
         }
         Qt::CheckState state = Qt::Unchecked;
@@ -1469,12 +1466,10 @@ void InspectorPanel::commitTagChange(QListWidgetItem* item)
 
     if (!currentDocument)
         return;
-    for (Scene::Document::ObjectId id : currentSelectionIds) {
-        if (assign)
-            currentDocument->assignTag(id, tagId);
-        else
-            currentDocument->removeTag(id, tagId);
-    }
+    if (assign)
+        currentDocument->assignTagToObjects(currentSelectionIds, tagId);
+    else
+        currentDocument->removeTagFromObjects(currentSelectionIds, tagId);
     refreshAfterCommand();
 }
 
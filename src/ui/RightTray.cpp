@@ -145,14 +145,7 @@ void RightTray::handleAssignMaterial(const QString& name)
     if (!commandStack_ || !document_ || !geometry_)
         return;
 
-    std::vector<Scene::Document::ObjectId> selection;
-    for (const auto& object : geometry_->getObjects()) {
-        if (!object->isSelected())
-            continue;
-        Scene::Document::ObjectId id = document_->objectIdForGeometry(object.get());
-        if (id != 0)
-            selection.push_back(id);
-    }
+    const std::vector<Scene::Document::ObjectId>& selection = document_->selection().ids();
     if (selection.empty())
         return;
 
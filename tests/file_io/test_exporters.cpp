@@ -1,14 +1,25 @@
 #include "FileIO/Exporters/SceneExporter.h"
 #include "FileIO/Importers/SceneImporter.h"
 #include "GeometryKernel/GeometryKernel.h"
+#include "GeometryKernel/MeshOptimizer.h"
 #include "GeometryKernel/Solid.h"
+#include "GeometryKernel/TransformUtils.h"
 #include "Scene/Document.h"
 
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+
 #include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <filesystem>
+#include <fstream>
 #include <limits>
+#include <sstream>
+#include <string>
 #include <unordered_map>
 #include <utility>
 
@@ -75,7 +86,8 @@ SceneStats summarizeScene(const Scene::Document& document)
         stats.triangleCount += triangles;
         std::string material = document.geometry().getMaterial(obj.get());
         stats.materialTriangles[material] += triangles;
-        for (const auto& v : buffer.positions) {
+        for (const auto& local : buffer.positions) {
+            const Vector3 v = obj->isPlaced() ? GeometryTransforms::transformPoint(obj->placement(), local) : local;
             stats.minBounds.x = std::min(stats.minBounds.x, v.x);
             stats.minBounds.y = std::min(stats.minBounds.y, v.y);
             stats.minBounds.z = std::min(stats.minBounds.z, v.z);
@@ -123,6 +135,196 @@ void verifyRoundTrip(FileIO::SceneFormat format, const std::filesystem::path& ba
     assert(within(actual.maxBounds.z, expected.maxBounds.z));
 }
 
+std::string readFile(const std::filesystem::path& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+// Exports run per object on worker threads but must produce the same bytes as
+// a serial export.
+void verifyParallelExportMatchesSerial(FileIO::SceneFormat format, const std::filesystem::path& basePath)
+{
+    Scene::Document source;
+    buildSampleScene(source);
+    std::filesystem::create_directories(basePath.parent_path());
+
+    const auto serialPath = basePath.parent_path() / ("serial_" + basePath.filename().string());
+    const auto parallelPath = basePath.parent_path() / ("parallel_" + basePath.filename().string());
+    bool serialOk = FileIO::Exporters::exportScene(source, serialPath.string(), format, nullptr, 1);
+    bool parallelOk = FileIO::Exporters::exportScene(source, parallelPath.string(), format, nullptr, 4);
+    assert(serialOk);
+    assert(parallelOk);
+    const std::string serial = readFile(serialPath);
+    assert(!serial.empty());
+    assert(serial == readFile(parallelPath));
+}
+
+// Translated copies of one solid should be written once and referenced from a
+// node per copy, and still come back at their original positions.
+void verifyGltfSharesTranslatedCopies(const std::filesystem::path& path)
+{
+    Scene::Document source;
+    auto& kernel = source.geometry();
+    std::vector<Vector3> base{
+        { 0.0f, 0.0f, 0.0f },
+        { 1.0f, 0.0f, 0.0f },
+        { 1.0f, 0.0f, 1.0f },
+        { 0.0f, 0.0f, 1.0f }
+    };
+    for (int i = 0; i < 3; ++i) {
+        auto solid = Solid::createFromProfile(base, 2.0f);
+        solid->translate(Vector3(3.0f * static_cast<float>(i), 0.0f, 0.0f));
+        GeometryObject* object = kernel.addObject(std::move(solid));
+        kernel.assignMaterial(object, "Concrete");
+        source.ensureObjectForGeometry(object, "Pillar_" + std::to_string(i));
+    }
+    source.synchronizeWithGeometry();
+    SceneStats expected = summarizeScene(source);
+
+    std::filesystem::create_directories(path.parent_path());
+    bool exported = FileIO::Exporters::exportScene(source, path.string(), FileIO::SceneFormat::GLTF);
+    assert(exported);
+
+    QFile file(QString::fromStdString(path.string()));
+    bool opened = file.open(QIODevice::ReadOnly);
+    assert(opened);
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    assert(root.value("meshes").toArray().size() == 1);
+    assert(root.value("nodes").toArray().size() == 3);
+
+    Scene::Document imported;
+    bool importedOk = FileIO::Importers::importScene(imported, path.string(), FileIO::SceneFormat::GLTF);
+    assert(importedOk);
+    SceneStats actual = summarizeScene(imported);
+    assert(actual.triangleCount == expected.triangleCount);
+    assert(actual.materialTriangles == expected.materialTriangles);
+    assert(std::abs(actual.minBounds.x - expected.minBounds.x) <= 1e-3f);
+    assert(std::abs(actual.maxBounds.x - expected.maxBounds.x) <= 1e-3f);
+
+    // The copies come back as instances of one component that share its mesh
+    // and are placed by their node transforms, so refreshing them from the
+    // definition leaves each one where it was.
+    std::vector<Scene::Document::ObjectId> instanceIds;
+    for (const auto& child : imported.objectTree().children) {
+        if (child->kind == Scene::Document::NodeKind::ComponentInstance) {
+            instanceIds.push_back(child->id);
+        }
+    }
+    assert(instanceIds.size() == 3);
+    auto partOf = [&imported](Scene::Document::ObjectId id) {
+        const Scene::Document::ObjectNode* node = imported.findObject(id);
+        assert(node && node->children.size() == 1 && node->children.front()->geometry);
+        return node->children.front()->geometry;
+    };
+    auto placedMinX = [&imported](const GeometryObject& object) {
+        float minX = std::numeric_limits<float>::max();
+        for (const auto& v : imported.geometry().buildMeshBuffer(object).positions) {
+            minX = std::min(minX, GeometryTransforms::transformPoint(object.placement(), v).x);
+        }
+        return minX;
+    };
+    std::vector<float> placedAt;
+    for (Scene::Document::ObjectId id : instanceIds) {
+        placedAt.push_back(placedMinX(*partOf(id)));
+    }
+    std::vector<float> sortedAt = placedAt;
+    std::sort(sortedAt.begin(), sortedAt.end());
+    for (int i = 0; i < 3; ++i) {
+        assert(std::abs(sortedAt[static_cast<std::size_t>(i)] - 3.0f * static_cast<float>(i)) <= 1e-3f);
+    }
+    auto verifyInstances = [&]() {
+        const GeometryObject* first = partOf(instanceIds.front());
+        for (std::size_t i = 0; i < instanceIds.size(); ++i) {
+            const GeometryObject* part = partOf(instanceIds[i]);
+            assert(part->getMesh().sharesStorageWith(first->getMesh()));
+            assert(std::abs(placedMinX(*part) - placedAt[i]) <= 1e-3f);
+        }
+    };
+    verifyInstances();
+    const Scene::Document::ComponentDefinitionId definitionId = imported.findObject(instanceIds.front())->definitionId;
+    imported.refreshComponentInstances(definitionId);
+    verifyInstances();
+    bool updated = imported.updateComponentDefinition(instanceIds.back());
+    assert(updated);
+    verifyInstances();
+}
+
+// Quantised glTF keeps the scene within quantisation error, declares the
+// extension and is smaller than the float payload.
+void verifyQuantizedGltf(const std::filesystem::path& path)
+{
+    Scene::Document source;
+    buildSampleScene(source);
+    SceneStats expected = summarizeScene(source);
+
+    FileIO::Exporters::ExportOptions options;
+    options.optimizeMeshes = true;
+    options.quantizeGltf = true;
+    FileIO::Exporters::ExportSummary summary;
+    std::filesystem::create_directories(path.parent_path());
+    bool exported = FileIO::Exporters::exportScene(source, path.string(), FileIO::SceneFormat::GLTF, options, &summary);
+    assert(exported);
+    assert(summary.meshes == 2);
+    assert(summary.triangles == expected.triangleCount);
+    assert(summary.geometryBytes < summary.fullPrecisionBytes);
+    assert(summary.acmrAfter > 0.0);
+    assert(summary.acmrAfter <= summary.acmrBefore);
+
+    QFile file(QString::fromStdString(path.string()));
+    bool opened = file.open(QIODevice::ReadOnly);
+    assert(opened);
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    assert(root.value("extensionsRequired").toArray().contains(QStringLiteral("KHR_mesh_quantization")));
+
+    Scene::Document imported;
+    bool importedOk = FileIO::Importers::importScene(imported, path.string(), FileIO::SceneFormat::GLTF);
+    assert(importedOk);
+    SceneStats actual = summarizeScene(imported);
+    assert(actual.triangleCount == expected.triangleCount);
+    assert(actual.materialTriangles == expected.materialTriangles);
+    const float tolerance = 1e-3f;
+    assert(std::abs(actual.minBounds.x - expected.minBounds.x) <= tolerance);
+    assert(std::abs(actual.minBounds.y - expected.minBounds.y) <= tolerance);
+    assert(std::abs(actual.maxBounds.y - expected.maxBounds.y) <= tolerance);
+    assert(std::abs(actual.maxBounds.z - expected.maxBounds.z) <= tolerance);
+
+    // The dequantisation scale is baked into the vertices rather than left in
+    // the placement, so tools see real coordinates.
+    for (const auto& object : imported.geometry().getObjects()) {
+        assert(!object->isPlaced());
+    }
+}
+
+// The optimised buffer is reused until the object changes, keeps every
+// triangle and never raises the cache miss ratio.
+void verifyOptimizedMeshCache()
+{
+    Scene::Document document;
+    buildSampleScene(document);
+    auto& kernel = document.geometry();
+    const auto& objects = kernel.getObjects();
+    assert(!objects.empty());
+    GeometryObject* object = objects.front().get();
+    assert(object->getType() == ObjectType::Solid);
+
+    const GeometryKernel::MeshBuffer raw = kernel.buildMeshBuffer(*object);
+    const auto optimized = kernel.optimizedMeshBuffer(*object);
+    assert(optimized);
+    assert(kernel.optimizedMeshBuffer(*object) == optimized);
+    assert(optimized->indices.size() == raw.indices.size());
+    assert(optimized->positions.size() == optimized->normals.size());
+    assert(MeshOptimizer::averageCacheMissRatio(optimized->indices, optimized->positions.size())
+           <= MeshOptimizer::averageCacheMissRatio(raw.indices, raw.positions.size()));
+
+    static_cast<Solid*>(object)->translate(Vector3(1.0f, 0.0f, 0.0f));
+    const auto moved = kernel.optimizedMeshBuffer(*object);
+    assert(moved != optimized);
+    assert(std::abs(moved->positions.front().x - optimized->positions.front().x - 1.0f) <= 1e-4f);
+}
+
 }
 
 int main()
@@ -131,5 +333,10 @@ int main()
     verifyRoundTrip(FileIO::SceneFormat::OBJ, tempRoot / "scene.obj");
     verifyRoundTrip(FileIO::SceneFormat::STL, tempRoot / "scene.stl");
     verifyRoundTrip(FileIO::SceneFormat::GLTF, tempRoot / "scene.gltf");
+    verifyParallelExportMatchesSerial(FileIO::SceneFormat::OBJ, tempRoot / "threads.obj");
+    verifyParallelExportMatchesSerial(FileIO::SceneFormat::STL, tempRoot / "threads.stl");
+    verifyGltfSharesTranslatedCopies(tempRoot / "shared.gltf");
+    verifyQuantizedGltf(tempRoot / "quantized.gltf");
+    verifyOptimizedMeshCache();
     return 0;
 }
@@ -3,9 +3,14 @@
 #include "GeometryKernel/GeometryObject.h"
 #include "GeometryKernel/HalfEdgeMesh.h"
 #include "GeometryKernel/Vector3.h"
+#include "FileIO/Importers/FileImporter.h"
+#include "FileIO/Importers/ObjParser.h"
+#include <QString>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <string>
 #include <vector>
 #include <cstring>
 #include <cstdint>
@@ -42,6 +47,32 @@ bool writeBinaryStl(const fs::path& path)
     return static_cast<bool>(out);
 }
 
+// Binary STL whose header starts with "solid" and whose two triangles share an
+// edge; the importer must detect it as binary and weld the shared corners.
+bool writeSolidHeaderQuadStl(const fs::path& path)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    char header[80] = {};
+    std::memcpy(header, "solid exported by a binary writer", 33);
+    out.write(header, sizeof(header));
+    std::uint32_t triangleCount = 2;
+    out.write(reinterpret_cast<const char*>(&triangleCount), sizeof(triangleCount));
+
+    const float triangles[2][12] = {
+        { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f },
+        { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, -0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f }
+    };
+    for (const auto& triangle : triangles) {
+        out.write(reinterpret_cast<const char*>(triangle), sizeof(triangle));
+        std::uint16_t attribute = 0;
+        out.write(reinterpret_cast<const char*>(&attribute), sizeof(attribute));
+    }
+    return static_cast<bool>(out);
+}
+
 std::size_t appendBytes(std::vector<std::uint8_t>& buffer, const void* data, std::size_t byteCount, std::size_t alignment)
 {
     if (alignment > 0) {
@@ -149,6 +180,92 @@ bool writeTransformGltf(const fs::path& gltfPath, const fs::path& binPath)
     return static_cast<bool>(binOut);
 }
 
+// GLB whose positions live in the embedded binary chunk (buffer 0) and whose
+// indices come from a second, external buffer.
+bool writeTwoBufferGlb(const fs::path& glbPath, const fs::path& indexPath)
+{
+    const float positions[9] = { 0.0f, 0.0f, 0.0f, 2.0f, 0.0f, 0.0f, 0.0f, 2.0f, 0.0f };
+    const std::uint32_t indices[3] = { 0, 1, 2 };
+
+    std::ofstream indexOut(indexPath, std::ios::binary | std::ios::trunc);
+    if (!indexOut) {
+        return false;
+    }
+    indexOut.write(reinterpret_cast<const char*>(indices), sizeof(indices));
+    indexOut.close();
+
+    std::ostringstream json;
+    json << R"({ "asset": { "version": "2.0" }, )";
+    json << R"("buffers": [{ "byteLength": )" << sizeof(positions) << R"( }, { "uri": ")" << indexPath.filename().string()
+         << R"(", "byteLength": )" << sizeof(indices) << " }],";
+    json << R"("bufferViews": [{ "buffer": 0, "byteLength": )" << sizeof(positions) << R"( },)";
+    json << R"({ "buffer": 1, "byteLength": )" << sizeof(indices) << " }],";
+    json << R"("accessors": [{ "bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3" },)";
+    json << R"({ "bufferView": 1, "componentType": 5125, "count": 3, "type": "SCALAR" }],)";
+    json << R"("meshes": [{ "name": "Packed", "primitives": [{ "attributes": { "POSITION": 0 }, "indices": 1 }] }],)";
+    json << R"("nodes": [{ "name": "PackedNode", "mesh": 0 }], "scenes": [{ "nodes": [0] }], "scene": 0 })";
+    std::string jsonText = json.str();
+    while (jsonText.size() % 4 != 0) {
+        jsonText.push_back(' ');
+    }
+
+    const std::uint32_t jsonLength = static_cast<std::uint32_t>(jsonText.size());
+    const std::uint32_t binLength = static_cast<std::uint32_t>(sizeof(positions));
+    const std::uint32_t header[3] = { 0x46546C67u, 2u, 12u + 8u + jsonLength + 8u + binLength };
+    const std::uint32_t jsonChunk[2] = { jsonLength, 0x4E4F534Au };
+    const std::uint32_t binChunk[2] = { binLength, 0x004E4942u };
+
+    std::ofstream out(glbPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(jsonChunk), sizeof(jsonChunk));
+    out.write(jsonText.data(), static_cast<std::streamsize>(jsonText.size()));
+    out.write(reinterpret_cast<const char*>(binChunk), sizeof(binChunk));
+    out.write(reinterpret_cast<const char*>(positions), sizeof(positions));
+    return static_cast<bool>(out);
+}
+
+// One mesh placed by three nodes at different translations.
+bool writeInstancedGltf(const fs::path& gltfPath, const fs::path& binPath)
+{
+    const float positions[9] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f };
+    const std::uint16_t indices[3] = { 0, 1, 2 };
+    std::vector<std::uint8_t> buffer;
+    std::size_t posOffset = appendBytes(buffer, positions, sizeof(positions), 4);
+    std::size_t idxOffset = appendBytes(buffer, indices, sizeof(indices), 2);
+
+    std::ostringstream json;
+    json << R"({ "asset": { "version": "2.0" }, )";
+    json << R"("buffers": [{ "uri": ")" << binPath.filename().string() << R"(", "byteLength": )" << buffer.size() << " }],";
+    json << R"("bufferViews": [{ "buffer": 0, "byteOffset": )" << posOffset << R"(, "byteLength": )" << sizeof(positions) << " },";
+    json << R"({ "buffer": 0, "byteOffset": )" << idxOffset << R"(, "byteLength": )" << sizeof(indices) << " }],";
+    json << R"("accessors": [{ "bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3" },)";
+    json << R"({ "bufferView": 1, "componentType": 5123, "count": 3, "type": "SCALAR" }],)";
+    json << R"("materials": [{ "name": "Bark" }],)";
+    json << R"("meshes": [{ "name": "Tree", "primitives": [{ "attributes": { "POSITION": 0 }, "indices": 1, "material": 0 }] }],)";
+    json << R"("nodes": [)";
+    json << R"({ "name": "TreeA", "mesh": 0 },)";
+    json << R"({ "name": "TreeB", "mesh": 0, "translation": [10.0, 0.0, 0.0] },)";
+    json << R"({ "name": "TreeC", "mesh": 0, "translation": [0.0, 0.0, 5.0] }],)";
+    json << R"("scenes": [{ "nodes": [0, 1, 2] }], "scene": 0 })";
+
+    std::ofstream jsonOut(gltfPath, std::ios::trunc);
+    if (!jsonOut) {
+        return false;
+    }
+    jsonOut << json.str();
+    jsonOut.close();
+
+    std::ofstream binOut(binPath, std::ios::binary | std::ios::trunc);
+    if (!binOut) {
+        return false;
+    }
+    binOut.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(binOut);
+}
+
 Vector3 applyTestTransform(const Vector3& v)
 {
     Vector3 scaled(v.x * 2.0f, v.y * 3.0f, v.z * 1.0f);
@@ -165,6 +282,46 @@ bool positionNear(const Vector3& a, const Vector3& b, float tolerance)
     return delta.lengthSquared() <= tolerance * tolerance;
 }
 
+// Parses the same text in one slice and in many tiny slices; relative indices
+// that reach back into earlier slices must resolve identically.
+bool checkChunkedObjParse()
+{
+    std::string text = "o First\r\nusemtl Red\n";
+    for (int i = 0; i < 60; ++i) {
+        text += "v " + std::to_string(i) + ".5 -" + std::to_string(i) + "e-2 1.25E1\r\n";
+        if (i % 3 == 2)
+            text += (i % 2) ? "f -3 -2 -1\n" : "f " + std::to_string(i - 1) + "//1 " + std::to_string(i) + " " + std::to_string(i + 1) + "/1/1\n";
+        if (i == 30)
+            text += "g  Second  \nvn 0 0 1\nvt 0.5 0.25\n# comment\n\n";
+    }
+
+    FileIO::Importers::ObjData whole;
+    FileIO::Importers::ObjData sliced;
+    if (!FileIO::Importers::parseObjBuffer(text.data(), text.size(), whole, 1)
+        || !FileIO::Importers::parseObjBuffer(text.data(), text.size(), sliced, 4, 16)) {
+        return false;
+    }
+    if (whole.positions.size() != 60 || whole.faceCount() != 20 || whole.faceOffsets != sliced.faceOffsets)
+        return false;
+    if (std::fabs(whole.positions[3].x - 3.5f) > 1e-6f || std::fabs(whole.positions[3].y + 0.03f) > 1e-6f
+        || whole.positions[3].z != 12.5f) {
+        return false;
+    }
+    for (std::size_t f = 0; f < whole.faceCount(); ++f) {
+        const auto& first = sliced.corners[sliced.faceOffsets[f]];
+        if (first.position != static_cast<int>(f * 3) || sliced.corners[sliced.faceOffsets[f] + 2].position != first.position + 2)
+            return false;
+    }
+    for (std::size_t c = 0; c < whole.corners.size(); ++c) {
+        if (whole.corners[c].position != sliced.corners[c].position || whole.corners[c].normal != sliced.corners[c].normal
+            || whole.corners[c].texCoord != sliced.corners[c].texCoord) {
+            return false;
+        }
+    }
+    return sliced.groups.size() == 2 && sliced.groups[1].name == "Second" && sliced.groups[1].firstFace == whole.groups[1].firstFace
+        && sliced.materials.size() == 1 && sliced.materials[0].name == "Red" && sliced.texCoords.size() == 1;
+}
+
 std::vector<Vector3> uniquePositions(const std::vector<Vector3>& positions, float tolerance)
 {
     std::vector<Vector3> unique;
@@ -239,6 +396,11 @@ int main()
         return 8;
     }
 
+    if (!checkChunkedObjParse()) {
+        std::cerr << "Chunked OBJ parse mismatch" << '\n';
+        return 24;
+    }
+
     Scene::Document stlDoc;
     if (!stlDoc.importExternalModel(stlPath.string(), Scene::Document::FileFormat::Auto)) {
         std::cerr << "STL import failed: " << stlDoc.lastImportError() << '\n';
@@ -281,6 +443,24 @@ int main()
         return 18;
     }
 
+    fs::path quadStlPath = tempDir / "solid_header_quad.stl";
+    if (!writeSolidHeaderQuadStl(quadStlPath)) {
+        std::cerr << "Failed to write welded STL test file" << '\n';
+        return 25;
+    }
+
+    Scene::Document quadDoc;
+    if (!quadDoc.importExternalModel(quadStlPath.string(), Scene::Document::FileFormat::Auto)) {
+        std::cerr << "Welded STL import failed: " << quadDoc.lastImportError() << '\n';
+        return 26;
+    }
+    const auto& quadObjects = quadDoc.geometry().getObjects();
+    if (quadObjects.size() != 1 || quadObjects.front()->getMesh().getVertices().size() != 4
+        || quadObjects.front()->getMesh().getTriangles().size() != 2) {
+        std::cerr << "Binary STL corners were not welded" << '\n';
+        return 27;
+    }
+
     fs::path gltfPath = tempDir / "hierarchy_transform.gltf";
     fs::path binPath = tempDir / "hierarchy_transform.bin";
     if (!writeTransformGltf(gltfPath, binPath)) {
@@ -343,6 +523,118 @@ int main()
         }
     }
 
+    fs::path glbPath = tempDir / "two_buffers.glb";
+    fs::path glbIndexPath = tempDir / "two_buffers_indices.bin";
+    if (!writeTwoBufferGlb(glbPath, glbIndexPath)) {
+        std::cerr << "Failed to write GLB test assets" << '\n';
+        return 28;
+    }
+
+    Scene::Document glbDoc;
+    if (!glbDoc.importExternalModel(glbPath.string(), Scene::Document::FileFormat::Auto)) {
+        std::cerr << "GLB import failed: " << glbDoc.lastImportError() << '\n';
+        return 29;
+    }
+    const auto& glbObjects = glbDoc.geometry().getObjects();
+    if (glbObjects.size() != 1 || glbObjects.front()->getMesh().getTriangles().size() != 1) {
+        std::cerr << "GLB import produced unexpected geometry" << '\n';
+        return 30;
+    }
+    bool foundFarCorner = false;
+    for (const auto& vtx : glbObjects.front()->getMesh().getVertices()) {
+        foundFarCorner = foundFarCorner || positionNear(vtx.position, Vector3(2.0f, 0.0f, 0.0f), 1e-5f);
+    }
+    if (!foundFarCorner) {
+        std::cerr << "GLB positions were not read from the binary chunk" << '\n';
+        return 31;
+    }
+
+    fs::path instancedPath = tempDir / "instanced.gltf";
+    fs::path instancedBinPath = tempDir / "instanced.bin";
+    if (!writeInstancedGltf(instancedPath, instancedBinPath)) {
+        std::cerr << "Failed to write instanced glTF test assets" << '\n';
+        return 32;
+    }
+
+    Scene::Document instancedDoc;
+    if (!instancedDoc.importExternalModel(instancedPath.string(), Scene::Document::FileFormat::Auto)) {
+        std::cerr << "Instanced glTF import failed: " << instancedDoc.lastImportError() << '\n';
+        return 33;
+    }
+    const auto& instanceNodes = instancedDoc.objectTree().children;
+    if (instanceNodes.size() != 3) {
+        std::cerr << "Expected one node per glTF placement" << '\n';
+        return 34;
+    }
+    const Vector3 expectedOrigins[3] = { { 0.0f, 0.0f, 0.0f }, { 10.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 5.0f } };
+    for (std::size_t i = 0; i < instanceNodes.size(); ++i) {
+        const auto& node = *instanceNodes[i];
+        if (node.kind != Scene::Document::NodeKind::ComponentInstance || node.definitionId == 0
+            || node.definitionId != instanceNodes.front()->definitionId || node.children.size() != 1
+            || !node.children.front()->geometry) {
+            std::cerr << "glTF placements were not imported as instances of one definition" << '\n';
+            return 35;
+        }
+        bool foundOrigin = false;
+        for (const auto& vtx : node.children.front()->geometry->getMesh().getVertices()) {
+            foundOrigin = foundOrigin || positionNear(vtx.position, expectedOrigins[i], 1e-5f);
+        }
+        if (!foundOrigin) {
+            std::cerr << "Instance transform was not applied" << '\n';
+            return 36;
+        }
+    }
+    const auto& instancedMetadata = instancedDoc.importedObjectMetadata();
+    auto instanceMeta = instancedMetadata.find(instanceNodes.front()->id);
+    if (instanceMeta == instancedMetadata.end() || instanceMeta->second.materialSlots.size() != 1
+        || instanceMeta->second.materialSlots.front() != "Bark") {
+        std::cerr << "Instance material slots missing" << '\n';
+        return 37;
+    }
+
+    std::atomic<bool> cancelFlag{ true };
+    FileIO::Importers::ImportControl cancelControl;
+    cancelControl.cancelRequested = &cancelFlag;
+    Scene::Document cancelStaging;
+    auto cancelled = FileIO::Importers::FileImporter::import(QString::fromStdString(objPath.string()), cancelStaging,
+                                                             Scene::Document::FileFormat::Auto, &cancelControl);
+    if (cancelled.success || !cancelled.cancelled || !cancelStaging.geometry().getObjects().empty()) {
+        std::cerr << "Cancelled import should stop before building geometry" << '\n';
+        return 38;
+    }
+
+    FileIO::Importers::ImportProgress lastProgress;
+    FileIO::Importers::ImportControl progressControl;
+    progressControl.onProgress = [&lastProgress](const FileIO::Importers::ImportProgress& progress) {
+        lastProgress = progress;
+    };
+    Scene::Document staging;
+    auto stagedResult = FileIO::Importers::FileImporter::import(QString::fromStdString(objPath.string()), staging,
+                                                                Scene::Document::FileFormat::Auto, &progressControl);
+    if (!stagedResult.success || lastProgress.totalBytes == 0 || lastProgress.bytesRead != lastProgress.totalBytes
+        || lastProgress.trianglesBuilt == 0) {
+        std::cerr << "Import progress was not reported" << '\n';
+        return 39;
+    }
+
+    // Merging keeps existing objects and gives the imported ones fresh ids.
+    const std::size_t stlObjects = stlDoc.geometry().getObjects().size();
+    const Scene::Document::ObjectId existingId = stlDoc.objectTree().children.front()->id;
+    if (!stlDoc.commitImport(staging, stagedResult, objPath.string())
+        || stlDoc.geometry().getObjects().size() != stlObjects + 1 || !staging.geometry().getObjects().empty()
+        || stlDoc.objectTree().children.size() != stlObjects + 1) {
+        std::cerr << "Staged import was not merged" << '\n';
+        return 40;
+    }
+    const auto& mergedNode = *stlDoc.objectTree().children.back();
+    if (mergedNode.id == existingId || !mergedNode.geometry || stlDoc.findObject(mergedNode.id) != &mergedNode
+        || stlDoc.objectIdForGeometry(mergedNode.geometry) != mergedNode.id
+        || mergedNode.geometry->getStableId() == stlDoc.objectTree().children.front()->geometry->getStableId()
+        || stlDoc.importedObjectMetadata().count(mergedNode.id) != 1) {
+        std::cerr << "Merged import ids or metadata are inconsistent" << '\n';
+        return 41;
+    }
+
     Scene::Document missingDoc;
     if (missingDoc.importExternalModel((dataDir / "does_not_exist.obj").string(), Scene::Document::FileFormat::Auto)) {
         std::cerr << "Missing file import should have failed" << '\n';
@@ -361,7 +653,12 @@ int main()
 
     fs::remove(gltfPath, tempEc);
     fs::remove(binPath, tempEc);
+    fs::remove(glbPath, tempEc);
+    fs::remove(instancedPath, tempEc);
+    fs::remove(instancedBinPath, tempEc);
+    fs::remove(glbIndexPath, tempEc);
     fs::remove(binaryStlPath, tempEc);
+    fs::remove(quadStlPath, tempEc);
     fs::remove(tempDir, tempEc);
 
     return 0;
@@ -0,0 +1,113 @@
+// Reports the average cache miss ratio of GeometryKernel mesh buffers before
+// and after the vertex-cache pass, and what the optimisation and a cached
+// lookup cost. Pass an .obj file to measure a real import; without one a
+// generated grid is used. Not part of ctest; build with
+// -DFREECRAFTER_BUILD_BENCHMARKS=ON.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FileIO/Importers/ObjParser.h"
+#include "GeometryKernel/GeometryKernel.h"
+#include "GeometryKernel/HalfEdgeMesh.h"
+#include "GeometryKernel/MeshOptimizer.h"
+#include "GeometryKernel/Solid.h"
+
+namespace {
+
+std::string makeGridObj(int side)
+{
+    std::string text;
+    char line[128];
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", x * 0.01, y * 0.01, 0.001 * ((x * 7 + y * 13) % 97));
+            text += line;
+        }
+    }
+    for (int y = 0; y + 1 < side; ++y) {
+        for (int x = 0; x + 1 < side; ++x) {
+            const int a = y * side + x + 1;
+            std::snprintf(line, sizeof(line), "f %d %d %d %d\n", a, a + 1, a + side + 1, a + side);
+            text += line;
+        }
+    }
+    return text;
+}
+
+// Builds the solid the way the importer does: positions as given and faces
+// fan-triangulated in file order.
+std::unique_ptr<Solid> solidFromObj(const FileIO::Importers::ObjData& data)
+{
+    HalfEdgeMesh mesh;
+    for (const Vector3& position : data.positions)
+        mesh.addVertex(position);
+    std::vector<std::uint32_t> indices;
+    for (std::size_t f = 0; f < data.faceCount(); ++f) {
+        const std::uint32_t first = data.faceOffsets[f];
+        const std::uint32_t last = data.faceOffsets[f + 1];
+        for (std::uint32_t c = first + 1; c + 1 < last; ++c) {
+            indices.push_back(static_cast<std::uint32_t>(data.corners[first].position));
+            indices.push_back(static_cast<std::uint32_t>(data.corners[c].position));
+            indices.push_back(static_cast<std::uint32_t>(data.corners[c + 1].position));
+        }
+    }
+    mesh.addTriangles(indices);
+    return Solid::restore({}, 0.0f, std::move(mesh));
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string text;
+    if (argc > 1) {
+        std::ifstream file(argv[1], std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "cannot open %s\n", argv[1]);
+            return 1;
+        }
+        text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    } else {
+        text = makeGridObj(400);
+    }
+
+    FileIO::Importers::ObjData data;
+    if (!FileIO::Importers::parseObjBuffer(text.data(), text.size(), data)) {
+        std::fprintf(stderr, "no geometry found\n");
+        return 1;
+    }
+
+    GeometryKernel kernel;
+    GeometryObject* object = kernel.addObject(solidFromObj(data));
+    if (!object) {
+        std::fprintf(stderr, "could not build a solid\n");
+        return 1;
+    }
+
+    const GeometryKernel::MeshBuffer raw = kernel.buildMeshBuffer(*object);
+    auto start = std::chrono::steady_clock::now();
+    const auto optimized = kernel.optimizedMeshBuffer(*object);
+    const double firstMs = elapsedMs(start);
+    start = std::chrono::steady_clock::now();
+    const auto cached = kernel.optimizedMeshBuffer(*object);
+    const double cachedMs = elapsedMs(start);
+
+    const double before = MeshOptimizer::averageCacheMissRatio(raw.indices, raw.positions.size());
+    const double after = MeshOptimizer::averageCacheMissRatio(optimized->indices, optimized->positions.size());
+    std::printf("%zu vertices, %zu triangles\n", raw.positions.size(), raw.indices.size() / 3);
+    std::printf("ACMR %.3f -> %.3f (cache of %u)\n", before, after, MeshOptimizer::kDefaultCacheSize);
+    std::printf("optimise %.2f ms, cached lookup %.4f ms%s\n", firstMs, cachedMs,
+                cached == optimized ? "" : " (cache missed)");
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Measures OBJ parsing throughput at several worker counts on a generated
+// grid mesh. Not part of ctest; build with -DFREECRAFTER_BUILD_BENCHMARKS=ON.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FileIO/Importers/ObjParser.h"
+
+namespace {
+
+std::string makeGridObj(int side)
+{
+    std::string text;
+    text.reserve(static_cast<std::size_t>(side) * side * 80);
+    char line[192];
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvn 0 0 1\nvt %.5f %.5f\n", x * 0.01, y * 0.01,
+                          0.001 * ((x * 7 + y * 13) % 97), x / static_cast<double>(side), y / static_cast<double>(side));
+            text += line;
+        }
+    }
+    for (int y = 0; y + 1 < side; ++y) {
+        for (int x = 0; x + 1 < side; ++x) {
+            const int a = y * side + x + 1;
+            const int b = a + 1;
+            const int c = a + side + 1;
+            const int d = a + side;
+            std::snprintf(line, sizeof(line), "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, c, c, c, d,
+                          d, d);
+            text += line;
+        }
+    }
+    return text;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int side = argc > 1 ? std::atoi(argv[1]) : 1500;
+    const int repeats = 3;
+
+    const std::string text = makeGridObj(side);
+    const double megabytes = static_cast<double>(text.size()) / (1024.0 * 1024.0);
+    std::printf("%d x %d grid, %.1f MiB\n", side, side, megabytes);
+    std::printf("%8s %12s %12s %10s\n", "threads", "ms", "MiB/s", "speedup");
+
+    const unsigned hardware = std::thread::hardware_concurrency() == 0 ? 1u : std::thread::hardware_concurrency();
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < hardware; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(hardware);
+
+    double baseline = 0.0;
+    for (unsigned threads : threadCounts) {
+        double best = 0.0;
+        for (int r = 0; r < repeats; ++r) {
+            FileIO::Importers::ObjData obj;
+            const auto start = std::chrono::steady_clock::now();
+            const bool ok = FileIO::Importers::parseObjBuffer(text.data(), text.size(), obj, threads);
+            const auto end = std::chrono::steady_clock::now();
+            if (!ok || obj.positions.size() != static_cast<std::size_t>(side) * side) {
+                std::fprintf(stderr, "parse failed at %u threads\n", threads);
+                return 1;
+            }
+            const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            if (r == 0 || ms < best)
+                best = ms;
+        }
+        if (threads == 1)
+            baseline = best;
+        std::printf("%8u %12.2f %12.1f %9.2fx\n", threads, best, megabytes / (best / 1000.0), baseline / best);
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+// Measures OBJ and glTF export time at several worker counts on a scene of
+// many small solids. Not part of ctest; build with -DFREECRAFTER_BUILD_BENCHMARKS=ON.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "FileIO/Exporters/SceneExporter.h"
+#include "GeometryKernel/GeometryKernel.h"
+#include "GeometryKernel/Solid.h"
+#include "Scene/Document.h"
+
+namespace {
+
+std::vector<Vector3> makeCircle(float radius, int segments)
+{
+    std::vector<Vector3> points;
+    points.reserve(static_cast<std::size_t>(segments));
+    for (int i = 0; i < segments; ++i) {
+        const float angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(segments);
+        points.push_back({ radius * std::cos(angle), 0.0f, radius * std::sin(angle) });
+    }
+    return points;
+}
+
+void buildScene(Scene::Document& document, int objectCount, int segments)
+{
+    auto& kernel = document.geometry();
+    for (int i = 0; i < objectCount; ++i) {
+        auto solid = Solid::createFromProfile(makeCircle(0.4f, segments), 1.0f + 0.01f * static_cast<float>(i % 50));
+        if (!solid) {
+            continue;
+        }
+        solid->translate(Vector3(static_cast<float>(i % 100), 0.0f, static_cast<float>(i / 100)));
+        GeometryObject* object = kernel.addObject(std::move(solid));
+        kernel.assignMaterial(object, i % 2 ? "Brick" : "Glass");
+        document.ensureObjectForGeometry(object, "Column_" + std::to_string(i));
+    }
+    document.synchronizeWithGeometry();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int objectCount = argc > 1 ? std::atoi(argv[1]) : 5000;
+    const int segments = argc > 2 ? std::atoi(argv[2]) : 48;
+    const int repeats = 3;
+
+    Scene::Document document;
+    buildScene(document, objectCount, segments);
+
+    const auto directory = std::filesystem::temp_directory_path() / "freecrafter_bench_export";
+    std::filesystem::create_directories(directory);
+    std::printf("%d objects, %d segments\n", objectCount, segments);
+    std::printf("%6s %8s %12s %10s\n", "format", "threads", "ms", "speedup");
+
+    const unsigned hardware = std::thread::hardware_concurrency() == 0 ? 1u : std::thread::hardware_concurrency();
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < hardware; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(hardware);
+
+    const struct {
+        const char* name;
+        FileIO::SceneFormat format;
+        const char* file;
+    } targets[] = {
+        { "obj", FileIO::SceneFormat::OBJ, "scene.obj" },
+        { "gltf", FileIO::SceneFormat::GLTF, "scene.gltf" },
+    };
+
+    for (const auto& target : targets) {
+        const std::string path = (directory / target.file).string();
+        double baseline = 0.0;
+        for (unsigned threads : threadCounts) {
+            double best = 0.0;
+            for (int r = 0; r < repeats; ++r) {
+                std::string error;
+                const auto start = std::chrono::steady_clock::now();
+                const bool ok = FileIO::Exporters::exportScene(document, path, target.format, &error, threads);
+                const auto end = std::chrono::steady_clock::now();
+                if (!ok) {
+                    std::fprintf(stderr, "%s export failed at %u threads: %s\n", target.name, threads, error.c_str());
+                    return 1;
+                }
+                const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+                if (r == 0 || ms < best)
+                    best = ms;
+            }
+            if (threads == 1)
+                baseline = best;
+            std::printf("%6s %8u %12.2f %9.2fx\n", target.name, threads, best, baseline / best);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Measures geometry chunk decoding throughput for scene loading at several
+// worker counts. Not part of ctest; build with -DFREECRAFTER_BUILD_BENCHMARKS=ON.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GeometryKernel/GeometryKernel.h"
+#include "GeometryKernel/Serialization.h"
+#include "GeometryKernel/Vector3.h"
+
+namespace {
+
+std::vector<Vector3> makeCircle(float radius, int segments)
+{
+    std::vector<Vector3> points;
+    points.reserve(static_cast<std::size_t>(segments));
+    for (int i = 0; i < segments; ++i) {
+        const float angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(segments);
+        points.push_back({ radius * std::cos(angle), 0.0f, radius * std::sin(angle) });
+    }
+    return points;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int objectCount = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int segments = argc > 2 ? std::atoi(argv[2]) : 96;
+    const int repeats = 3;
+
+    GeometryKernel kernel;
+    for (int i = 0; i < objectCount; ++i) {
+        GeometryObject* profile = kernel.addCurve(makeCircle(1.0f + 0.001f * static_cast<float>(i), segments));
+        kernel.extrudeCurve(profile, 2.0f);
+    }
+
+    std::string buffer;
+    std::vector<GeometryIO::ChunkRange> ranges;
+    for (const auto& object : kernel.getObjects()) {
+        GeometryIO::ChunkRange range;
+        range.offset = buffer.size();
+        GeometryIO::appendObjectChunk(buffer, *object);
+        range.length = buffer.size() - range.offset;
+        ranges.push_back(range);
+    }
+
+    const double megabytes = static_cast<double>(buffer.size()) / (1024.0 * 1024.0);
+    std::printf("%zu chunks, %.1f MiB\n", ranges.size(), megabytes);
+    std::printf("%8s %12s %12s %10s\n", "threads", "ms", "MiB/s", "speedup");
+
+    const unsigned hardware = std::thread::hardware_concurrency() == 0 ? 1u : std::thread::hardware_concurrency();
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < hardware; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(hardware);
+
+    double baseline = 0.0;
+    for (unsigned threads : threadCounts) {
+        double best = 0.0;
+        for (int r = 0; r < repeats; ++r) {
+            std::vector<std::unique_ptr<GeometryObject>> objects;
+            const auto start = std::chrono::steady_clock::now();
+            const bool ok = GeometryIO::decodeObjectChunks(buffer.data(), buffer.size(), ranges, objects, threads);
+            const auto end = std::chrono::steady_clock::now();
+            if (!ok || objects.size() != ranges.size()) {
+                std::fprintf(stderr, "decode failed at %u threads\n", threads);
+                return 1;
+            }
+            const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            if (r == 0 || ms < best)
+                best = ms;
+        }
+        if (threads == 1)
+            baseline = best;
+        std::printf("%8u %12.2f %12.1f %9.2fx\n", threads, best, megabytes / (best / 1000.0), baseline / best);
+    }
+    return 0;
+}
@@ -3,6 +3,8 @@
 #include <QUndoStack>
 
 #include <cassert>
+#include <cmath>
+#include <memory>
 #include <vector>
 
 #include "CameraController.h"
@@ -12,6 +14,8 @@
 #include "Scene/Document.h"
 #include "Tools/ChamferTool.h"
 #include "Tools/LoftTool.h"
+#include "Tools/ToolCommands.h"
+#include "Tools/ToolGeometryUtils.h"
 
 namespace {
 std::vector<Vector3> makeRectangle(float width, float depth)
@@ -25,6 +29,15 @@ std::vector<Vector3> makeRectangle(float width, float depth)
         { -hw, 0.0f, hd }
     };
 }
+
+bool centeredAt(const GeometryObject& object, const Vector3& expected)
+{
+    BoundingBox box = computeBoundingBox(object);
+    if (!box.valid)
+        return false;
+    Vector3 center = (box.min + box.max) * 0.5f;
+    return std::fabs(center.x - expected.x) < 1e-3f && std::fabs(center.z - expected.z) < 1e-3f;
+}
 }
 
 int main(int argc, char** argv)
@@ -124,5 +137,33 @@ int main(int argc, char** argv)
     document.synchronizeWithGeometry();
     assert(document.geometry().getObjects().size() == initialCount + 1);
 
+    // Loft and follow-me build from where their inputs were moved to, not
+    // from the inputs' own object space.
+    const Vector3 moved(5.0f, 0.0f, 3.0f);
+    Scene::Document::ObjectId baseId = document.objectIdForGeometry(base);
+    Scene::Document::ObjectId topId = document.objectIdForGeometry(top);
+    bool baseMoved = document.translateObject(baseId, moved);
+    bool topMoved = document.translateObject(topId, moved);
+    assert(baseMoved && topMoved);
+
+    commandStack.push(std::make_unique<Tools::CreateLoftCommand>(baseId, topId, loftOptions, QStringLiteral("Loft")));
+    document.synchronizeWithGeometry();
+    assert(document.geometry().getObjects().size() == initialCount + 2);
+    assert(centeredAt(*document.geometry().getObjects().back(), moved));
+
+    Curve* path = static_cast<Curve*>(document.geometry().addCurve({ { 0.0f, 0.0f, 0.0f }, { 2.0f, 0.0f, 0.0f }, { 2.0f, 0.0f, 2.0f } }));
+    assert(path);
+    document.synchronizeWithGeometry();
+    Scene::Document::ObjectId pathId = document.objectIdForGeometry(path);
+    bool pathMoved = document.translateObject(pathId, Vector3(-4.0f, 0.0f, 1.0f));
+    assert(pathMoved);
+
+    const auto& pathLoop = path->getBoundaryLoop();
+    const Vector3 pathSpan = pathLoop.back() - pathLoop.front();
+
+    commandStack.push(std::make_unique<Tools::FollowMeCommand>(baseId, pathId, QStringLiteral("Follow Me")));
+    document.synchronizeWithGeometry();
+    assert(centeredAt(*document.geometry().getObjects().back(), moved + pathSpan));
+
     return 0;
 }
@@ -23,11 +23,19 @@ int main(int argc, char** argv)
     manager.setRetentionCount(2);
     manager.setSourcePath(QStringLiteral("/tmp/sample.fcm"));
 
+    int finishedCount = 0;
+    QObject::connect(&manager, &AutosaveManager::autosaveFinished, [&finishedCount](const QString&) { ++finishedCount; });
+
     manager.performAutosave();
+    manager.waitForPendingAutosave();
     QThread::msleep(5);
     manager.performAutosave();
+    manager.waitForPendingAutosave();
     QThread::msleep(5);
     manager.performAutosave();
+    manager.waitForPendingAutosave();
+    assert(finishedCount == 3);
+    assert(!manager.isAutosaveInProgress());
 
     const auto snapshots = manager.autosaves();
     assert(snapshots.size() == 2);
@@ -37,6 +45,7 @@ int main(int argc, char** argv)
 
     manager.setRetentionCount(3);
     manager.performAutosave();
+    manager.waitForPendingAutosave();
     assert(!manager.autosaves().empty());
 
     // Prepare a document with geometry and create an autosave
@@ -50,9 +59,11 @@ int main(int argc, char** argv)
     restoreManager.setIntervalMinutes(0);
     restoreManager.setSourcePath(QStringLiteral("/tmp/restore.fcm"));
     restoreManager.performAutosave();
-
-    assert(!restoreSource.geometry().getObjects().empty());
+    // The snapshot is taken up front, so clearing the document while the
+    // write is in flight must not affect the autosave.
     restoreSource.reset();
+    restoreManager.waitForPendingAutosave();
+
     assert(restoreSource.geometry().getObjects().empty());
 
     const bool restored = restoreManager.restoreLatest(&restoreSource);
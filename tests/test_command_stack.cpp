@@ -15,6 +15,32 @@
 #include "Tools/ToolCommands.h"
 #include "Tools/ToolGeometryUtils.h"
 
+namespace {
+
+// Packs its state but can never restore it, like an entry whose spill file
+// has been damaged.
+class UnrestorableCommand : public Core::Command {
+public:
+    UnrestorableCommand()
+        : Core::Command(QStringLiteral("Unrestorable"))
+    {
+    }
+
+    int undoCount = 0;
+
+protected:
+    bool packState(std::string& out) override
+    {
+        out = "state";
+        return true;
+    }
+    bool unpackState(const std::string&) override { return false; }
+    void performRedo() override {}
+    void performUndo() override { ++undoCount; }
+};
+
+} // namespace
+
 int main(int argc, char** argv)
 {
     qputenv("QT_QPA_PLATFORM", QByteArray("offscreen"));
@@ -146,6 +172,101 @@ int main(int argc, char** argv)
     currentColor = document.tags().at(createdTag).color;
     assert(std::fabs(currentColor.r - newColor.r) < 1e-5f);
 
+    // Transactions: a drag that pushes a move per step leaves one undo entry
+    // and notifies once, on commit.
+    int geometryNotifications = 0;
+    context.geometryChanged = [&]() {
+        ++geometryNotifications;
+        document.synchronizeWithGeometry();
+    };
+    commandStack.setContext(context);
+    GeometryObject* dragged = document.geometry().getObjects().front().get();
+    Scene::Document::ObjectId draggedId = document.objectIdForGeometry(dragged);
+    const BoundingBox beforeDrag = computeBoundingBox(*dragged);
+    const int entriesBeforeDrag = undoStack.count();
+    commandStack.beginTransaction(QStringLiteral("Move"));
+    for (int step = 0; step < 5; ++step)
+        commandStack.push(std::make_unique<Tools::TranslateObjectsCommand>(std::vector<Scene::Document::ObjectId> { draggedId }, Vector3(0.0f, 0.5f, 0.0f), QStringLiteral("Move")));
+    assert(commandStack.inTransaction());
+    assert(geometryNotifications == 0);
+    commandStack.commitTransaction();
+    assert(!commandStack.inTransaction());
+    assert(geometryNotifications == 1);
+    assert(undoStack.count() == entriesBeforeDrag + 1);
+    assert(undoStack.command(undoStack.count() - 1)->childCount() == 1);
+    assert(std::fabs(computeBoundingBox(*dragged).min.y - (beforeDrag.min.y + 2.5f)) < 1e-4f);
+    undoStack.undo();
+    assert(std::fabs(computeBoundingBox(*dragged).min.y - beforeDrag.min.y) < 1e-4f);
+    undoStack.redo();
+    assert(std::fabs(computeBoundingBox(*dragged).min.y - (beforeDrag.min.y + 2.5f)) < 1e-4f);
+
+    // Merge keys: repeated edits of one field fold into one entry; a
+    // different key starts a new one.
+    // push() only hands back the commands that were not merged away.
+    const int entriesBeforeScrub = undoStack.count();
+    for (int step = 0; step < 3; ++step) {
+        Core::Command* pushed = commandStack.push(std::make_unique<Tools::TranslateObjectsCommand>(std::vector<Scene::Document::ObjectId> { draggedId }, Vector3(0.0f, 0.0f, 1.0f), QStringLiteral("Move")), 42);
+        assert((pushed != nullptr) == (step == 0));
+    }
+    assert(undoStack.count() == entriesBeforeScrub + 1);
+    commandStack.push(std::make_unique<Tools::TranslateObjectsCommand>(std::vector<Scene::Document::ObjectId> { draggedId }, Vector3(0.0f, 0.0f, 1.0f), QStringLiteral("Move")), 43);
+    assert(undoStack.count() == entriesBeforeScrub + 2);
+    undoStack.undo();
+    undoStack.undo();
+    assert(std::fabs(computeBoundingBox(*dragged).min.z - beforeDrag.min.z) < 1e-4f);
+    undoStack.redo();
+    undoStack.redo();
+    assert(std::fabs(computeBoundingBox(*dragged).min.z - (beforeDrag.min.z + 4.0f)) < 1e-4f);
+
+    // Separately committed edits, as the inspector pushes them, carry no key
+    // and stay separate steps, so undo goes back to the first value.
+    const int entriesBeforeEdits = undoStack.count();
+    for (int edit = 0; edit < 2; ++edit)
+        commandStack.push(std::make_unique<Tools::TranslateObjectsCommand>(std::vector<Scene::Document::ObjectId> { draggedId }, Vector3(0.0f, 0.0f, 1.0f), QStringLiteral("Move Selection")));
+    assert(undoStack.count() == entriesBeforeEdits + 2);
+    undoStack.undo();
+    assert(std::fabs(computeBoundingBox(*dragged).min.z - (beforeDrag.min.z + 5.0f)) < 1e-4f);
+    undoStack.redo();
+
+    // History budget: with nothing allowed to stay resident, the delete's
+    // prototype is written to the spill file and read back on undo.
+    const std::size_t objectsBeforeBudget = document.geometry().getObjects().size();
+    Scene::Document::ObjectId budgetId = document.objectIdForGeometry(restored);
+    commandStack.push(std::make_unique<Tools::DeleteObjectsCommand>(std::vector<Scene::Document::ObjectId> { budgetId }, QStringLiteral("Delete Selection")));
+    assert(document.geometry().getObjects().size() == objectsBeforeBudget - 1);
+    const std::size_t residentBeforeBudget = commandStack.residentHistoryBytes();
+
+    Core::CommandStack::HistoryBudget budget;
+    budget.residentSteps = 0;
+    budget.maxResidentBytes = 0;
+    commandStack.setHistoryBudget(budget);
+    auto* spilled = static_cast<const Core::Command*>(undoStack.command(undoStack.index() - 1));
+    assert(spilled->storage() == Core::Command::Storage::Spilled);
+    assert(commandStack.residentHistoryBytes() < residentBeforeBudget);
+
+    undoStack.undo();
+    assert(document.geometry().getObjects().size() == objectsBeforeBudget);
+    assert(spilled->storage() != Core::Command::Storage::Resident);
+    BoundingBox afterSpilledUndo = computeBoundingBox(*document.geometry().getObjects().back());
+    assert(afterSpilledUndo.valid);
+    assert(std::fabs(afterSpilledUndo.min.x - redoBounds.min.x) < 1e-4f);
+    undoStack.redo();
+    assert(document.geometry().getObjects().size() == objectsBeforeBudget - 1);
+
+    // An entry that cannot be restored keeps its stored state, is not run,
+    // and invalidates the whole history once the undo call has returned.
+    int invalidations = 0;
+    context.historyInvalidated = [&]() { ++invalidations; };
+    commandStack.setContext(context);
+    auto* unrestorable = static_cast<UnrestorableCommand*>(commandStack.push(std::make_unique<UnrestorableCommand>()));
+    assert(unrestorable->storage() != Core::Command::Storage::Resident);
+    undoStack.undo();
+    assert(invalidations == 1);
+    assert(unrestorable->undoCount == 0);
+    assert(unrestorable->storage() != Core::Command::Storage::Resident);
+    QCoreApplication::processEvents();
+    assert(undoStack.count() == 0);
+
     return 0;
 }
 
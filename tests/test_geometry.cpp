@@ -1,5 +1,6 @@
 #include <cassert>
 #include <cmath>
+#include <memory>
 #include <vector>
 
 #include "GeometryKernel.h"
@@ -123,6 +124,22 @@ int main() {
     assert(afterCloneRemovalMaterials.count(clonedId) == 0);
     assert(!kernel.hasShapeMetadata(clonedId));
 
+    // Clones share mesh storage with the original until one of them changes.
+    GeometryObject* original = kernel.addCurve({ { 0.0f, 0.0f, 0.0f }, { 2.0f, 0.0f, 0.0f },
+                                                 { 2.0f, 0.0f, 2.0f }, { 0.0f, 0.0f, 2.0f } });
+    assert(original);
+    std::unique_ptr<GeometryObject> snapshot = original->clone();
+    const HalfEdgeMesh& originalMesh = static_cast<const GeometryObject&>(*original).getMesh();
+    const HalfEdgeMesh& snapshotMesh = static_cast<const GeometryObject&>(*snapshot).getMesh();
+    assert(originalMesh.sharesStorageWith(snapshotMesh));
+    const std::size_t sharedBytes = snapshotMesh.memoryFootprint();
+    assert(sharedBytes > 0 && originalMesh.memoryFootprint() == sharedBytes);
+    static_cast<Curve*>(original)->translate(Vector3(1.0f, 0.0f, 0.0f));
+    assert(!originalMesh.sharesStorageWith(snapshotMesh));
+    assert(std::fabs(originalMesh.getVertices()[0].position.x - snapshotMesh.getVertices()[0].position.x - 1.0f) < 1e-6f);
+    assert(snapshotMesh.memoryFootprint() >= 2 * sharedBytes);
+    kernel.deleteObject(original);
+
     assert(kernel.getObjects().size() == 1);
     assert(kernel.getObjects()[0].get() == solidObj);
     kernel.deleteObject(solidObj);
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <cmath>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
@@ -7,8 +8,11 @@
 #include "CameraController.h"
 #include "GeometryKernel/Curve.h"
 #include "GeometryKernel/GeometryKernel.h"
+#include "GeometryKernel/Solid.h"
+#include "GeometryKernel/TransformUtils.h"
 #include "GeometryKernel/Vector3.h"
 #include "Scene/Document.h"
+#include "Scene/SceneSerializer.h"
 
 using Scene::Document;
 
@@ -54,6 +58,143 @@ void testGroupingAndOutliner()
     assert(foundA);
 }
 
+void testBatchedRemoval()
+{
+    Document doc;
+    std::vector<Document::ObjectId> ids;
+    std::vector<GeometryObject*> objects;
+    for (int i = 0; i < 6; ++i) {
+        objects.push_back(doc.geometry().addCurve(makeRectangle(1.0f + i, 1.0f)));
+        doc.geometry().assignMaterial(objects.back(), "Brick");
+        ids.push_back(doc.ensureObjectForGeometry(objects.back(), "Item"));
+    }
+    Document::ObjectId groupId = doc.createGroup({ ids[4], ids[5] }, "Group");
+    assert(groupId != 0);
+
+    // A group and one of its children in the same batch, plus unknown ids.
+    bool removed = doc.removeObjects({ ids[1], groupId, ids[3], ids[5], 9999 });
+    assert(removed);
+    bool removedAgain = doc.removeObjects({ ids[1], 9999 });
+    assert(!removedAgain);
+
+    const auto& kernelObjects = doc.geometry().getObjects();
+    assert(kernelObjects.size() == 2);
+    assert(kernelObjects[0].get() == objects[0]);
+    assert(kernelObjects[1].get() == objects[2]);
+    assert(doc.geometry().getMaterials().size() == 2);
+    assert(doc.geometry().findObject(objects[2]->getStableId()) == objects[2]);
+    assert(doc.objectTree().children.size() == 2);
+    for (Document::ObjectId id : { ids[1], ids[3], ids[4], ids[5], groupId })
+        assert(!doc.findObject(id));
+    assert(doc.objectIdForGeometry(objects[2]) == ids[2]);
+
+    // A pointer listed twice is deleted once and null is ignored.
+    GeometryKernel kernel;
+    GeometryObject* first = kernel.addCurve(makeRectangle(1.0f, 1.0f));
+    GeometryObject* second = kernel.addCurve(makeRectangle(2.0f, 1.0f));
+    kernel.deleteObjects({ first, nullptr, first });
+    assert(kernel.getObjects().size() == 1);
+    assert(kernel.getObjects()[0].get() == second);
+    assert(kernel.findObject(second->getStableId()) == second);
+}
+
+void testSelectionSet()
+{
+    Document doc;
+    std::vector<Document::ObjectId> ids;
+    std::vector<GeometryObject*> objects;
+    for (int i = 0; i < 4; ++i) {
+        objects.push_back(doc.geometry().addCurve(makeRectangle(1.0f + i, 1.0f)));
+        ids.push_back(doc.ensureObjectForGeometry(objects.back(), "Item"));
+    }
+    int notifications = 0;
+    const auto listener = doc.addSelectionListener([&notifications]() { ++notifications; });
+
+    doc.setSelection({ ids[2], ids[0] });
+    assert(notifications == 1);
+    assert((doc.selection().ids() == std::vector<Document::ObjectId> { ids[2], ids[0] }));
+    assert(objects[0]->isSelected() && objects[2]->isSelected() && !objects[1]->isSelected());
+    const auto revision = doc.selection().revision();
+    doc.setSelection({ ids[0], ids[2] });
+    assert(notifications == 1 && doc.selection().revision() == revision);
+
+    // Flags set on registered geometry reach the set and vice versa.
+    objects[1]->setSelected(true);
+    assert(doc.selection().contains(ids[1]) && notifications == 2);
+    bool deselected = doc.setObjectSelected(ids[2], false);
+    assert(deselected);
+    assert(!objects[2]->isSelected() && doc.selection().size() == 2);
+    assert((doc.selectedGeometry() == std::vector<GeometryObject*> { objects[0], objects[1] }));
+
+    // Removed objects leave the selection with one notification.
+    doc.removeObjects({ ids[0], ids[1] });
+    assert(doc.selection().empty() && notifications == 4);
+
+    // A clone's copied flag does not select it until the document says so.
+    objects[3]->setSelected(true);
+    GeometryObject* copy = doc.geometry().addObject(objects[3]->clone());
+    Document::ObjectId copyId = doc.ensureObjectForGeometry(copy, "Copy");
+    assert(!copy->isSelected() && !doc.selection().contains(copyId));
+
+    doc.removeSelectionListener(listener);
+    doc.clearSelection();
+    assert(doc.selection().empty() && !objects[3]->isSelected() && notifications == 5);
+}
+
+bool nearlyEqual(const Vector3& a, const Vector3& b)
+{
+    return (a - b).lengthSquared() < 1e-8f;
+}
+
+void testNodeTransforms()
+{
+    Document doc;
+    GeometryObject* a = doc.geometry().addCurve(makeRectangle(2.0f, 2.0f));
+    GeometryObject* b = doc.geometry().addCurve(makeRectangle(1.0f, 1.0f));
+    Document::ObjectId idA = doc.ensureObjectForGeometry(a, "A");
+    Document::ObjectId idB = doc.ensureObjectForGeometry(b, "B");
+    const Vector3 corner = a->getMesh().getVertices().front().position;
+    const Vector3 centre = doc.objectTransform(idA).position;
+    assert(!a->isPlaced());
+
+    // Moving a group changes its children's placements, not their vertices.
+    Document::ObjectId groupId = doc.createGroup({ idA, idB }, "Group");
+    const std::uint64_t revision = a->contentRevision();
+    bool translated = doc.translateObject(groupId, Vector3(5.0f, 0.0f, 0.0f));
+    assert(translated);
+    assert(a->contentRevision() == revision);
+    assert(nearlyEqual(a->getMesh().getVertices().front().position, corner));
+    assert(a->isPlaced() && b->isPlaced());
+    assert(nearlyEqual(GeometryTransforms::transformPoint(a->placement(), corner), corner + Vector3(5.0f, 0.0f, 0.0f)));
+    assert(nearlyEqual(doc.objectTransform(idA).position, centre + Vector3(5.0f, 0.0f, 0.0f)));
+
+    // Rotation and scale turn about the geometry centre.
+    Document::Transform edit;
+    edit.rotation = Vector3(0.0f, 90.0f, 0.0f);
+    edit.scale = Vector3(2.0f, 2.0f, 2.0f);
+    Document::TransformMask mask;
+    mask.rotation[1] = true;
+    mask.scale = { { true, true, true } };
+    bool applied = doc.applyTransform(idA, edit, mask);
+    assert(applied);
+    const Document::Transform edited = doc.objectTransform(idA);
+    assert(nearlyEqual(edited.position, centre + Vector3(5.0f, 0.0f, 0.0f)));
+    assert(nearlyEqual(edited.rotation, edit.rotation) && nearlyEqual(edited.scale, edit.scale));
+    const Vector3 offset = corner - centre;
+    const Vector3 expected = centre + Vector3(5.0f, 0.0f, 0.0f) + Vector3(offset.z, offset.y, -offset.x) * 2.0f;
+    assert(nearlyEqual(GeometryTransforms::transformPoint(a->placement(), corner), expected));
+    bool reapplied = doc.applyTransform(idA, edit, mask);
+    assert(!reapplied);
+
+    // Reparenting keeps objects where they are in the world.
+    const GeometryTransforms::Matrix4 placed = a->placement();
+    bool moved = doc.moveObject(idA, 0, 0);
+    assert(moved);
+    for (std::size_t i = 0; i < placed.size(); ++i)
+        assert(std::fabs(a->placement()[i] - placed[i]) < 1e-4f);
+    assert(nearlyEqual(doc.findObject(idA)->transform.position, Vector3(placed[12], placed[13], placed[14])));
+}
+
 void testOpenPolylineCreation()
 {
     GeometryKernel kernel;
@@ -93,6 +234,21 @@ void testComponents()
     const GeometryObject* instGeom = instanceNode->children.front()->geometry;
     assert(original != instGeom);
 
+    // Pushing an edited instance into the definition updates the other
+    // instance in place: same objects, sharing the edited mesh.
+    Document::ObjectId secondId = doc.instantiateComponent(defId, "PanelInstance2");
+    const GeometryObject* secondGeom = doc.findObject(secondId)->children.front()->children.front()->geometry;
+    auto* edited = static_cast<Curve*>(doc.findObject(instId)->children.front()->children.front()->geometry);
+    bool rebuilt = edited->rebuildFromPoints(makeRectangle(3.0f, 3.0f));
+    assert(rebuilt);
+    std::size_t objectCount = doc.geometry().getObjects().size();
+    bool updated = doc.updateComponentDefinition(instId);
+    assert(updated);
+    assert(doc.geometry().getObjects().size() == objectCount);
+    assert(doc.findObject(secondId)->children.front()->children.front()->geometry == secondGeom);
+    const Curve& editedCurve = *edited;
+    assert(secondGeom->getMesh().sharesStorageWith(editedCurve.getMesh()));
+
     bool unique = doc.makeComponentUnique(instId);
     assert(unique);
     const auto* updatedInstance = doc.findObject(instId);
@@ -115,6 +271,45 @@ void testTagsAndVisibility()
     assert(a->isHidden());
     doc.setTagVisible(tagId, true);
     assert(!a->isHidden());
+
+    // Showing a tag does not override a hidden parent or isolation.
+    GeometryObject* b = doc.geometry().addCurve(makeRectangle(1.0f, 2.0f));
+    Document::ObjectId idB = doc.ensureObjectForGeometry(b, "Other");
+    Document::ObjectId groupId = doc.createGroup({ idA }, "Hidden");
+    doc.setTagVisible(tagId, false);
+    doc.setObjectVisible(groupId, false);
+    doc.setTagVisible(tagId, true);
+    assert(a->isHidden());
+    doc.setObjectVisible(groupId, true);
+    assert(!a->isHidden());
+    doc.assignTag(idB, tagId);
+    doc.isolate(idA);
+    doc.setTagVisible(tagId, false);
+    doc.setTagVisible(tagId, true);
+    assert(!a->isHidden());
+    assert(b->isHidden());
+    doc.clearIsolation();
+    doc.setTagVisible(tagId, false);
+    assert(b->isHidden());
+    bool deleted = doc.deleteTag(tagId);
+    assert(deleted);
+    assert(!a->isHidden());
+    assert(!b->isHidden());
+    assert(doc.taggedObjects(tagId).empty());
+
+    Document::TagId bulkTag = doc.createTag("Bulk", color);
+    bool bulkAssigned = doc.assignTagToObjects({ idA, idB }, bulkTag);
+    assert(bulkAssigned);
+    assert(doc.taggedObjects(bulkTag).size() == 2);
+    doc.setTagVisible(bulkTag, false);
+    assert(a->isHidden() && b->isHidden());
+    bool bulkRemoved = doc.removeTagFromObjects({ idA }, bulkTag);
+    assert(bulkRemoved);
+    assert(!doc.hasTag(idA, bulkTag) && doc.hasTag(idB, bulkTag));
+    assert(!a->isHidden() && b->isHidden());
+    bool removedAgain = doc.removeTagFromObjects({ idA }, bulkTag);
+    assert(!removedAgain);
+
     doc.setColorByTag(true);
     assert(doc.colorByTag());
 }
@@ -146,6 +341,17 @@ void testIsolation()
     doc.clearIsolation();
     assert(!a->isHidden());
     assert(!b->isHidden());
+
+    // Removing the isolated object ends the isolation in effect, so the rest
+    // of the scene and objects added later are shown.
+    doc.isolate(idA);
+    assert(b->isHidden());
+    bool removed = doc.removeObjects({ idA });
+    assert(removed);
+    assert(!b->isHidden());
+    GeometryObject* c = doc.geometry().addCurve(makeRectangle(2.0f, 2.0f));
+    doc.ensureObjectForGeometry(c, "IsoC");
+    assert(!c->isHidden());
 }
 
 void testScenes()
@@ -202,6 +408,10 @@ void testSerializationRoundTrip()
     Document::TagId tagId = doc.createTag("Persist", { 0.1f, 0.2f, 0.3f, 1.0f });
     doc.assignTag(idA, tagId);
     doc.setTagVisible(tagId, false);
+    Document::Transform placement;
+    placement.position = Vector3(1.0f, 2.0f, 3.0f);
+    placement.rotation = Vector3(0.0f, 45.0f, 0.0f);
+    doc.setLocalTransform(idA, placement);
 
     CameraController camera;
     Document::SceneId sceneId = doc.createScene("Snapshot", camera);
@@ -228,6 +438,164 @@ void testSerializationRoundTrip()
     assert(loaded.scenes().size() == doc.scenes().size());
     assert(!loaded.colorByTag());
     assert(!loaded.objectTree().children.empty());
+    const auto* loadedA = loaded.findObject(idA);
+    assert(loadedA && nearlyEqual(loadedA->transform.position, placement.position));
+    assert(nearlyEqual(loadedA->transform.rotation, placement.rotation));
+    assert(loadedA->geometry && loadedA->geometry->isPlaced());
+}
+
+void testChunkedGeometryRoundTrip()
+{
+    Document doc;
+    GeometryObject* profile = doc.geometry().addCurve(makeRectangle(2.0f, 2.0f));
+    GeometryObject* solid = doc.geometry().extrudeCurve(profile, 1.5f);
+    assert(solid);
+    doc.ensureObjectForGeometry(solid, "Block");
+
+    // Move a vertex so the mesh no longer matches what the profile would rebuild.
+    auto& vertices = solid->getMesh().getVertices();
+    assert(!vertices.empty());
+    vertices.front().position.y += 0.25f;
+    const Vector3 moved = vertices.front().position;
+    const std::size_t vertexCount = vertices.size();
+    const std::size_t faceCount = solid->getMesh().getFaces().size();
+    const GeometryObject::StableId solidId = solid->getStableId();
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "phase5_chunked.fcm";
+    bool saved = doc.saveToFile(path.string());
+    assert(saved);
+
+    Document loaded;
+    bool loadedOk = loaded.loadFromFile(path.string());
+    std::filesystem::remove(path);
+    assert(loadedOk);
+
+    const GeometryObject* restored = nullptr;
+    for (const auto& object : loaded.geometry().getObjects()) {
+        if (object->getType() == ObjectType::Solid)
+            restored = object.get();
+    }
+    assert(restored);
+    assert(restored->getStableId() == solidId);
+    const auto& restoredVertices = restored->getMesh().getVertices();
+    assert(restoredVertices.size() == vertexCount);
+    assert(restored->getMesh().getFaces().size() == faceCount);
+    assert(restoredVertices.front().position.y == moved.y);
+    assert(loaded.geometry().getObjects().size() == doc.geometry().getObjects().size());
+}
+
+void testCompressedSceneRoundTrip()
+{
+    Document doc;
+    for (int i = 0; i < 8; ++i) {
+        GeometryObject* profile = doc.geometry().addCurve(makeRectangle(1.0f + i, 2.0f));
+        GeometryObject* solid = doc.geometry().extrudeCurve(profile, 1.0f);
+        doc.ensureObjectForGeometry(solid, "Block");
+    }
+
+    const auto tempDir = std::filesystem::temp_directory_path();
+    const std::filesystem::path rawPath = tempDir / "phase5_raw.fcm";
+    const std::filesystem::path packedPath = tempDir / "phase5_packed.fcm";
+    Scene::SceneSerializer::SaveOptions options;
+    options.compress = true;
+    bool savedRaw = doc.saveToFile(rawPath.string());
+    assert(savedRaw);
+    bool savedPacked = doc.saveToFile(packedPath.string(), options);
+    assert(savedPacked);
+    // A second save copies the compressed chunks out of the previous file and
+    // must produce the same size.
+    const auto firstSize = std::filesystem::file_size(packedPath);
+    bool resaved = doc.saveToFile(packedPath.string(), options);
+    assert(resaved);
+    assert(std::filesystem::file_size(packedPath) == firstSize);
+    assert(firstSize < std::filesystem::file_size(rawPath));
+
+    Document loaded;
+    bool loadedOk = loaded.loadFromFile(packedPath.string());
+    std::filesystem::remove(rawPath);
+    std::filesystem::remove(packedPath);
+    assert(loadedOk);
+    const auto& original = doc.geometry().getObjects();
+    const auto& restored = loaded.geometry().getObjects();
+    assert(restored.size() == original.size());
+    for (std::size_t i = 0; i < original.size(); ++i) {
+        assert(restored[i]->getStableId() == original[i]->getStableId());
+        assert(restored[i]->getMesh().getVertices().size() == original[i]->getMesh().getVertices().size());
+    }
+}
+
+void testIncrementalSave()
+{
+    Document doc;
+    std::vector<Solid*> solids;
+    for (int i = 0; i < 6; ++i) {
+        GeometryObject* profile = doc.geometry().addCurve(makeRectangle(1.0f + i, 1.0f));
+        auto* solid = static_cast<Solid*>(doc.geometry().extrudeCurve(profile, 2.0f));
+        doc.ensureObjectForGeometry(solid, "Block");
+        solids.push_back(solid);
+    }
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "phase5_incremental.fcm";
+    Scene::SceneSerializer::SaveOptions options;
+    options.incremental = true;
+    bool saved = doc.saveToFile(path.string(), options);
+    assert(saved);
+    const auto fullSize = std::filesystem::file_size(path);
+
+    // Only the moved solid is appended, so the file grows by far less than a
+    // full copy.
+    solids[2]->translate({ 0.0f, 5.0f, 0.0f });
+    const Vector3 moved = solids[2]->getMesh().getVertices().front().position;
+    bool appended = doc.saveToFile(path.string(), options);
+    assert(appended);
+    const auto appendedSize = std::filesystem::file_size(path);
+    assert(appendedSize > fullSize);
+    assert(appendedSize - fullSize < fullSize / 2);
+
+    Document loaded;
+    bool loadedAppended = loaded.loadFromFile(path.string());
+    assert(loadedAppended);
+    const auto& restored = loaded.geometry().getObjects();
+    assert(restored.size() == doc.geometry().getObjects().size());
+    const GeometryObject* restoredSolid = nullptr;
+    for (const auto& object : restored) {
+        if (object->getStableId() == solids[2]->getStableId())
+            restoredSolid = object.get();
+    }
+    assert(restoredSolid);
+    assert(restoredSolid->getMesh().getVertices().front().position.y == moved.y);
+
+    // Rewriting everything repeatedly triggers compaction instead of growing
+    // the file without bound.
+    for (int pass = 0; pass < 8; ++pass) {
+        for (Solid* solid : solids)
+            solid->translate({ 0.1f, 0.0f, 0.0f });
+        bool rewritten = doc.saveToFile(path.string(), options);
+        assert(rewritten);
+    }
+    assert(std::filesystem::file_size(path) < fullSize * 3);
+
+    Document compacted;
+    bool loadedOk = compacted.loadFromFile(path.string());
+    std::filesystem::remove(path);
+    assert(loadedOk);
+    assert(compacted.geometry().getObjects().size() == doc.geometry().getObjects().size());
+
+    // Level 0 never shrinks a chunk, so every chunk is stored raw; unchanged
+    // ones must still be reused instead of appended again on every save.
+    const std::filesystem::path storedPath = std::filesystem::temp_directory_path() / "phase5_incremental_stored.fcm";
+    options.compress = true;
+    options.compressionLevel = 0;
+    bool storedSaved = doc.saveToFile(storedPath.string(), options);
+    assert(storedSaved);
+    const auto storedSize = std::filesystem::file_size(storedPath);
+    for (int pass = 0; pass < 3; ++pass) {
+        bool resaved = doc.saveToFile(storedPath.string(), options);
+        assert(resaved);
+    }
+    const auto grown = std::filesystem::file_size(storedPath) - storedSize;
+    std::filesystem::remove(storedPath);
+    assert(grown < storedSize / 2);
 }
 
 void testLegacySceneUpgrade()
@@ -259,12 +627,18 @@ int main()
 {
     testOpenPolylineCreation();
     testGroupingAndOutliner();
+    testBatchedRemoval();
+    testSelectionSet();
+    testNodeTransforms();
     testComponents();
     testTagsAndVisibility();
     testMaterialAssignments();
     testIsolation();
     testScenes();
     testSerializationRoundTrip();
+    testChunkedGeometryRoundTrip();
+    testCompressedSceneRoundTrip();
+    testIncrementalSave();
     testLegacySceneUpgrade();
     return 0;
 }